@@ -0,0 +1,504 @@
+#include "raylib.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "autosave.h"
+#include "journal.h"
+#include "trace.h"
+
+typedef enum {
+    AUTOSAVE_IDLE,
+    AUTOSAVE_COPYING,   // main thread: pool and edges frozen, untouched chunks still being copied
+    AUTOSAVE_WRITING,   // worker thread owns the snapshot
+    AUTOSAVE_DONE       // worker finished, main thread releases the snapshot
+} AutosaveState;
+
+struct Autosave {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        // main -> worker: snapshot ready or quit
+    pthread_cond_t finished;    // worker -> main: snapshot written
+    AutosaveState state;        // guarded by lock
+    bool quit;
+    bool writeOk;
+
+    // Snapshot, views over the frozen chunk copies
+    NodePool pool;
+    EdgeStore edges;
+    SceneList scenes;
+    Camera2D camera;
+    uint32_t lastSaveKey;
+    int nextChunk;              // next chunk the incremental copy looks at, node chunks then edge chunks
+
+    // Compaction: the snapshot in flight replaces the project file, not the autosave
+    bool compacting;
+    uint32_t journalSeq;        // last journal batch the snapshot contains
+    ProjectStats written;
+
+    // Texts deleted while the snapshot may still point at them
+    char **deferred;
+    int deferredCount;
+    int deferredCapacity;
+
+    // Scheduling
+    unsigned int savedFingerprint;
+    bool retry;                 // last write failed, save again even if nothing changed
+    bool armed;                 // unsaved edits, counted in context->pendingJobs
+    double dirtySince;
+
+    char path[260];
+    char tmpPath[268];
+    char compactPath[260];
+    char compactTmpPath[268];
+    AutosaveStats stats;
+};
+
+// Cheap "did anything change" check: node edits bump the pool revision, scenes are few enough to hash
+static unsigned int Autosave_Fingerprint(const Context *context) {
+    unsigned int hash = 2166136261u ^ context->pool->revision;
+    const SceneList *list = &context->sceneList;
+
+    const unsigned char *bytes = (const unsigned char *)&list->count;
+    for (size_t b = 0; b < sizeof(list->count); b++) hash = (hash ^ bytes[b]) * 16777619u;
+
+    for (int s = 0; s < list->count; s++) {
+        const SceneOutline *scene = &list->scenes[s];
+        bytes = (const unsigned char *)&scene->bounds;
+        for (size_t b = 0; b < sizeof(scene->bounds); b++) hash = (hash ^ bytes[b]) * 16777619u;
+        hash = (hash ^ (unsigned int)scene->nodeCount) * 16777619u;
+    }
+    return hash;
+}
+
+static AutosaveState Autosave_GetState(Autosave *autosave) {
+    pthread_mutex_lock(&autosave->lock);
+    AutosaveState state = autosave->state;
+    pthread_mutex_unlock(&autosave->lock);
+    return state;
+}
+
+static void Autosave_SetState(Autosave *autosave, AutosaveState state) {
+    pthread_mutex_lock(&autosave->lock);
+    autosave->state = state;
+    pthread_cond_broadcast(&autosave->wake);
+    pthread_mutex_unlock(&autosave->lock);
+}
+
+static void Autosave_Disarm(Context *context) {
+    if (!context->autosave->armed) return;
+    context->autosave->armed = false;
+    context->pendingJobs--;
+}
+
+// WORKER
+static int CompareZKey(const void *a, const void *b) {
+    long long za = (*(Node *const *)a)->zKey;
+    long long zb = (*(Node *const *)b)->zKey;
+    return (za > zb) - (za < zb);
+}
+
+// Runs on the worker, reads nothing but the snapshot
+static bool Autosave_WriteSnapshot(Autosave *autosave) {
+    int slotCount = NodePool_SlotCount(&autosave->pool);
+    Node **order = malloc((slotCount + 1) * sizeof(Node *));
+    if (!order) return false;
+
+    // the z-list pointers are live data, the frozen z-keys give the same order
+    TRACE_BEGIN(TRACE_TRACK_AUTOSAVE, "z-order");
+    uint32_t nodeCount = 0;
+    for (int i = 0; i < slotCount; i++) {
+        Node *node = NodePool_At(&autosave->pool, i);
+        if (node->type != NODE_COUNT) order[nodeCount++] = node;
+    }
+    qsort(order, nodeCount, sizeof(Node *), CompareZKey);
+    TRACE_END(TRACE_TRACK_AUTOSAVE, "z-order");
+
+    ProjectSource source = {
+        .pool = &autosave->pool,
+        .nodes = order,
+        .nodeCount = nodeCount,
+        .edges = &autosave->edges,
+        .scenes = &autosave->scenes,
+        .camera = autosave->camera,
+        .journalSeq = autosave->compacting ? autosave->journalSeq : 0,
+        .lastSaveKey = autosave->lastSaveKey
+    };
+    const char *path = autosave->compacting ? autosave->compactPath : autosave->path;
+    const char *tmpPath = autosave->compacting ? autosave->compactTmpPath : autosave->tmpPath;
+    TRACE_BEGIN(TRACE_TRACK_AUTOSAVE, "Project_WriteFile");
+    bool ok = Project_WriteFile(&source, tmpPath, true, &autosave->written);
+    TRACE_END(TRACE_TRACK_AUTOSAVE, "Project_WriteFile");
+    if (ok) {
+        TRACE_BEGIN(TRACE_TRACK_AUTOSAVE, "File_Replace");
+        ok = File_Replace(tmpPath, path);
+        TRACE_END(TRACE_TRACK_AUTOSAVE, "File_Replace");
+    }
+    free(order);
+    return ok;
+}
+
+// Writes the snapshot and hands it back to the main thread: on the worker, or inline in a replay
+static void Autosave_Write(Autosave *autosave) {
+    double start = Clock_Seconds();
+    TRACE_BEGIN(TRACE_TRACK_AUTOSAVE, "Autosave_WriteSnapshot");
+    bool ok = Autosave_WriteSnapshot(autosave);
+    TRACE_END(TRACE_TRACK_AUTOSAVE, "Autosave_WriteSnapshot");
+    double elapsed = Clock_Seconds() - start;
+
+    pthread_mutex_lock(&autosave->lock);
+    autosave->writeOk = ok;
+    autosave->stats.writeMillis = elapsed * 1000.0;
+    autosave->state = AUTOSAVE_DONE;
+    pthread_cond_broadcast(&autosave->finished);
+    pthread_mutex_unlock(&autosave->lock);
+}
+
+static void *Autosave_Worker(void *arg) {
+    Autosave *autosave = arg;
+
+    pthread_mutex_lock(&autosave->lock);
+    for (;;) {
+        while (!autosave->quit && autosave->state != AUTOSAVE_WRITING) {
+            pthread_cond_wait(&autosave->wake, &autosave->lock);
+        }
+        if (autosave->quit) break;
+        pthread_mutex_unlock(&autosave->lock);
+        Autosave_Write(autosave);
+        pthread_mutex_lock(&autosave->lock);
+    }
+    pthread_mutex_unlock(&autosave->lock);
+    return NULL;
+}
+
+// SNAPSHOT (main thread)
+static void Autosave_FreeChunks(void **chunks, int count) {
+    if (!chunks) return;
+    for (int i = 0; i < count; i++) free(chunks[i]);
+    free(chunks);
+}
+
+static void Autosave_FreeScenes(SceneList *scenes) {
+    for (int s = 0; s < scenes->count; s++) free(scenes->scenes[s].containedNodes);
+    scenes->count = 0;
+}
+
+static void Autosave_FlushDeferred(Autosave *autosave) {
+    for (int i = 0; i < autosave->deferredCount; i++) free(autosave->deferred[i]);
+    autosave->deferredCount = 0;
+}
+
+// Freezes the graph. O(chunks) pointer table plus the scene member lists, no node is copied here.
+static bool Autosave_BeginSnapshot(Context *context, unsigned int fingerprint) {
+    Autosave *autosave = context->autosave;
+    NodePool *pool = context->pool;
+    EdgeStore *edges = &context->edges;
+    double start = Clock_Seconds();
+
+    Node **frozenNodes = calloc(pool->chunkCount + 1, sizeof(Node *));
+    BezierCurve **frozenEdges = calloc(edges->chunkCount + 1, sizeof(BezierCurve *));
+    if (!frozenNodes || !frozenEdges) {
+        free(frozenNodes);
+        free(frozenEdges);
+        return false;
+    }
+
+    pool->frozen = frozenNodes;
+    pool->frozenCount = pool->chunkCount;
+    pool->frozenFailed = false;
+    edges->frozen = frozenEdges;
+    edges->frozenChunkCount = edges->chunkCount;
+    edges->frozenCount = edges->count;
+    edges->frozenFailed = false;
+
+    // Scenes live in a fixed array, only their member lists need their own copy
+    autosave->scenes = context->sceneList;
+    for (int s = 0; s < autosave->scenes.count; s++) {
+        SceneOutline *scene = &autosave->scenes.scenes[s];
+        NodeHandle *members = malloc((scene->nodeCount + 1) * sizeof(NodeHandle));
+        if (members) memcpy(members, scene->containedNodes, scene->nodeCount * sizeof(NodeHandle));
+        scene->containedNodes = members;
+        scene->nodeCount = members ? scene->nodeCount : 0;
+        scene->nodeCapacity = scene->nodeCount;
+        scene->memberBits = NULL;
+        scene->memberWords = 0;
+    }
+    autosave->camera = context->camera;
+    autosave->lastSaveKey = pool->lastSaveKey;
+    autosave->nextChunk = 0;
+    autosave->savedFingerprint = fingerprint;
+    autosave->retry = false;
+
+    autosave->stats.snapshotMicros = (Clock_Seconds() - start) * 1e6;
+    autosave->stats.copyMicros = 0.0;
+    Autosave_SetState(autosave, AUTOSAVE_COPYING);
+    return true;
+}
+
+// Tells the journal how the compaction went, the snapshot is gone either way
+static void Autosave_EndCompaction(Context *context, bool ok) {
+    Autosave *autosave = context->autosave;
+    if (!autosave->compacting) return;
+    autosave->compacting = false;
+    Journal_CompactDone(context, ok, autosave->written.bytes);
+}
+
+// Drops a snapshot that never reached the worker and thaws the live stores
+static void Autosave_AbortSnapshot(Context *context) {
+    Autosave *autosave = context->autosave;
+    NodePool *pool = context->pool;
+    EdgeStore *edges = &context->edges;
+
+    Autosave_FreeChunks((void **)pool->frozen, pool->frozenCount);
+    Autosave_FreeChunks((void **)edges->frozen, edges->frozenChunkCount);
+    pool->frozen = NULL;
+    pool->frozenCount = 0;
+    edges->frozen = NULL;
+    edges->frozenChunkCount = 0;
+    edges->frozenCount = 0;
+
+    Autosave_FreeScenes(&autosave->scenes);
+    Autosave_FlushDeferred(autosave);
+    autosave->retry = true;
+    Autosave_SetState(autosave, AUTOSAVE_IDLE);
+    Autosave_EndCompaction(context, false);
+}
+
+// Copies chunks nobody has written to yet, stops once the frame budget is spent (a chunk count in a replay)
+static void Autosave_CopyChunks(Context *context) {
+    Autosave *autosave = context->autosave;
+    NodePool *pool = context->pool;
+    EdgeStore *edges = &context->edges;
+    int total = pool->frozenCount + edges->frozenChunkCount;
+    double start = Clock_Seconds();
+    int copied = 0;
+
+    while (autosave->nextChunk < total) {
+        int i = autosave->nextChunk++;
+        if (i < pool->frozenCount) {
+            if (!pool->frozen[i]) {
+                pool->frozen[i] = malloc(NODE_POOL_CHUNK * sizeof(Node));
+                if (pool->frozen[i]) memcpy(pool->frozen[i], pool->chunks[i], NODE_POOL_CHUNK * sizeof(Node));
+                else pool->frozenFailed = true;
+            }
+        } else {
+            i -= pool->frozenCount;
+            if (!edges->frozen[i]) {
+                edges->frozen[i] = malloc(EDGE_STORE_CHUNK * sizeof(BezierCurve));
+                if (edges->frozen[i]) memcpy(edges->frozen[i], edges->chunks[i], EDGE_STORE_CHUNK * sizeof(BezierCurve));
+                else edges->frozenFailed = true;
+            }
+        }
+        if (context->deterministic ? ++copied == AUTOSAVE_REPLAY_CHUNKS : Clock_Seconds() - start > AUTOSAVE_COPY_BUDGET) break;
+    }
+    autosave->stats.copyMicros += (Clock_Seconds() - start) * 1e6;
+
+    if (autosave->nextChunk < total) return;
+    if (pool->frozenFailed || edges->frozenFailed) {
+        Autosave_AbortSnapshot(context);
+        return;
+    }
+
+    // Complete: the copies become the snapshot, the live stores go back to plain writes
+    autosave->pool = (NodePool){ .chunks = pool->frozen, .chunkCount = pool->frozenCount };
+    autosave->edges = (EdgeStore){
+        .chunks = edges->frozen,
+        .chunkCount = edges->frozenChunkCount,
+        .count = edges->frozenCount
+    };
+    pool->frozen = NULL;
+    pool->frozenCount = 0;
+    edges->frozen = NULL;
+    edges->frozenChunkCount = 0;
+    edges->frozenCount = 0;
+
+    if (context->deterministic) {
+        Autosave_Write(autosave);   // the worker never sees AUTOSAVE_WRITING and stays asleep
+        return;
+    }
+    Autosave_SetState(autosave, AUTOSAVE_WRITING);
+}
+
+// Releases a snapshot the worker is done with
+static void Autosave_FinishSnapshot(Context *context) {
+    Autosave *autosave = context->autosave;
+
+    Autosave_FreeChunks((void **)autosave->pool.chunks, autosave->pool.chunkCount);
+    Autosave_FreeChunks((void **)autosave->edges.chunks, autosave->edges.chunkCount);
+    autosave->pool = (NodePool){0};
+    autosave->edges = (EdgeStore){0};
+    Autosave_FreeScenes(&autosave->scenes);
+    Autosave_FlushDeferred(autosave);
+
+    if (autosave->compacting) {
+        Autosave_SetState(autosave, AUTOSAVE_IDLE);
+        Autosave_EndCompaction(context, autosave->writeOk);
+        RequestRedraw(context);
+        return;
+    }
+
+    autosave->stats.saves++;
+    autosave->stats.lastOk = autosave->writeOk;
+    autosave->retry = !autosave->writeOk;
+    if (autosave->writeOk) {
+        TraceLog(LOG_INFO, "AUTOSAVE: Saved [%s] snapshot %.0f us, copy %.0f us, write %.2f ms", autosave->path,
+                 autosave->stats.snapshotMicros, autosave->stats.copyMicros, autosave->stats.writeMillis);
+    } else {
+        TraceLog(LOG_WARNING, "AUTOSAVE: Failed writing [%s]", autosave->path);
+    }
+
+    Autosave_SetState(autosave, AUTOSAVE_IDLE);
+    Autosave_Disarm(context);
+    RequestRedraw(context);
+}
+
+// PUBLIC
+bool Autosave_Start(Context *context, const char *path) {
+    Autosave *autosave = calloc(1, sizeof(Autosave));
+    if (!autosave) return false;
+
+    snprintf(autosave->path, sizeof(autosave->path), "%s", path);
+    snprintf(autosave->tmpPath, sizeof(autosave->tmpPath), "%s.tmp", path);
+    pthread_mutex_init(&autosave->lock, NULL);
+    pthread_cond_init(&autosave->wake, NULL);
+    pthread_cond_init(&autosave->finished, NULL);
+
+    if (pthread_create(&autosave->thread, NULL, Autosave_Worker, autosave) != 0) {
+        pthread_cond_destroy(&autosave->finished);
+        pthread_cond_destroy(&autosave->wake);
+        pthread_mutex_destroy(&autosave->lock);
+        free(autosave);
+        TraceLog(LOG_WARNING, "AUTOSAVE: Could not start the worker thread");
+        return false;
+    }
+
+    context->autosave = autosave;
+    autosave->savedFingerprint = Autosave_Fingerprint(context);  // the startup state is not worth saving
+    return true;
+}
+
+void Autosave_Stop(Context *context) {
+    Autosave *autosave = context->autosave;
+    if (!autosave) return;
+
+    Autosave_Cancel(context);
+
+    pthread_mutex_lock(&autosave->lock);
+    autosave->quit = true;
+    pthread_cond_broadcast(&autosave->wake);
+    pthread_mutex_unlock(&autosave->lock);
+    pthread_join(autosave->thread, NULL);
+
+    pthread_cond_destroy(&autosave->finished);
+    pthread_cond_destroy(&autosave->wake);
+    pthread_mutex_destroy(&autosave->lock);
+    free(autosave->deferred);
+    free(autosave);
+    context->autosave = NULL;
+}
+
+// Once per frame, after input has been handled. Never waits on the worker.
+void Autosave_Update(Context *context) {
+    Autosave *autosave = context->autosave;
+    if (!autosave) return;
+
+    AutosaveState state = Autosave_GetState(autosave);
+    if (state == AUTOSAVE_DONE) {
+        Autosave_FinishSnapshot(context);
+        state = AUTOSAVE_IDLE;
+    }
+    if (state == AUTOSAVE_COPYING) {
+        Autosave_CopyChunks(context);
+        return;
+    }
+    if (state != AUTOSAVE_IDLE) return;  // worker still writing
+
+    unsigned int fingerprint = Autosave_Fingerprint(context);
+    if (fingerprint == autosave->savedFingerprint && !autosave->retry) return;
+
+    // keep the loop polling while there are unsaved edits, the timer has to fire while idle too.
+    // Frame time, not the wall clock, so a replayed session autosaves on the same frames.
+    double now = context->input.time;
+    if (!autosave->armed) {
+        autosave->armed = true;
+        autosave->dirtySince = now;
+        context->pendingJobs++;
+    }
+    if (now - autosave->dirtySince < AUTOSAVE_INTERVAL) return;
+
+    // frame boundary between gestures, a half-finished drag is not worth saving
+    if (context->isDragging || context->draggedScene || context->resizingScene || context->connecting) return;
+
+    Autosave_BeginSnapshot(context, fingerprint);
+}
+
+// Writes the current state over the project file in the background, the journal uses it to fold
+// its log back in. Only starts while no snapshot is in flight, the journal retries on its next save.
+bool Autosave_Compact(Context *context, const char *path, uint32_t journalSeq) {
+    Autosave *autosave = context->autosave;
+    if (!autosave || Autosave_GetState(autosave) != AUTOSAVE_IDLE) return false;
+
+    snprintf(autosave->compactPath, sizeof(autosave->compactPath), "%s", path);
+    snprintf(autosave->compactTmpPath, sizeof(autosave->compactTmpPath), "%s.tmp", path);
+    autosave->journalSeq = journalSeq;
+    autosave->written = (ProjectStats){0};
+    if (!Autosave_BeginSnapshot(context, Autosave_Fingerprint(context))) return false;
+    autosave->compacting = true;
+    return true;
+}
+
+bool Autosave_IsBusy(const Context *context) {
+    return context->autosave && Autosave_GetState(context->autosave) != AUTOSAVE_IDLE;
+}
+
+// Drops or finishes the snapshot in flight. Waits for the worker, only used before the whole
+// project is replaced or the editor shuts down (the snapshot may point into the mapped file).
+void Autosave_Cancel(Context *context) {
+    Autosave *autosave = context->autosave;
+    if (!autosave) return;
+
+    pthread_mutex_lock(&autosave->lock);
+    while (autosave->state == AUTOSAVE_WRITING) {
+        pthread_cond_wait(&autosave->finished, &autosave->lock);
+    }
+    AutosaveState state = autosave->state;
+    pthread_mutex_unlock(&autosave->lock);
+
+    if (state == AUTOSAVE_DONE) Autosave_FinishSnapshot(context);
+    else if (state == AUTOSAVE_COPYING) Autosave_AbortSnapshot(context);
+    Autosave_Disarm(context);
+    autosave->retry = false;
+}
+
+// free() for node text, held back while a snapshot may still reference it
+void Autosave_ReleaseText(Context *context, char *text) {
+    Autosave *autosave = context->autosave;
+    if (!text) return;
+    if (!autosave || Autosave_GetState(autosave) == AUTOSAVE_IDLE) {
+        free(text);
+        return;
+    }
+
+    if (autosave->deferredCount == autosave->deferredCapacity) {
+        int newCapacity = autosave->deferredCapacity ? autosave->deferredCapacity * 2 : 64;
+        char **deferred = realloc(autosave->deferred, newCapacity * sizeof(char *));
+        if (!deferred) return;  // leak rather than free text the worker may be reading
+        autosave->deferred = deferred;
+        autosave->deferredCapacity = newCapacity;
+    }
+    autosave->deferred[autosave->deferredCount++] = text;
+}
+
+bool Autosave_GetStats(const Context *context, AutosaveStats *stats) {
+    Autosave *autosave = context->autosave;
+    if (!autosave) return false;
+
+    pthread_mutex_lock(&autosave->lock);
+    *stats = autosave->stats;
+    stats->busy = autosave->state != AUTOSAVE_IDLE;
+    pthread_mutex_unlock(&autosave->lock);
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include "core.h"
+#include <stdint.h>
+
+// Background autosave
+// A snapshot is taken at a frame boundary by freezing the node pool and edge store: nothing is
+// copied up front, the first edit to a chunk keeps its old contents (NodePool_Touch /
+// EdgeStore_Touch) and the remaining chunks are copied a few per frame within a time budget.
+// Once the snapshot is complete a worker thread encodes it, syncs it to disk and renames it over
+// the previous autosave, so a crash never leaves a half-written file. A replay
+// (context->deterministic) copies a fixed number of chunks per frame and writes on the main thread,
+// so the save finishes on the same frame every run.
+#define AUTOSAVE_FILE_PATH "autosave.nprose"
+#ifndef AUTOSAVE_INTERVAL
+#define AUTOSAVE_INTERVAL 30.0          // seconds between the first unsaved edit and the autosave
+#endif
+#ifndef AUTOSAVE_COPY_BUDGET
+#define AUTOSAVE_COPY_BUDGET 0.001      // seconds per frame the main loop may spend copying chunks
+#endif
+#ifndef AUTOSAVE_REPLAY_CHUNKS
+#define AUTOSAVE_REPLAY_CHUNKS 16       // chunks copied per frame instead when context->deterministic
+#endif
+
+typedef struct Autosave Autosave;   // worker state, private to autosave.c
+
+typedef struct {
+    double snapshotMicros;  // freezing the graph at the frame boundary
+    double copyMicros;      // copying untouched chunks, spread over the following frames
+    double writeMillis;     // worker: encode, write, sync and rename
+    int saves;
+    bool busy;              // a snapshot is being copied or written
+    bool lastOk;
+} AutosaveStats;
+
+bool Autosave_Start(Context *context, const char *path);
+void Autosave_Stop(Context *context);
+void Autosave_Update(Context *context);
+void Autosave_Cancel(Context *context);
+bool Autosave_Compact(Context *context, const char *path, uint32_t journalSeq);
+bool Autosave_IsBusy(const Context *context);
+void Autosave_ReleaseText(Context *context, char *text);
+bool Autosave_GetStats(const Context *context, AutosaveStats *stats);
+
+#endif
@@ -0,0 +1,254 @@
+// Editor core benchmark: how the graph operations and the drag and pan frames scale with the size
+// of the project, on graphs from graphgen.h with the default mix.
+//
+// Build from the repository root against the core library npp_script builds (libnodeprose.a):
+//   gcc -O2 -std=c99 -I. -o editor_bench bench/editor_bench.c -L. -lnodeprose -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
+// Run:
+//   editor_bench [sizes] [csv]      defaults ("" for sizes): 1000,10000,100000 nodes, no CSV
+//   The CSV gets one row per size and operation: nodes, operation, samples, then mean, p50, p99
+//   and max in microseconds. Compare the rows of two versions to see what stopped scaling.
+// Every operation but the build is timed one call (or one frame) at a time, BENCH_OPS times, on
+// random nodes of the graph. The "clock" row is what reading the clock itself costs.
+// Frames run Editor_Update and CollectVisibleNodes on a 1280x720 view, like tools/replay.c: the
+// drag frames hold a node and move it, the pan frames hold the middle button, once at zoom 1 and
+// once zoomed out to 0.2 where a few hundred nodes are on screen.
+#include "raylib.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "graphgen.h"
+#include "runtime/narrative.h"
+
+#define BENCH_OPS 1000
+#define BENCH_MAX_SIZES 16
+
+typedef struct {
+    double items[BENCH_OPS];
+    int count;
+} Samples;
+
+typedef struct {
+    FILE *csv;
+    int nodes;
+} Report;
+
+static int CompareDouble(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static void Samples_Add(Samples *samples, double seconds) {
+    if (samples->count < BENCH_OPS) samples->items[samples->count++] = seconds;
+}
+
+// Sorts the samples and prints them, in microseconds
+static void Report_Row(Report *report, const char *operation, Samples *samples) {
+    int n = samples->count;
+    if (n == 0) return;
+    double *s = samples->items;
+    qsort(s, n, sizeof(double), CompareDouble);
+    double total = 0;
+    for (int i = 0; i < n; i++) total += s[i];
+
+    double mean = total / n * 1e6, p50 = s[n / 2] * 1e6, p99 = s[(int)(n * 0.99)] * 1e6, max = s[n - 1] * 1e6;
+    printf("  %-20s %5d  mean %10.2f  p50 %10.2f  p99 %10.2f  max %10.2f us\n", operation, n, mean, p50, p99, max);
+    if (report->csv) fprintf(report->csv, "%d,%s,%d,%.3f,%.3f,%.3f,%.3f\n", report->nodes, operation, n, mean, p50, p99, max);
+    samples->count = 0;
+}
+
+// Live nodes in slot order
+static int Bench_LiveNodes(NodePool *pool, Node **out) {
+    int count = 0;
+    for (int i = 0; i < NodePool_SlotCount(pool); i++) {
+        Node *node = NodePool_At(pool, i);
+        if (node->type != NODE_COUNT) out[count++] = node;
+    }
+    return count;
+}
+
+// One editor frame with the given mouse, the time moves on by a 60 Hz frame
+static double Bench_Frame(Context *context, const ScreenSettings *screen, Vector2 mouse, unsigned down, double *time) {
+    FrameInput previous = context->input;
+    *time += 1.0 / 60.0;
+    context->input = (FrameInput){
+        .time = *time,
+        .mouse = mouse,
+        .mouseDelta = Vector2Subtract(mouse, previous.mouse),
+        .buttonsDown = down,
+        .buttonsPressed = down & ~previous.buttonsDown,
+        .buttonsReleased = previous.buttonsDown & ~down
+    };
+
+    double start = Clock_Seconds();
+    Editor_Update(context, screen);
+    if (UpdateRedrawMode(context)) CollectVisibleNodes(context);
+    double elapsed = Clock_Seconds() - start;
+    context->warpMouse = false;
+    return elapsed;
+}
+
+static void Bench_Pan(Report *report, Context *context, const ScreenSettings *screen, float zoom, double *time, const char *name) {
+    Samples samples = {0};
+    Vector2 center = { screen->width / 2.0f, screen->height / 2.0f };
+    context->camera.zoom = zoom;
+    Bench_Frame(context, screen, center, INPUT_BUTTON(MOUSE_BUTTON_MIDDLE), time);
+    for (int f = 0; f < BENCH_OPS; f++) {
+        Vector2 mouse = { center.x + 300.0f * sinf(f * 0.02f), center.y + 200.0f * cosf(f * 0.03f) };
+        Samples_Add(&samples, Bench_Frame(context, screen, mouse, INPUT_BUTTON(MOUSE_BUTTON_MIDDLE), time));
+    }
+    Bench_Frame(context, screen, center, 0, time);
+    context->camera.zoom = 1.0f;
+    Report_Row(report, name, &samples);
+}
+
+static void Bench_Size(Report *report, int nodeCount) {
+    static Samples samples;
+    NodePool pool;
+    Context context;
+    if (!Editor_Init(&context, &pool)) return;
+    ScreenSettings screen = {.width = 1280, .height = 720, .currentSize = SCREEN_SMALL, .currentView = VIEW_MODE_NODE};
+    NarrativeRandom random;
+    NarrativeRandom_Seed(&random, (uint64_t)nodeCount, 0x62656e63u);
+    report->nodes = nodeCount;
+
+    // === Build ===
+    GraphSpec spec = GraphGen_DefaultSpec(nodeCount);
+    double start = Clock_Seconds();
+    int created = GraphGen_Build(&context, &spec);
+    Samples_Add(&samples, Clock_Seconds() - start);
+    start = Clock_Seconds();
+    UpdateSceneNodeMembership(&context);
+    double settle = Clock_Seconds() - start;
+
+    printf("%d nodes (%d built), %d edges, %d scenes\n", pool.liveCount, created, context.edges.count, context.sceneList.count);
+    Report_Row(report, "build", &samples);
+    Samples_Add(&samples, settle);
+    Report_Row(report, "membership_settle", &samples);
+
+    for (int i = 0; i < BENCH_OPS; i++) {
+        start = Clock_Seconds();
+        Samples_Add(&samples, Clock_Seconds() - start);
+    }
+    Report_Row(report, "clock", &samples);
+
+    // the layout's extent, new nodes land anywhere in it
+    Rectangle area = { spec.origin.x, spec.origin.y, 0, 0 };
+    for (int s = 0; s < context.sceneList.count; s++) {
+        Rectangle b = context.sceneList.scenes[s].bounds;
+        area.width = fmaxf(area.width, b.x + b.width - area.x);
+        area.height = fmaxf(area.height, b.y + b.height - area.y);
+    }
+
+    // === Single operations ===
+    for (int i = 0; i < BENCH_OPS; i++) {
+        Vector2 position = {
+            area.x + area.width * NarrativeRandom_Below(&random, 10000) / 10000.0f,
+            area.y + area.height * NarrativeRandom_Below(&random, 10000) / 10000.0f
+        };
+        start = Clock_Seconds();
+        CreateNodeAt(position, &context);
+        Samples_Add(&samples, Clock_Seconds() - start);
+    }
+    Report_Row(report, "CreateNodeAt", &samples);
+
+    start = Clock_Seconds();
+    UpdateSceneNodeMembership(&context);
+    Samples_Add(&samples, Clock_Seconds() - start);
+    Report_Row(report, "membership_created", &samples);
+
+    Node **live = malloc(pool.liveCount * sizeof(Node *));
+    if (!live) {
+        Editor_Shutdown(&context);
+        return;
+    }
+    int liveCount = Bench_LiveNodes(&pool, live);
+
+    // a node dropped 10 px further: what every drag end and expand costs
+    for (int i = 0; i < BENCH_OPS; i++) {
+        Node *node = live[NarrativeRandom_Below(&random, (uint32_t)liveCount)];
+        NodePool_Touch(&pool, node);
+        node->position.x += 10.0f;
+        UpdateConnectorPositions(node);
+        SpatialGrid_Update(&context.grid, node);
+        MarkNodeMembershipDirty(node, &context);
+        start = Clock_Seconds();
+        UpdateSceneNodeMembership(&context);
+        Samples_Add(&samples, Clock_Seconds() - start);
+    }
+    Report_Row(report, "membership_move", &samples);
+
+    for (int i = 0; i < BENCH_OPS; i++) {
+        Node *node = live[NarrativeRandom_Below(&random, (uint32_t)liveCount)];
+        start = Clock_Seconds();
+        BringNodeToTop(node, &context);
+        Samples_Add(&samples, Clock_Seconds() - start);
+    }
+    Report_Row(report, "BringNodeToTop", &samples);
+
+    // === Frames ===
+    double time = 0;
+    Vector2 center = { screen.width / 2.0f, screen.height / 2.0f };
+    Node *held = live[NarrativeRandom_Below(&random, (uint32_t)liveCount)];
+    context.camera.offset = center;
+    context.camera.target = (Vector2){ held->position.x + held->width / 2.0f, held->position.y + 40.0f };  // below the icons
+    Bench_Frame(&context, &screen, center, 0, &time);
+    for (int f = 0; f < BENCH_OPS + 10 && samples.count < BENCH_OPS; f++) {
+        Vector2 mouse = { center.x + 2.0f * f, center.y + (f % 40 < 20 ? f % 20 : 20 - f % 20) };
+        double elapsed = Bench_Frame(&context, &screen, mouse, INPUT_BUTTON(MOUSE_BUTTON_LEFT), &time);
+        if (context.draggedNode) Samples_Add(&samples, elapsed);     // the first frames wait for the drag delay
+    }
+    bool dragged = context.draggedNode == held;
+    Report_Row(report, "drag_frame", &samples);
+    Samples_Add(&samples, Bench_Frame(&context, &screen, center, 0, &time));
+    Report_Row(report, "drag_release", &samples);
+    if (!dragged) printf("  the drag did not pick up the node\n");
+
+    Bench_Pan(report, &context, &screen, 1.0f, &time, "pan_frame");
+    Bench_Pan(report, &context, &screen, 0.2f, &time, "pan_frame_zoom_0.2");
+
+    // === Delete, each node once ===
+    for (int i = 0; i < BENCH_OPS && liveCount > 0; i++) {
+        int pick = (int)NarrativeRandom_Below(&random, (uint32_t)liveCount);
+        Node *node = live[pick];
+        live[pick] = live[--liveCount];
+        start = Clock_Seconds();
+        DeleteNodeFromList(node, &context);
+        Samples_Add(&samples, Clock_Seconds() - start);
+    }
+    Report_Row(report, "DeleteNodeFromList", &samples);
+
+    free(live);
+    Project_Clear(&context);    // frees the dialogue texts
+    Editor_Shutdown(&context);
+}
+
+int main(int argc, char **argv) {
+    int sizes[BENCH_MAX_SIZES] = { 1000, 10000, 100000 }, sizeCount = 3;
+    if (argc > 1 && argv[1][0]) {
+        sizeCount = 0;
+        for (const char *p = argv[1]; *p && sizeCount < BENCH_MAX_SIZES; ) {
+            char *end;
+            long size = strtol(p, &end, 10);
+            if (end == p || size < 1) {
+                printf("usage: editor_bench [sizes] [csv]   sizes like 1000,10000,100000\n");
+                return 1;
+            }
+            sizes[sizeCount++] = (int)size;
+            p = *end == ',' ? end + 1 : end;
+        }
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    Report report = { .csv = argc > 2 ? fopen(argv[2], "w") : NULL };
+    if (report.csv) fprintf(report.csv, "nodes,operation,samples,mean_us,p50_us,p99_us,max_us\n");
+
+    for (int i = 0; i < sizeCount; i++) Bench_Size(&report, sizes[i]);
+
+    if (report.csv) fclose(report.csv);
+    return 0;
+}
@@ -0,0 +1,316 @@
+// Save / load benchmark for the binary and text project formats.
+//
+// Build from the repository root against the core library npp_script builds (libnodeprose.a):
+//   gcc -O2 -std=c99 -I. -o project_bench bench/project_bench.c -L. -lnodeprose -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
+// Run:
+//   project_bench [nodeCount] [rounds] [textBytes]      defaults: 10000 nodes, 20 rounds, 48 bytes of text per node
+// Load time should follow the node count only, text stays in the mapping until a node is expanded.
+// A journal save should follow the amount of edited nodes only, not the project size.
+// The text export has to read back into the same bytes, and moving one node plus bringing
+// another to the front should change a handful of lines however large the project is.
+// Opening the scene store should load the scenes near the view only, and saving it again
+// without edits should rewrite no chunk.
+#define _POSIX_C_SOURCE 199309L
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core.h"
+#include "project.h"
+#include "journal.h"
+#include "projecttext.h"
+#include "scenestore.h"
+
+#define BENCH_FILE_PATH "project_bench.nprose"
+#define BENCH_RESAVE_PATH "project_bench_resave.nprose"
+#define BENCH_JOURNAL_PATH "project_bench_journal.nprose"
+#define BENCH_JOURNAL_EDITS 10      // nodes moved between two journal saves
+#define BENCH_TEXT_PATH "project_bench.nprose.txt"
+#define BENCH_TEXT_RESAVE_PATH "project_bench_resave.nprose.txt"
+#define BENCH_SCENES_DIR "project_bench.scenes"
+
+static double Bench_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static char* Bench_ReadFile(const char *path, long *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    rewind(file);
+    char *data = malloc(*size + 1);
+    if (data && fread(data, 1, *size, file) != (size_t)*size) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    if (data) data[*size] = '\0';
+    return data;
+}
+
+// Splits the file into lines (modifies data)
+static char** Bench_Lines(char *data, int *count) {
+    int capacity = 1;
+    for (char *c = data; *c; c++) capacity += *c == '\n';
+    char **lines = malloc(capacity * sizeof(char *));
+    *count = 0;
+    for (char *line = data; *line; ) {
+        char *end = strchr(line, '\n');
+        lines[(*count)++] = line;
+        if (!end) break;
+        *end = '\0';
+        line = end + 1;
+    }
+    return lines;
+}
+
+// Lines removed plus lines added between two versions (Myers' O(ND) diff), -1 past maxEdits
+static int Bench_DiffLines(char **a, int n, char **b, int m, int maxEdits) {
+    int *furthest = calloc(2 * maxEdits + 3, sizeof(int));  // furthest x reached on each diagonal k = x - y
+    int offset = maxEdits + 1;
+    for (int d = 0; d <= maxEdits; d++) {
+        for (int k = -d; k <= d; k += 2) {
+            bool down = k == -d || (k != d && furthest[offset + k - 1] < furthest[offset + k + 1]);
+            int x = down ? furthest[offset + k + 1] : furthest[offset + k - 1] + 1;
+            int y = x - k;
+            while (x < n && y < m && strcmp(a[x], b[y]) == 0) {
+                x++;
+                y++;
+            }
+            furthest[offset + k] = x;
+            if (x >= n && y >= m) {
+                free(furthest);
+                return d;
+            }
+        }
+    }
+    free(furthest);
+    return -1;
+}
+
+static int Bench_ChangedLines(const char *pathA, const char *pathB) {
+    long sizeA, sizeB;
+    char *a = Bench_ReadFile(pathA, &sizeA);
+    char *b = Bench_ReadFile(pathB, &sizeB);
+    int changed = -1;
+    if (a && b) {
+        int countA, countB;
+        char **linesA = Bench_Lines(a, &countA);
+        char **linesB = Bench_Lines(b, &countB);
+        changed = Bench_DiffLines(linesA, countA, linesB, countB, 1000);
+        free(linesA);
+        free(linesB);
+    }
+    free(a);
+    free(b);
+    return changed;
+}
+
+// Grid of nodes with a chain of connections, some extra links, dialogue text and a few scenes
+static void Bench_BuildProject(Context *context, int nodeCount, int textBytes) {
+    Node **nodes = malloc(nodeCount * sizeof(Node *));
+    int columns = 100;
+    static const char filler[] = "The narrator pauses, then carries on. ";
+
+    for (int i = 0; i < nodeCount; i++) {
+        Vector2 position = { (float)(i % columns) * 260.0f, (float)(i / columns) * 120.0f };
+        nodes[i] = CreateNodeAt(position, context);
+
+        char *text = malloc(textBytes + 1);
+        for (int k = 0; k < textBytes; k++) text[k] = filler[k % (sizeof(filler) - 1)];
+        text[textBytes] = '\0';
+        nodes[i]->data.defaultNode.text = text;
+    }
+
+    for (int i = 0; i + 1 < nodeCount; i++) {
+        int target = (i % 7 == 0 && i + 50 < nodeCount) ? i + 50 : i + 1;
+        Node *from = nodes[i], *to = nodes[target];
+        Vector2 start = from->connectors[1].center, end = to->connectors[0].center;
+
+        from->connectors[1].with.to = NodePool_Handle(to);
+        to->connectors[0].with.from = NodePool_Handle(from);
+        from->data.defaultNode.next = (Connection){ NodePool_Handle(from), NodePool_Handle(to) };
+        EdgeStore_Add(&context->edges, context->pool, (BezierCurve){
+            .points = { start, { start.x + 50, start.y }, { end.x - 50, end.y }, end },
+            .fromNode = NodePool_Handle(from),
+            .toNode = NodePool_Handle(to),
+            .relativeposition = {
+                { start.x - from->position.x, start.y - from->position.y },
+                { end.x - to->position.x, end.y - to->position.y }
+            }
+        });
+    }
+
+    for (int s = 0; s < 20 && s * 500 < nodeCount; s++) {
+        SceneOutline *scene = &context->sceneList.scenes[context->sceneList.count++];
+        *scene = (SceneOutline){ .bounds = { -20, s * 5 * 120.0f - 40, columns * 260.0f, 5 * 120.0f } };
+        snprintf(scene->name, sizeof(scene->name), "Scene %d", s + 1);
+        for (int i = s * 500; i < (s + 1) * 500 && i < nodeCount; i++) SceneOutline_AddNode(scene, nodes[i]);
+    }
+
+    free(nodes);
+}
+
+int main(int argc, char **argv) {
+    int nodeCount = argc > 1 ? atoi(argv[1]) : 10000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    int textBytes = argc > 3 ? atoi(argv[3]) : 48;
+    if (nodeCount < 1) nodeCount = 1;
+    if (rounds < 1) rounds = 1;
+    if (textBytes < 0) textBytes = 0;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    NodePool pool;
+    NodePool_Init(&pool);
+    Context context = { .pool = &pool, .camera = { .zoom = 1.0f } };
+    EdgeStore_Init(&context.edges);
+    SpatialGrid_Init(&context.grid);
+    Bench_BuildProject(&context, nodeCount, textBytes);
+
+    double *saveTimes = malloc(rounds * sizeof(double));
+    double *loadTimes = malloc(rounds * sizeof(double));
+    ProjectStats stats = {0};
+
+    // Saves go to a second file, saving over the mapped file would first copy all text out of it
+    if (!Project_Save(&context, BENCH_FILE_PATH, &stats)) return 1;
+    for (int r = 0; r < rounds; r++) {
+        double start = Bench_Now();
+        if (!Project_Load(&context, BENCH_FILE_PATH, &stats)) return 1;
+        loadTimes[r] = Bench_Now() - start;
+
+        start = Bench_Now();
+        if (!Project_Save(&context, BENCH_RESAVE_PATH, &stats)) return 1;
+        saveTimes[r] = Bench_Now() - start;
+    }
+
+    // What the old loader paid up front: every text copied out of the file
+    double start = Bench_Now();
+    for (Node *node = context.zHead; node; node = node->nextZ) Node_MaterializeText(node);
+    double materializeTime = Bench_Now() - start;
+
+    // Journal: one full save starts it, then every save only appends the nodes moved since
+    double *appendTimes = malloc(rounds * sizeof(double));
+    JournalStats journalStats = {0};
+    if (!Journal_Save(&context, BENCH_JOURNAL_PATH, &journalStats)) return 1;
+    for (int r = 0; r < rounds; r++) {
+        for (int e = 0; e < BENCH_JOURNAL_EDITS; e++) {
+            Node *node = NodePool_At(&pool, rand() % NodePool_SlotCount(&pool));
+            if (node->type == NODE_COUNT) continue;
+            NodePool_Touch(&pool, node);
+            node->position.x += 10.0f;
+        }
+        start = Bench_Now();
+        if (!Journal_Save(&context, BENCH_JOURNAL_PATH, &journalStats)) return 1;
+        appendTimes[r] = Bench_Now() - start;
+    }
+    uint32_t appendBytes = journalStats.bytes;
+
+    start = Bench_Now();
+    if (!Journal_Load(&context, BENCH_JOURNAL_PATH, &journalStats)) return 1;
+    double replayLoadTime = Bench_Now() - start;
+    qsort(appendTimes, rounds, sizeof(double), CompareDouble);
+
+    // Text: export, import, export again must give the same bytes
+    ProjectStats textStats = {0};
+    start = Bench_Now();
+    if (!ProjectText_Save(&context, BENCH_TEXT_PATH, &textStats)) return 1;
+    double textSaveTime = Bench_Now() - start;
+    start = Bench_Now();
+    if (!ProjectText_Load(&context, BENCH_TEXT_PATH, &textStats)) return 1;
+    double textLoadTime = Bench_Now() - start;
+    if (!ProjectText_Save(&context, BENCH_TEXT_RESAVE_PATH, NULL)) return 1;
+    int roundTripLines = Bench_ChangedLines(BENCH_TEXT_PATH, BENCH_TEXT_RESAVE_PATH);
+    long textSize, resaveSize;
+    char *text = Bench_ReadFile(BENCH_TEXT_PATH, &textSize);
+    char *resave = Bench_ReadFile(BENCH_TEXT_RESAVE_PATH, &resaveSize);
+    bool identical = text && resave && textSize == resaveSize && memcmp(text, resave, textSize) == 0;
+    free(text);
+    free(resave);
+
+    // one node moved, another one brought to the front
+    Node *moved = context.zHead;
+    NodePool_Touch(&pool, moved);
+    moved->position.x += 10.0f;
+    BringNodeToTop(context.zHead->nextZ ? context.zHead->nextZ : context.zHead, &context);
+    if (!ProjectText_Save(&context, BENCH_TEXT_RESAVE_PATH, NULL)) return 1;
+    int editLines = Bench_ChangedLines(BENCH_TEXT_PATH, BENCH_TEXT_RESAVE_PATH);
+
+    // Scene store: split, then open with the view on the top rows of the grid
+    SceneStoreStats splitStats = {0}, openStats = {0}, allStats = {0}, resaveStats = {0};
+    start = Bench_Now();
+    if (!SceneStore_Create(&context, BENCH_SCENES_DIR, &splitStats)) return 1;
+    double splitTime = Bench_Now() - start;
+
+    context.viewWorld = (Rectangle){ 0, 0, 1280, 720 };
+    start = Bench_Now();
+    if (!SceneStore_Open(&context, BENCH_SCENES_DIR, &openStats)) return 1;
+    SceneStore_Update(&context);
+    double openTime = Bench_Now() - start;
+    uint32_t openNodes = (uint32_t)pool.liveCount;
+    SceneStore_GetStats(&context, &openStats);
+
+    start = Bench_Now();
+    if (!SceneStore_LoadAll(&context)) return 1;
+    double loadAllTime = Bench_Now() - start;
+    SceneStore_GetStats(&context, &allStats);
+    if (!SceneStore_Save(&context, &resaveStats)) return 1;
+
+    qsort(saveTimes, rounds, sizeof(double), CompareDouble);
+    qsort(loadTimes, rounds, sizeof(double), CompareDouble);
+
+    printf("project: %u nodes, %u links, %u edges, %u scenes, %u bytes\n",
+           stats.nodes, stats.links, stats.edges, stats.scenes, stats.bytes);
+    printf("save: min %.3f ms  median %.3f ms\n", saveTimes[0] * 1000.0, saveTimes[rounds / 2] * 1000.0);
+    printf("load: min %.3f ms  median %.3f ms\n", loadTimes[0] * 1000.0, loadTimes[rounds / 2] * 1000.0);
+    printf("materialize all text: %.3f ms\n", materializeTime * 1000.0);
+    printf("journal save, %d nodes moved: min %.3f ms  median %.3f ms  (%u bytes appended)\n",
+           BENCH_JOURNAL_EDITS, appendTimes[0] * 1000.0, appendTimes[rounds / 2] * 1000.0, appendBytes);
+    printf("load + replay %u batches: %.3f ms  (log %u bytes)\n",
+           journalStats.batches, replayLoadTime * 1000.0, journalStats.logBytes);
+    printf("text export: %.3f ms  import: %.3f ms  (%u bytes)  round trip %s (%d lines differ)\n",
+           textSaveTime * 1000.0, textLoadTime * 1000.0, textStats.bytes, identical ? "identical" : "DIFFERS", roundTripLines);
+    printf("text diff after moving one node and focusing another: %d lines\n", editLines);
+    printf("scene store split: %.3f ms  (%u chunks, %u bytes)\n",
+           splitTime * 1000.0, splitStats.chunksWritten, splitStats.bytes);
+    printf("scene store open: %.3f ms  %u/%u scenes  %u nodes  %u bytes resident\n",
+           openTime * 1000.0, openStats.loadedScenes, openStats.scenes, openNodes, openStats.residentBytes);
+    printf("scene store load all: %.3f ms  %u nodes  %u bytes resident  resave %u chunks\n",
+           loadAllTime * 1000.0, (uint32_t)pool.liveCount, allStats.residentBytes, resaveStats.chunksWritten);
+
+    Project_Clear(&context);
+    Journal_Close(&context);
+    SpatialGrid_Destroy(&context.grid);
+    EdgeStore_Destroy(&context.edges);
+    NodePool_Destroy(&pool);
+    free(context.visibleNodes);
+    free(context.membershipQueue);
+    free(saveTimes);
+    free(loadTimes);
+    free(appendTimes);
+    remove(BENCH_FILE_PATH);
+    remove(BENCH_RESAVE_PATH);
+    remove(BENCH_JOURNAL_PATH);
+    remove(BENCH_JOURNAL_PATH ".log");
+    remove(BENCH_TEXT_PATH);
+    remove(BENCH_TEXT_RESAVE_PATH);
+    char chunkPath[64];
+    for (uint32_t id = 0; id <= allStats.scenes; id++) {
+        if (id) snprintf(chunkPath, sizeof(chunkPath), "%s/scene_%u.nprose", BENCH_SCENES_DIR, id);
+        else snprintf(chunkPath, sizeof(chunkPath), "%s/loose.nprose", BENCH_SCENES_DIR);
+        remove(chunkPath);
+    }
+    remove(BENCH_SCENES_DIR "/" SCENE_STORE_MANIFEST);
+    remove(BENCH_SCENES_DIR);
+    return 0;
+}
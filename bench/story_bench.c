@@ -0,0 +1,313 @@
+// Story runtime benchmark: steps per second of the compiled story against walking the node graph,
+// the latency of single events, and the size of save games.
+//
+// Build from the repository root against the core library npp_script builds (libnodeprose.a):
+//   gcc -O2 -std=c99 -I. -o story_bench bench/story_bench.c -L. -lnodeprose -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
+// Run:
+//   story_bench [nodeCount] [rounds] [steps]      defaults: 100000 nodes, 5 rounds, 20000000 steps per round
+// The graph repeats a block of ten nodes (a choice, dialogue, random, stack, skill gate, go to and
+// bag nodes) and wraps around, so a playthrough never ends. Both players answer every choice and
+// check at random. The walker does what a player without the compiler would do on every step:
+// resolve handles, scan connectors and curves, and sort the branches.
+#define _POSIX_C_SOURCE 199309L
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core.h"
+#include "story.h"
+
+#define BENCH_BLOCK 10
+#define BENCH_EVENTS 200000         // events timed one by one for the latency percentiles
+
+static double Bench_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+static void Bench_Link(Context *context, Node *from, Node *to) {
+    EdgeStore_Add(&context->edges, context->pool, (BezierCurve){
+        .points = { from->connectors[1].center, from->connectors[1].center, to->connectors[0].center, to->connectors[0].center },
+        .fromNode = NodePool_Handle(from),
+        .toNode = NodePool_Handle(to)
+    });
+}
+
+static Node* Bench_Node(Context *context, Vector2 position, NodeType type, const char *text) {
+    Node *node = CreateNodeAt(position, context);
+    node->type = type;
+    if (text) {
+        size_t length = strlen(text);
+        node->data.defaultNode.text = malloc(length + 1);
+        memcpy(node->data.defaultNode.text, text, length + 1);
+    }
+    return node;
+}
+
+// Blocks of ten, laid out left to right so branches are numbered in target order
+static Node* Bench_BuildStory(Context *context, int nodeCount) {
+    Node **nodes = malloc(nodeCount * sizeof(Node *));
+    static const NodeType block[BENCH_BLOCK] = {
+        NODE_USER_CHOICE, NODE_DEFAULT, NODE_DEFAULT, NODE_RANDOM, NODE_DEFAULT,
+        NODE_STACK, NODE_SKILL_GATE, NODE_DEFAULT, NODE_GO_TO, NODE_RANDOM_BAG
+    };
+    for (int i = 0; i < nodeCount; i++) {
+        Vector2 position = { (float)i * 260.0f, (float)(i % BENCH_BLOCK == 2) * 120.0f };
+        NodeType type = block[i % BENCH_BLOCK];
+        nodes[i] = Bench_Node(context, position, type, type == NODE_DEFAULT ? "The narrator pauses, then carries on." : NULL);
+        if (type == NODE_RANDOM) nodes[i]->data.randomNode.seed = (unsigned int)i;
+        if (type == NODE_RANDOM_BAG) nodes[i]->data.randomBagNode.seed = (unsigned int)i;
+    }
+
+    for (int i = 0; i < nodeCount; i++) {
+        Node *node = nodes[i];
+        Node *next = nodes[(i + 1) % nodeCount];
+        switch (node->type) {
+            case NODE_USER_CHOICE:
+                Bench_Link(context, node, next);
+                Bench_Link(context, node, nodes[(i + 2) % nodeCount]);
+                Bench_Link(context, node, nodes[(i + 4) % nodeCount]);
+                break;
+            case NODE_RANDOM:
+            case NODE_SKILL_GATE:
+                Bench_Link(context, node, next);
+                Bench_Link(context, node, nodes[(i + 2) % nodeCount]);
+                break;
+            case NODE_RANDOM_BAG:
+                Bench_Link(context, node, next);
+                Bench_Link(context, node, nodes[(i + 11) % nodeCount]);
+                Bench_Link(context, node, nodes[(i + 21) % nodeCount]);
+                break;
+            case NODE_STACK:
+                // two short strands that end, then on with the block
+                for (int s = 0; s < 2; s++) {
+                    Node *strand = Bench_Node(context, (Vector2){ node->position.x, 240.0f + s * 120.0f }, NODE_DEFAULT, "An aside.");
+                    node->data.stackNode.next[s] = (Connection){ NodePool_Handle(node), NodePool_Handle(strand) };
+                }
+                Bench_Link(context, node, next);
+                break;
+            default:
+                node->connectors[1].with = (Connection){ NodePool_Handle(node), NodePool_Handle(next) };
+                if (node->type == NODE_DEFAULT) node->data.defaultNode.next = node->connectors[1].with;
+                Bench_Link(context, node, next);
+                break;
+        }
+    }
+
+    Node *start = nodes[0];
+    free(nodes);
+    return start;
+}
+
+static uint32_t Bench_Random(uint32_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Answers what the story waits for, false once it stopped
+static bool Bench_Answer(NarrativeState *state, uint32_t *random) {
+    switch (state->status) {
+        case NARRATIVE_LINE:
+            Narrative_Continue(state);
+            return true;
+        case NARRATIVE_CHOICE:
+        case NARRATIVE_CHECK:
+            Narrative_Choose(state, (int)(Bench_Random(random) % (uint32_t)Narrative_OptionCount(state)));
+            return true;
+        case NARRATIVE_RUNNING:
+            return true;
+        default:
+            return false;   // the block story never ends
+    }
+}
+
+// Plays steps instructions, answering at random, returns the lines shown
+static uint64_t Bench_RunVM(NarrativeState *state, uint64_t steps, uint32_t *random) {
+    uint64_t lines = 0, end = state->steps + steps;
+    while (state->steps < end) {
+        uint64_t left = end - state->steps;
+        if (Narrative_Run(state, left > 1000000 ? 1000000 : (uint32_t)left) == NARRATIVE_LINE) lines++;
+        if (!Bench_Answer(state, random)) break;
+    }
+    return lines;
+}
+
+// The same story played straight off the graph, one node per step
+typedef struct {
+    Node **returns;
+    int depth;
+    int *cursor;    // per pool slot, next strand of a stack node
+} BenchWalker;
+
+static uint64_t Bench_Walk(Context *context, BenchWalker *walker, Node *start, uint64_t steps, uint32_t *random) {
+    Node *successors[MAX_CONNECTORS + 16];
+    uint64_t lines = 0;
+    Node *node = start;
+    for (uint64_t step = 0; step < steps; step++) {
+        int count = Story_Successors(context, node, successors, MAX_CONNECTORS + 16);
+        Node *next = count > 0 ? successors[0] : NULL;
+        unsigned int length;
+        switch (node->type) {
+            case NODE_DEFAULT:
+                if (Node_TextView(node, &length)) lines++;
+                break;
+            case NODE_USER_CHOICE:
+            case NODE_RANDOM:
+            case NODE_RANDOM_BAG:
+            case NODE_SKILL_GATE:
+            case NODE_CONDITIONAL:
+                if (count > 0) next = successors[Bench_Random(random) % (uint32_t)count];
+                break;
+            case NODE_STACK: {
+                int *cursor = &walker->cursor[node->index];
+                int strands = 0;
+                while (strands < 10 && NodePool_Resolve(context->pool, node->data.stackNode.next[strands].to)) strands++;
+                if (*cursor < strands) {
+                    walker->returns[walker->depth++] = node;
+                    next = successors[(*cursor)++];
+                } else {
+                    *cursor = 0;
+                    next = count > strands ? successors[strands] : NULL;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        if (!next && walker->depth > 0) next = walker->returns[--walker->depth];
+        node = next ? next : start;
+    }
+    return lines;
+}
+
+int main(int argc, char **argv) {
+    int nodeCount = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+    long long steps = argc > 3 ? atoll(argv[3]) : 20000000;
+    nodeCount = nodeCount < BENCH_BLOCK ? BENCH_BLOCK : nodeCount / BENCH_BLOCK * BENCH_BLOCK;
+    if (rounds < 1) rounds = 1;
+    if (steps < 1) steps = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    NodePool pool;
+    NodePool_Init(&pool);
+    Context context = { .pool = &pool, .camera = { .zoom = 1.0f } };
+    EdgeStore_Init(&context.edges);
+    SpatialGrid_Init(&context.grid);
+    Node *start = Bench_BuildStory(&context, nodeCount);
+
+    StoryProgram program;
+    double begin = Bench_Now();
+    if (!Story_Compile(&context, start, &program)) return 1;
+    double compileTime = Bench_Now() - begin;
+
+    double *vmTimes = malloc(rounds * sizeof(double));
+    double *walkTimes = malloc(rounds * sizeof(double));
+    uint64_t vmLines = 0, walkLines = 0;
+    uint32_t random = 12345;
+
+    // the game side: only the blob, state in one caller block, no allocation while playing
+    Narrative story;
+    if (!Narrative_Open(&story, program.blob, program.blobSize) || !Narrative_Verify(&story)) return 1;
+    size_t memorySize = Narrative_MemorySize(&story);
+    uint32_t *memory = malloc(memorySize + sizeof(uint32_t));
+    NarrativeState state;
+    if (!memory || !Narrative_Start(&state, &story, memory, memorySize, 1)) return 1;
+    for (int r = 0; r < rounds; r++) {
+        begin = Bench_Now();
+        vmLines = Bench_RunVM(&state, (uint64_t)steps, &random);
+        vmTimes[r] = Bench_Now() - begin;
+    }
+
+    unsigned char *save = malloc(Narrative_SaveBound(&story));
+    uint32_t *loadedMemory = malloc(memorySize + sizeof(uint32_t));
+    NarrativeState loaded;
+    if (!save || !loadedMemory) return 1;
+
+    // one Narrative_Run per event, as a game calls it once a frame at most
+    double *latencies = malloc(BENCH_EVENTS * sizeof(double));
+    for (int e = 0; e < BENCH_EVENTS; e++) {
+        begin = Bench_Now();
+        Narrative_Run(&state, UINT32_MAX);
+        latencies[e] = Bench_Now() - begin;
+        if (!Bench_Answer(&state, &random)) return 1;
+    }
+    qsort(latencies, BENCH_EVENTS, sizeof(double), CompareDouble);
+
+    // a new playthrough on used memory: Start clears it, Restart only bumps the generation
+    begin = Bench_Now();
+    for (int i = 0; i < 100; i++) Narrative_Start(&loaded, &story, loadedMemory, memorySize, (uint32_t)i);
+    double startTime = (Bench_Now() - begin) / 100;
+    begin = Bench_Now();
+    for (int i = 0; i < 100000; i++) Narrative_Restart(&loaded, (uint32_t)i);
+    double restartTime = (Bench_Now() - begin) / 100000;
+
+    // a save only holds what moved: early in a playthrough that is little, after millions of
+    // steps every random, bag and stack node of the story has been visited
+    if (!Narrative_Start(&loaded, &story, loadedMemory, memorySize, 2)) return 1;
+    for (int e = 0; e < 100; e++) {
+        Narrative_Run(&loaded, UINT32_MAX);
+        Bench_Answer(&loaded, &random);
+    }
+    size_t earlySize = Narrative_Save(&loaded, save, Narrative_SaveBound(&story));
+    size_t saveSize = Narrative_Save(&state, save, Narrative_SaveBound(&story));
+    bool reloads = Narrative_Load(&loaded, &story, loadedMemory, memorySize, save, saveSize);
+
+    BenchWalker walker = {
+        .returns = malloc(pool.liveCount * sizeof(Node *)),
+        .cursor = calloc(NodePool_SlotCount(&pool), sizeof(int))
+    };
+    for (int r = 0; r < rounds; r++) {
+        begin = Bench_Now();
+        walkLines = Bench_Walk(&context, &walker, start, (uint64_t)steps, &random);
+        walkTimes[r] = Bench_Now() - begin;
+    }
+
+    qsort(vmTimes, rounds, sizeof(double), CompareDouble);
+    qsort(walkTimes, rounds, sizeof(double), CompareDouble);
+    double vmMedian = vmTimes[rounds / 2], walkMedian = walkTimes[rounds / 2];
+
+    printf("story: %d nodes, %u code words (%u bytes), %u bytes of text, blob %u bytes, compiled in %.3f ms\n",
+           pool.liveCount, story.codeWords, story.codeWords * 4u, story.stringBytes, program.blobSize, compileTime * 1000.0);
+    printf("runtime memory %zu bytes, save after 100 events %zu bytes, after the rounds %zu bytes (%s), bound %zu\n",
+           memorySize, earlySize, saveSize, reloads ? "reloads" : "does not reload", Narrative_SaveBound(&story));
+    printf("event latency: p50 %.0f ns  p99 %.0f ns  p99.9 %.0f ns  max %.1f us  (%d events)\n",
+           latencies[BENCH_EVENTS / 2] * 1e9, latencies[BENCH_EVENTS * 99 / 100] * 1e9,
+           latencies[BENCH_EVENTS * 999 / 1000] * 1e9, latencies[BENCH_EVENTS - 1] * 1e6, BENCH_EVENTS);
+    printf("new playthrough: Narrative_Start %.1f us, Narrative_Restart %.1f ns\n", startTime * 1e6, restartTime * 1e9);
+    printf("vm:     %.1f M steps/s  %.2f M lines/s  (median of %d rounds, %lld steps each)\n",
+           steps / vmMedian / 1e6, vmLines / vmMedian / 1e6, rounds, steps);
+    printf("walker: %.1f M steps/s  %.2f M lines/s\n",
+           steps / walkMedian / 1e6, walkLines / walkMedian / 1e6);
+    printf("lines per second, vm / walker: %.1fx\n", (vmLines / vmMedian) / (walkLines / walkMedian));
+
+    free(memory);
+    free(loadedMemory);
+    free(save);
+    free(latencies);
+    Story_Free(&program);
+    free(walker.returns);
+    free(walker.cursor);
+    free(vmTimes);
+    free(walkTimes);
+    for (Node *node = context.zHead; node; node = node->nextZ) {
+        if (node->type == NODE_DEFAULT) free(node->data.defaultNode.text);
+    }
+    SpatialGrid_Destroy(&context.grid);
+    EdgeStore_Destroy(&context.edges);
+    NodePool_Destroy(&pool);
+    free(context.visibleNodes);
+    free(context.membershipQueue);
+    return 0;
+}
@@ -1,155 +1,30 @@
-#define RAYGUI_IMPLEMENTATION
-#define RAYGUI_SUPPORT_ICONS
 #include "raylib.h"
-#include "raygui.h"
 #include "raymath.h"
 #include <float.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "core.h"
-#include "ui.h"
+#include "project.h"
+#include "autosave.h"
+#include "journal.h"
+#include "projecttext.h"
+#include "scenestore.h"
+#include "story.h"
+#include "profiler.h"
 
 
 Font globalFont;
 
-int main(void)
-{
-    ScreenSettings screen = {.width = 1280, .height = 720, .currentSize = SCREEN_SMALL, .currentView = VIEW_MODE_NODE};
-
-    InitWindow(screen.width, screen.height, "Node Prose - node based videogame narrative authoring tool");
-    globalFont = LoadFont("resources/LSANSD.ttf");
-    GuiSetFont(globalFont);
-    GuiSetStyle(DEFAULT, TEXT_SIZE, 18);
-    EnableCursor();
-    SetTargetFPS(60);
-    
-    Node nodes[MAX_NODES] = {0};  // zero-initialize the node array
-    for (int i = 0; i < MAX_NODES; i++) {
-        nodes[i].type = NODE_COUNT;  // mark all as unused
-    }
-    
-    Node *head = &nodes[0];  
-    
-    //intitial clean context
-    Context context = {
-        .nodes = nodes,
-        .isDragging = false,
-        .draggedNode = NULL,
-        .dragOffset = {0},
-        .lastClickTime = 0,
-        .head = &head,
-        .dragStartTime = 0,
-        .dragCandidateNode = NULL,
-        .bringToFront = NULL,
-        .connecting = false,
-        .connectionStart = {0},
-        .bezier = {{0},{0},{0},{0}},
-        .connectingFromNode = NULL,
-        .connectingFromConnectorIndex = -1,
-        .hoveredInputNode = NULL,
-        .hoveredInputConnectorIndex = -1,
-        .bezierCount = 0,
-        .sceneList = {.count = 0},          // no scenes yet
-        .isDrawingScene = false,            // not currently drawing
-        .sceneStartPos = {0, 0},            // initial mouse origin (irrelevant at boot)
-        .draggedScene = NULL,
-        .sceneDragOffset = {0, 0},
-        .isResizingScene = false,
-        .isResizingSceneVertically = false,
-        .resizingScene = NULL,
-        .initialSceneWidth = 0,
-        .initialSceneHeight = 0,
-        .resizeStartX = 0,
-        .resizeStartY = 0
-    };
-    
-    CreateInitialScene(&context);
-    
-    //initial node for testing
-        head->position = (Vector2){ 200, 200 };
-        head->width = 200;
-        head->height = 60;
-        head->nextZ = NULL;
-        head->isExpanded = false;
-        head->type = NODE_DEFAULT;
-        strcpy(head->id, "AAAA0001");
-        RegisterBasicConnectors(head);
-        
-
-    while (!WindowShouldClose())
-    {
-        HandleScreenToggle(&screen);
-        HandleNodeCreationClick(&context, &head, nodes);
-        Behavior_PanCanvas(&context);
-        Behavior_DrawSceneOutline(&context); 
-        
-        
-        
-        DispatchNodeBehaviors(head, &context);
-        
-        UpdateSceneNodeMembership(&context);
-        
-        
-
-        BeginDrawing();
-            ClearBackground(ORANGE);
-            DrawBackground(&screen);
-            
-            if (screen.currentView == VIEW_MODE_NODE) {
-            
-                DrawSceneOutlines(&context);
-                DrawAllNodes(head, &context);
-                DrawPermanentConnections(&context);
-                DrawTopNodeAndConnections(head, &context);
-                DrawLiveBezier(&context);
-            
-            } else if (screen.currentView == VIEW_MODE_SCRIPT) {
-                DrawText("SCRIPT VIEW (not implemented yet)", 50, 100, 28, DARKGRAY);
-            }
-           
-           
-            DrawMenuBar(&screen);
-        EndDrawing();
-    }
-
-    UnloadFont(globalFont);
-    CloseWindow();
-    return 0;
-}
-
-
-
-
-
-//Screen F1 toggle function
-void HandleScreenToggle(ScreenSettings *screen){
-    if (IsKeyPressed(KEY_F1))
-    {
-        if (screen->currentSize == SCREEN_SMALL) {
-            screen->width = 1920;
-            screen->height = 1080;
-            screen->currentSize = SCREEN_LARGE;
-        } else {
-            screen->width = 1280;
-            screen->height = 720;
-            screen->currentSize = SCREEN_SMALL;
-        }
-
-        SetWindowSize(screen->width, screen->height);
-
-        Vector2 screenCenter = {
-            (GetMonitorWidth(0) - screen->width) / 2.0f,
-            (GetMonitorHeight(0) - screen->height) / 2.0f
-        };
-        SetWindowPosition((int)screenCenter.x, (int)screenCenter.y);
-    }
-}
-
 // Draw Scene behaviour
 void Behavior_DrawSceneOutline(Context *context) {
-    Vector2 mouse = GetMousePosition();
+    Vector2 mouse = context->mouseWorld;
 
     // === Begin Scene Draw on Right-Click ===
-    if (!context->isDrawingScene && IsMouseButtonPressed(MOUSE_RIGHT_BUTTON)) {
+    if (!context->isDrawingScene && Input_Pressed(context, MOUSE_RIGHT_BUTTON)) {
         // Pre-check if mouse is inside any existing scene → block drawing start
         for (int i = 0; i < context->sceneList.count; i++) {
             if (CheckCollisionPointRec(mouse, context->sceneList.scenes[i].bounds)) {
@@ -162,7 +37,7 @@ void Behavior_DrawSceneOutline(Context *context) {
     }
 
     // === Finalize Scene Creation ===
-    if (context->isDrawingScene && IsMouseButtonReleased(MOUSE_RIGHT_BUTTON)) {
+    if (context->isDrawingScene && Input_Released(context, MOUSE_RIGHT_BUTTON)) {
         Vector2 end = mouse;
         Vector2 topLeft = {
             fminf(context->sceneStartPos.x, end.x),
@@ -188,6 +63,7 @@ void Behavior_DrawSceneOutline(Context *context) {
             context->sceneList.scenes[context->sceneList.count++] = (SceneOutline){
                 .bounds = newBounds
             };
+            MarkSceneMembershipDirty(&context->sceneList.scenes[context->sceneList.count - 1], context);
         }
 
         context->isDrawingScene = false;
@@ -210,18 +86,18 @@ void Behavior_Drag(Node *node, Context *context) {
         nodeHeight
     };
 
-    Vector2 mouse = GetMousePosition();
-    double now = GetTime();
+    Vector2 mouse = context->mouseWorld;
+    double now = context->input.time;
 
     // Step 1: Begin drag
     if (!context->isDragging) {
-        if (CheckCollisionPointRec(mouse, bounds) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+        if (CheckCollisionPointRec(mouse, bounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
             context->dragCandidateNode = node;
             context->dragStartTime = now;
             context->bringToFront = node;
         }
 
-        if (context->dragCandidateNode == node && IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+        if (context->dragCandidateNode == node && Input_Down(context, MOUSE_LEFT_BUTTON)) {
             if ((now - context->dragStartTime) >= 0.09) {
                 context->isDragging = true;
                 context->draggedNode = node;
@@ -230,34 +106,38 @@ void Behavior_Drag(Node *node, Context *context) {
             }
         }
 
-        if (context->dragCandidateNode == node && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
+        if (context->dragCandidateNode == node && Input_Released(context, MOUSE_LEFT_BUTTON)) {
             context->dragCandidateNode = NULL;
         }
     }
 
     // Step 2: Active dragging
     if (context->isDragging && context->draggedNode == node) {
-        if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+        if (Input_Down(context, MOUSE_LEFT_BUTTON)) {
+            NodePool_Touch(context->pool, node);
             node->position = Vector2Subtract(mouse, context->dragOffset);
             UpdateConnectorPositions(node);
 
-            // Update connected bezier curves
-            for (int j = 0; j < MAX_BEZIERS; j++) {
-                BezierCurve *curve = &context->permanentBeziers[j];
+            // Update connected bezier curves, only the ones in this node's incidence list
+            for (int ref = node->firstEdge; ref != -1; ) {
+                EdgeStore_Touch(&context->edges, EDGE_REF_INDEX(ref));
+                BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+                int side = EDGE_REF_SIDE(ref);
 
-                if (node == curve->fromNode) {
+                if (side == 0) {
                     Vector2 start = node->position;
                     Vector2 start2 = Vector2Add(start, curve->relativeposition[0]);
                     curve->points[0] = start2;
                     curve->points[1] = (Vector2){ start2.x + 50, start2.y };
-                }
-
-                if (node == curve->toNode) {
+                } else {
                     Vector2 end = node->position;
                     Vector2 end2 = Vector2Add(end, curve->relativeposition[1]);
                     curve->points[2] = (Vector2){ end2.x - 50, end2.y };
                     curve->points[3] = end2;
                 }
+
+                EdgeStore_UpdateBounds(&context->edges, EDGE_REF_INDEX(ref));
+                ref = curve->nextEdge[side];
             }
 
             // 🔁 Scene-aware directional snap logic
@@ -298,18 +178,20 @@ void Behavior_Drag(Node *node, Context *context) {
                 }
             }
 
-            SetMouseCursor(MOUSE_CURSOR_RESIZE_ALL);
+            SpatialGrid_Update(&context->grid, node);
+            context->cursor = MOUSE_CURSOR_RESIZE_ALL;
         } else {
             context->isDragging = false;
             context->draggedNode = NULL;
-            SetMouseCursor(MOUSE_CURSOR_DEFAULT);
+            context->cursor = MOUSE_CURSOR_DEFAULT;
+            MarkNodeMembershipDirty(node, context);
         }
     }
 }
 
 
 // Dispatch of behaviours
-void DispatchNodeBehaviors(Node *head, Context *context) {
+void DispatchNodeBehaviors(Context *context) {
     BehaviorFn behaviors[] = {
         Behavior_Drag,
         Behavior_FocusOnClick,
@@ -320,15 +202,32 @@ void DispatchNodeBehaviors(Node *head, Context *context) {
     };
     const int behaviorCount = sizeof(behaviors) / sizeof(behaviors[0]);
 
-    Node *current = head;
-    while (current != NULL) {
-        // 💥 SKIP deleted nodes before running any behavior
-        if (current->type != NODE_COUNT) {
-            for (int i = 0; i < behaviorCount; i++) {
-                behaviors[i](current, context);
-            }
+    // While a drag is live only the dragged node reacts, wherever the cursor goes
+    if (context->isDragging && context->draggedNode) {
+        Behavior_Drag(context->draggedNode, context);
+        return;
+    }
+
+    // Input goes to the single topmost node under the cursor
+    Node *hit = SpatialGrid_TopNodeAt(&context->grid, context->mouseWorld);
+
+    // A pressed node keeps its drag timer running even if the cursor slipped off it
+    if (context->dragCandidateNode && context->dragCandidateNode != hit) {
+        Behavior_Drag(context->dragCandidateNode, context);
+    }
+
+    // Input hover only lives while the cursor is over that node
+    if (context->hoveredInputNode && context->hoveredInputNode != hit) {
+        context->hoveredInputNode = NULL;
+        context->hoveredInputConnectorIndex = -1;
+    }
+
+    if (hit) {
+        for (int i = 0; i < behaviorCount; i++) {
+            // 💥 STOP once a behavior deleted the node
+            if (hit->type == NODE_COUNT) break;
+            behaviors[i](hit, context);
         }
-        current = current->nextZ;
     }
     
     if (context->bringToFront != NULL) {
@@ -339,8 +238,8 @@ void DispatchNodeBehaviors(Node *head, Context *context) {
 
 // Doubleclick helper function
 bool IsMouseDoubleClick(Context *context) {
-    double currentTime = GetTime();
-    bool clicked = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    double currentTime = context->input.time;
+    bool clicked = Input_Pressed(context, MOUSE_LEFT_BUTTON);
 
     if (clicked && (currentTime - context->lastClickTime) < 0.25) {
         context->lastClickTime = 0; // prevent triple click
@@ -354,119 +253,154 @@ bool IsMouseDoubleClick(Context *context) {
     return false;
 }
 
-//Wrapper for creation new node
-void HandleNodeCreationClick(Context *context, Node **head, Node *nodes) {
-    if (IsMouseDoubleClick(context)) {
-        Vector2 mousePos = GetMousePosition();
+// Visual bounds of a node, expanded nodes are five times as tall
+Rectangle GetNodeBounds(const Node *node) {
+    return (Rectangle){
+        node->position.x,
+        node->position.y,
+        (float)node->width,
+        (float)(node->isExpanded ? node->height * 5 : node->height)
+    };
+}
 
-        // 🔍 Find the topmost node (tail of the Z-stack)
-        Node *topNode = *head;
-        while (topNode && topNode->nextZ) {
-            topNode = topNode->nextZ;
-        }
+// Geometry read from a file: the spatial grid walks every cell a node covers, so a corrupt size
+// or position would hang it (or overflow its cell coordinates) instead of failing the load
+bool Node_ValidGeometry(Vector2 position, long long width, long long height) {
+    return isfinite(position.x) && isfinite(position.y) &&
+           fabsf(position.x) <= WORLD_LIMIT && fabsf(position.y) <= WORLD_LIMIT &&
+           width >= NODE_MIN_SIZE && width <= NODE_MAX_SIZE && height >= NODE_MIN_SIZE && height <= NODE_MAX_SIZE;
+}
 
-        // ✅ Skip creation if mouse is inside the top node's bounds
-        if (topNode) {
-            Rectangle bounds = {
-                topNode->position.x,
-                topNode->position.y,
-                topNode->width,
-                topNode->isExpanded ? topNode->height * 5 : topNode->height
-            };
+// Scene bounds from a file, queried against the same grid
+bool Scene_ValidBounds(Rectangle bounds) {
+    return isfinite(bounds.x) && isfinite(bounds.y) && isfinite(bounds.width) && isfinite(bounds.height) &&
+           fabsf(bounds.x) <= WORLD_LIMIT && fabsf(bounds.y) <= WORLD_LIMIT &&
+           bounds.width >= 0 && bounds.width <= 2 * WORLD_LIMIT && bounds.height >= 0 && bounds.height <= 2 * WORLD_LIMIT;
+}
 
-            if (CheckCollisionPointRec(mousePos, bounds)) {
-                return; // 🔁 Mouse is over top node, abort creation
-            }
+// Saved view: zoomed out past the wheel's range the visible rect covers more grid cells than a
+// frame can walk
+bool Camera_ValidView(Vector2 target, float zoom) {
+    return isfinite(target.x) && isfinite(target.y) &&
+           fabsf(target.x) <= WORLD_LIMIT && fabsf(target.y) <= WORLD_LIMIT &&
+           zoom >= CAMERA_MIN_ZOOM && zoom <= CAMERA_MAX_ZOOM;     // false for NaN as well
+}
+
+// Conservative culling box: a cubic Bézier stays inside the hull of its control points
+void UpdateBezierBounds(BezierCurve *curve) {
+    const float margin = 3.0f;  // stroke thickness
+    float minX = curve->points[0].x, maxX = minX;
+    float minY = curve->points[0].y, maxY = minY;
+
+    for (int i = 1; i < 4; i++) {
+        minX = fminf(minX, curve->points[i].x);
+        maxX = fmaxf(maxX, curve->points[i].x);
+        minY = fminf(minY, curve->points[i].y);
+        maxY = fmaxf(maxY, curve->points[i].y);
+    }
+
+    curve->bounds = (Rectangle){ minX - margin, minY - margin, (maxX - minX) + 2 * margin, (maxY - minY) + 2 * margin };
+}
+
+//Wrapper for creation new node
+void HandleNodeCreationClick(Context *context) {
+    if (IsMouseDoubleClick(context)) {
+        Vector2 mousePos = context->mouseWorld;
+        Vector2 mouseScreen = context->input.mouse;
+
+        // ✅ Skip creation if mouse is inside any node
+        if (SpatialGrid_TopNodeAt(&context->grid, mousePos)) {
+            return; // 🔁 Mouse is over a node, abort creation
         }
 
         // 👍 Safe to create
-        *head = CreateNodeAt(mousePos, *head, nodes, context);
-        SetMousePosition((int)(mousePos.x + 20), (int)(mousePos.y + 20));
+        if (!CreateNodeAt(mousePos, context)) {
+            TraceLog(LOG_WARNING, "NODE: Could not create a node, out of memory at %d nodes", context->pool->liveCount);
+            return;
+        }
+        context->warpMouse = true;
+        context->warpMouseTo = (Vector2){ mouseScreen.x + 20, mouseScreen.y + 20 };
     }
 }
 
 //Create new node logic
-Node* CreateNodeAt(Vector2 position, Node *head, Node *nodes, Context *context) {
-    for (int i = 0; i < MAX_NODES; i++) {
-        Node *slot = &nodes[i];
-
-        if (slot->type == NODE_COUNT) {  // safely detect unused slot
-            memset(slot, 0, sizeof(Node));  // clear all fields just to be safe
-
-            slot->position = position;
-            slot->width = 200;
-            slot->height = 60;
-            slot->type = NODE_DEFAULT;
-            slot->isExpanded = false;
-            GenerateRandomID(slot->id, 8);
-            
-            RegisterBasicConnectors(slot);
-
-            // Insert at front of the list
-            slot->nextZ = head;
-            return slot;  // new head
-        }
-    }
+Node* CreateNodeAt(Vector2 position, Context *context) {
+    Node *slot = NodePool_Alloc(context->pool);
+    if (!slot) return NULL; // fallback: out of memory
+
+    slot->position = position;
+    slot->width = 200;
+    slot->height = 60;
+    slot->type = NODE_DEFAULT;
+    slot->isExpanded = false;
+    GenerateRandomID(slot->id, 8);
+    
+    RegisterBasicConnectors(slot);
 
-    return head; // fallback: no available slot
+    // Insert at front of the list
+    ZList_PushBottom(slot, context);
+    SpatialGrid_Update(&context->grid, slot);
+    MarkNodeMembershipDirty(slot, context);
+    return slot;
 }
 
-// behavior for scene magic wand click
-void Scene_ShrinkClick(SceneOutline *scene, Context *context) {
-    float iconSize = 16.0f;
-    float iconPadding = 4.0f;
-
-    Rectangle wandBounds = {
-        scene->bounds.x + scene->bounds.width - (2 * (iconSize + iconPadding)),
-        scene->bounds.y + iconPadding,
-        iconSize,
-        iconSize
-    };
+// NODE TEXT
+// Text of a loaded project stays inside the file mapping until a node is expanded or edited,
+// so opening a project costs per node, not per byte of dialogue
+const char* Node_TextView(const Node *node, unsigned int *length) {
+    const DefaultNode *data = &node->data.defaultNode;
+    if (node->type != NODE_DEFAULT) {
+        *length = 0;
+        return NULL;
+    }
+    if (data->text) {
+        *length = (unsigned int)strlen(data->text);
+        return data->text;
+    }
+    *length = data->mappedText ? data->mappedLength : 0;
+    return data->mappedText;
+}
 
-    Vector2 mouse = GetMousePosition();
+// Copies mapped text into owned, editable storage. Returns the editable text (NULL when empty).
+char* Node_MaterializeText(Node *node) {
+    DefaultNode *data = &node->data.defaultNode;
+    if (node->type != NODE_DEFAULT || data->text || !data->mappedText) return data->text;
 
-       
-    // === Hover feedback ===
-    bool isHovered = CheckCollisionPointRec(mouse, wandBounds);
-    Color bg = isHovered ? LIME : DARKGREEN;
-    if (context->draggedNode || context->draggedScene != NULL) bg = DARKGREEN;
-    DrawRectangleRec(wandBounds, bg);
-    GuiDrawIcon(ICON_LASER, (int)wandBounds.x, (int)wandBounds.y, 1, WHITE);
+    char *text = malloc(data->mappedLength + 1);
+    if (!text) return NULL;
+    memcpy(text, data->mappedText, data->mappedLength);
+    text[data->mappedLength] = '\0';
 
+    data->text = text;
+    data->mappedText = NULL;
+    data->mappedLength = 0;
+    return text;
+}
 
+// behavior for scene magic wand click
+void Scene_ShrinkClick(SceneOutline *scene, Context *context) {
+    Rectangle wandBounds = GetSceneIconBounds(scene, SCENE_ICON_SHRINK);
 
-    // === Click logic ===
-    if (isHovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
+    if (CheckCollisionPointRec(context->mouseWorld, wandBounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON) &&
     !context->draggedNode && !context->draggedScene) {
-        ShrinkSceneToFitContent(scene);
+        ShrinkSceneToFitContent(scene, context);
+        MarkSceneMembershipDirty(scene, context);
     }
 }
 
 void Scene_DeleteClick(SceneOutline *scene, Context *context) {
-    float iconSize = 16.0f;
-    float iconPadding = 4.0f;
-    
-    Rectangle xBounds = {
-        scene->bounds.x + scene->bounds.width - iconSize - iconPadding,
-        scene->bounds.y + iconPadding,
-        iconSize,
-        iconSize
-    };  
-
-    Vector2 mouse = GetMousePosition();
-    
-    // === Hover feedback ===
-    bool isHovered = CheckCollisionPointRec(mouse, xBounds);
-    Color bg = isHovered ? LIME : DARKGREEN;
-     if (context->draggedNode || context->draggedScene != NULL) bg = DARKGREEN;
-    DrawRectangleRec(xBounds, bg);
-    GuiDrawIcon(ICON_CROSS_SMALL, (int)xBounds.x, (int)xBounds.y, 1, WHITE);
+    Rectangle xBounds = GetSceneIconBounds(scene, SCENE_ICON_DELETE);
 
-    
-    if (isHovered && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
+    if (CheckCollisionPointRec(context->mouseWorld, xBounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON) &&
     !context->draggedNode && !context->draggedScene) {
+        // An unloaded scene's nodes only live in its chunk, which the next save drops with the scene
+        if (!SceneStore_Require(context, scene)) {
+            TraceLog(LOG_WARNING, "SCENES: Scene \"%s\" could not be loaded, not deleting it", scene->name);
+            return;
+        }
         for (int i = 0; i < context->sceneList.count; i++) {
             if (&context->sceneList.scenes[i] == scene) {
+                SceneOutline_Free(scene);
                 for (int j = i; j < context->sceneList.count - 1; j++) {
                     context->sceneList.scenes[j] = context->sceneList.scenes[j + 1];
                 }
@@ -477,6 +411,240 @@ void Scene_DeleteClick(SceneOutline *scene, Context *context) {
     }
 }
 
+// Scene dragging by the name bar, resizing by the right and bottom edges, and the icon clicks.
+// Runs after the node behaviours, the order the draw pass used to handle them in.
+void Behavior_SceneOutlines(Context *context) {
+    Vector2 mouse = context->mouseWorld;
+    bool cursorOverridden = false;
+
+    for (int i = 0; i < context->sceneList.count; i++) {
+        SceneOutline *scene = &context->sceneList.scenes[i];
+
+        // Off-screen scenes cannot be under the cursor, skip them unless they are being dragged or resized
+        if (!CheckCollisionRecs(GetSceneCullBounds(scene), context->viewWorld) &&
+            context->draggedScene != scene && context->resizingScene != scene) continue;
+
+        float iconSize = 16.0f;
+        float iconPadding = 4.0f;
+        char labelBuffer[64];
+        Rectangle labelBar = GetSceneLabelBounds(scene, labelBuffer, sizeof(labelBuffer));
+        float minSceneWidth = labelBar.width + iconSize + 2 * iconPadding;
+
+        // === Dragging via label ===
+        if (!context->isResizingScene && !context->isResizingSceneVertically &&
+            !context->draggedScene && CheckCollisionPointRec(mouse, labelBar) && (!context->draggedNode)) {
+            context->cursor = MOUSE_CURSOR_RESIZE_ALL;
+            cursorOverridden = true;
+        }
+
+        if (!context->draggedScene && CheckCollisionPointRec(mouse, labelBar) &&
+            Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
+            context->draggedScene = scene;
+            context->sceneDragOffset = Vector2Subtract(mouse, (Vector2){scene->bounds.x, scene->bounds.y});
+        }
+
+        if (context->draggedScene == scene && Input_Down(context, MOUSE_LEFT_BUTTON)) {
+            Vector2 newPos = Vector2Subtract(mouse, context->sceneDragOffset);
+            Rectangle newBounds = {
+                newPos.x,
+                newPos.y,
+                scene->bounds.width,
+                scene->bounds.height
+            };
+
+            // Prevent overlap with other scenes
+            bool overlaps = false;
+            for (int i = 0; i < context->sceneList.count; i++) {
+                SceneOutline *other = &context->sceneList.scenes[i];
+                
+                if (other == scene) continue;
+
+                if (CheckCollisionRecs(newBounds, other->bounds)) {
+                    overlaps = true;
+                    break;
+                }
+            }
+
+            if (!overlaps) {
+                Vector2 oldPos = { scene->bounds.x, scene->bounds.y };
+                Vector2 delta = Vector2Subtract(newPos, oldPos);
+
+                // Move the scene
+                scene->bounds.x = newPos.x;
+                scene->bounds.y = newPos.y;
+
+                // Move all contained nodes and the curve ends attached to them
+                for (int n = 0; n < scene->nodeCount; n++) {
+                    Node *node = NodePool_Resolve(context->pool, scene->containedNodes[n]);
+                    if (!node) continue;  // deleted since the last membership update
+                    NodePool_Touch(context->pool, node);
+                    node->position = Vector2Add(node->position, delta);
+                    UpdateConnectorPositions(node);
+                    SpatialGrid_Update(&context->grid, node);
+
+                    // start side moves points 0-1, end side moves points 2-3
+                    for (int ref = node->firstEdge; ref != -1; ) {
+                        EdgeStore_Touch(&context->edges, EDGE_REF_INDEX(ref));
+                        BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+                        int side = EDGE_REF_SIDE(ref);
+
+                        curve->points[2 * side] = Vector2Add(curve->points[2 * side], delta);
+                        curve->points[2 * side + 1] = Vector2Add(curve->points[2 * side + 1], delta);
+                        EdgeStore_UpdateBounds(&context->edges, EDGE_REF_INDEX(ref));
+                        ref = curve->nextEdge[side];
+                    }
+                }
+            }
+        }
+
+        if (context->draggedScene == scene && Input_Released(context, MOUSE_LEFT_BUTTON)) {
+            context->draggedScene = NULL;
+
+            // the scene landed somewhere new, its members may now touch other scenes
+            MarkSceneMembershipDirty(scene, context);
+            for (int n = 0; n < scene->nodeCount; n++) {
+                Node *node = NodePool_Resolve(context->pool, scene->containedNodes[n]);
+                if (node) MarkNodeMembershipDirty(node, context);
+            }
+        }
+
+        // === Resize logic (unchanged) ===
+        float resizeMargin = 12.0f;
+        float resizeVerticalPadding = 32.0f;
+        float bottomResizeMargin = 12.0f;
+        float bottomHorizontalPadding = 32.0f;
+
+        Rectangle rightEdge = {
+            scene->bounds.x + scene->bounds.width - resizeMargin / 2,
+            scene->bounds.y + resizeVerticalPadding,
+            resizeMargin,
+            scene->bounds.height - 2 * resizeVerticalPadding
+        };
+        bool hoveringRight = CheckCollisionPointRec(mouse, rightEdge);
+
+        if (!context->isDragging && !context->isDrawingScene && !context->draggedNode 
+            && !context->draggedScene && hoveringRight){
+            context->cursor = MOUSE_CURSOR_RESIZE_EW;
+            cursorOverridden = true;
+        }
+
+        if (!context->isResizingScene && hoveringRight && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
+            context->isResizingScene = true;
+            context->resizingScene = scene;
+            context->resizeStartX = mouse.x;
+            context->initialSceneWidth = scene->bounds.width;
+        }
+
+        Rectangle bottomEdge = {
+            scene->bounds.x + bottomHorizontalPadding,
+            scene->bounds.y + scene->bounds.height - bottomResizeMargin / 2,
+            scene->bounds.width - 2 * bottomHorizontalPadding,
+            bottomResizeMargin
+        };
+        bool hoveringBottom = CheckCollisionPointRec(mouse, bottomEdge);
+
+        if (!context->isDragging && !context->isDrawingScene &&
+            !context->draggedNode && !context->draggedScene && hoveringBottom) {
+            context->cursor = MOUSE_CURSOR_RESIZE_NS;
+            cursorOverridden = true;
+        }
+
+        if (!context->isResizingSceneVertically && hoveringBottom && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
+            context->isResizingSceneVertically = true;
+            context->resizingScene = scene;
+            context->resizeStartY = mouse.y;
+            context->initialSceneHeight = scene->bounds.height;
+        }
+
+        Rectangle cornerEdge = {
+            scene->bounds.x + scene->bounds.width - bottomHorizontalPadding / 2,
+            scene->bounds.y + scene->bounds.height - resizeVerticalPadding / 2,
+            bottomHorizontalPadding,
+            resizeVerticalPadding
+        };
+        bool hoveringCorner = CheckCollisionPointRec(mouse, cornerEdge);
+
+        if (!context->isDragging && !context->isDrawingScene &&
+            !context->draggedNode && !context->draggedScene && hoveringCorner) {
+            context->cursor = MOUSE_CURSOR_RESIZE_NWSE;
+            cursorOverridden = true;
+        }
+
+        if (!context->isResizingScene && !context->isResizingSceneVertically &&
+            hoveringCorner && Input_Pressed(context, MOUSE_LEFT_BUTTON) && (!context->draggedNode)) {
+            context->isResizingScene = true;
+            context->isResizingSceneVertically = true;
+            context->resizingScene = scene;
+            context->resizeStartX = mouse.x;
+            context->resizeStartY = mouse.y;
+            context->initialSceneWidth = scene->bounds.width;
+            context->initialSceneHeight = scene->bounds.height;
+        }
+
+        if (context->resizingScene == scene && Input_Down(context, MOUSE_LEFT_BUTTON)) {
+            if (context->isResizingScene) {
+                float deltaX = mouse.x - context->resizeStartX;
+                scene->bounds.width = fmaxf(context->initialSceneWidth + deltaX, minSceneWidth);
+            }
+            if (context->isResizingSceneVertically) {
+                float deltaY = mouse.y - context->resizeStartY;
+                scene->bounds.height = fmaxf(context->initialSceneHeight + deltaY, 40);
+            }
+        }
+
+        if ((context->isResizingScene || context->isResizingSceneVertically) &&
+            context->resizingScene == scene && Input_Released(context, MOUSE_LEFT_BUTTON)) {
+            context->isResizingScene = false;
+            context->isResizingSceneVertically = false;
+            context->resizingScene = NULL;
+            context->cursor = MOUSE_CURSOR_DEFAULT;
+            MarkSceneMembershipDirty(scene, context);
+        }
+
+        // === Icons ===
+        Scene_ShrinkClick(scene, context);
+        Scene_DeleteClick(scene, context);
+    }
+
+    // === Cursor Reset ===
+    if (!cursorOverridden && !context->isResizingScene &&
+        !context->isResizingSceneVertically && !context->draggedScene) {
+        context->cursor = MOUSE_CURSOR_DEFAULT;
+    }
+}
+
+// Keeps the live curve on the cursor and drops the connection on a click that neither lands
+// on an input connector nor on the node it started from
+void Behavior_LiveConnection(Context *context) {
+    if (!context->connecting) return;
+
+    Vector2 start = context->connectionStart;
+    Vector2 end = context->mouseWorld;
+
+    context->bezier[0] = start;
+    context->bezier[1] = (Vector2){start.x + 50, start.y};
+    context->bezier[2] = (Vector2){end.x - 50, end.y};
+    context->bezier[3] = end;
+
+    if (Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
+        bool overInput = (context->hoveredInputNode && context->hoveredInputConnectorIndex >= 0);
+        bool overOrigin = false;
+
+        if (context->connectingFromNode) {
+            overOrigin = CheckCollisionPointRec(context->mouseWorld, GetNodeBounds(context->connectingFromNode));
+        }
+
+        if (!overInput && !overOrigin) {
+            TraceLog(LOG_INFO, "Live connection cancelled: clicked outside input and origin node.");
+            context->connecting = false;
+            context->connectingFromNode = NULL;
+            context->connectingFromConnectorIndex = -1;
+            context->hoveredInputNode = NULL;
+            context->hoveredInputConnectorIndex = -1;
+        }
+    }
+}
+
 
 // delete node behavior function
 void Behavior_DeleteIcon(Node *node, Context *context) {
@@ -490,9 +658,9 @@ void Behavior_DeleteIcon(Node *node, Context *context) {
         size
     };
 
-    Vector2 mouse = GetMousePosition();
+    Vector2 mouse = context->mouseWorld;
 
-    if (CheckCollisionPointRec(mouse, iconBounds) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    if (CheckCollisionPointRec(mouse, iconBounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
         // Signal deletion — set type to NODE_COUNT to mark unused
         DeleteNodeFromList(node, context);
         
@@ -501,68 +669,50 @@ void Behavior_DeleteIcon(Node *node, Context *context) {
 
 //delete node logic function
 void DeleteNodeFromList(Node *target, Context *context) {
-    if (!target || !context || !context->head || !(*context->head) || !context->nodes) return;
+    if (!target || !context || !context->pool || target->type == NODE_COUNT) return;
 
-    Node *head = *context->head;
-    Node *nodes = context->nodes;
+    NodePool *pool = context->pool;
+    NodePool_Touch(pool, target);
 
-    // === 1. Remove from Z-stack linked list ===
-    if (head == target) {
-        *context->head = target->nextZ;
-    } else {
-        Node *prev = head;
-        while (prev->nextZ && prev->nextZ != target) {
-            prev = prev->nextZ;
-        }
-        if (prev->nextZ == target) {
-            prev->nextZ = target->nextZ;
-        } else {
-            return; // Not found
-        }
-    }
+    // === 1. Remove from Z-stack linked list and the hit-test grid ===
+    ZList_Unlink(target, context);
+    SpatialGrid_Remove(&context->grid, target);
 
     // === 2. Cancel drag if active ===
     if (context->draggedNode == target) {
         context->isDragging = false;
         context->draggedNode = NULL;
-        SetMouseCursor(MOUSE_CURSOR_DEFAULT);
+        context->cursor = MOUSE_CURSOR_DEFAULT;
+    }
+    if (context->dragCandidateNode == target) context->dragCandidateNode = NULL;
+    if (context->bringToFront == target) context->bringToFront = NULL;
+    if (context->hoveredInputNode == target) {
+        context->hoveredInputNode = NULL;
+        context->hoveredInputConnectorIndex = -1;
+    }
+    if (context->connectingFromNode == target) {
+        context->connecting = false;
+        context->connectingFromNode = NULL;
+        context->connectingFromConnectorIndex = -1;
     }
 
     // === 3. Remove Bézier connections involving this node ===
-    for (int i = 0; i < context->bezierCount; i++) {
-        BezierCurve *curve = &context->permanentBeziers[i];
-        if (curve->fromNode == target || curve->toNode == target) {
-            // Shift remaining left
-            for (int j = i; j < context->bezierCount - 1; j++) {
-                context->permanentBeziers[j] = context->permanentBeziers[j + 1];
-            }
-            context->bezierCount--;
-            i--; // Recheck current index
-        }
+    // O(degree): walk the node's own incidence list, each removal is a swap-remove
+    while (target->firstEdge != -1) {
+        EdgeStore_Remove(&context->edges, pool, EDGE_REF_INDEX(target->firstEdge));
     }
 
-    // === 4. Nullify references TO this node from other nodes ===
-    for (int i = 0; i < MAX_NODES; i++) {
-        Node *n = &nodes[i];
-        if (n->type == NODE_COUNT) continue;
-
-        for (int c = 0; c < MAX_CONNECTORS; c++) {
-            if (n->connectors[c].with.from == target) {
-                n->connectors[c].with.from = NULL;
-            }
-            if (n->connectors[c].with.to == target) {
-                n->connectors[c].with.to = NULL;
-            }
-        }
-    }
+    // === 4. Leave every scene, membership bits are keyed by slot index ===
+    RemoveNodeFromScenes(target, context);
 
-    // === 5. Clear the node’s own connectors ===
-    for (int c = 0; c < MAX_CONNECTORS; c++) {
-        target->connectors[c].with.from = NULL;
-        target->connectors[c].with.to = NULL;
-    }
+    // === 5. References TO this node (connectors, scenes) are handles ===
+    // NodePool_Free bumps the slot generation, so they resolve to NULL without a scan
 
-    // === 6. Mark node as unused ===
+    // === 6. Mark node as unused and hand the slot back to the pool ===
+    // connectors are cleared here, so the node drops its own references too
+    if (target->type == NODE_DEFAULT) Autosave_ReleaseText(context, target->data.defaultNode.text);
+    target->data.defaultNode.text = NULL;
+    target->data.defaultNode.mappedText = NULL;
     target->type = NODE_COUNT;
     target->nextZ = NULL;
     target->width = 0;
@@ -570,6 +720,7 @@ void DeleteNodeFromList(Node *target, Context *context) {
     target->position = (Vector2){0, 0};
     target->behavior.top = 0;
     memset(target->connectors, 0, sizeof(target->connectors));
+    NodePool_Free(pool, target);
 }
 
 // Gear icon behavior function
@@ -584,10 +735,13 @@ void Behavior_CogIcon(Node *node, Context *context) {
         size
     };
 
-    Vector2 mouse = GetMousePosition();
+    Vector2 mouse = context->mouseWorld;
 
-    if (CheckCollisionPointRec(mouse, iconBounds) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        // Cycle node type
+    if (CheckCollisionPointRec(mouse, iconBounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
+        // Cycle node type. The union payload belongs to the old type, start the new one clean
+        NodePool_Touch(context->pool, node);
+        if (node->type == NODE_DEFAULT) Autosave_ReleaseText(context, node->data.defaultNode.text);
+        memset(&node->data, 0, sizeof(node->data));
         node->type = (node->type + 1) % NODE_COUNT;
     }
 }
@@ -604,10 +758,14 @@ void Behavior_ExpandIcon(Node *node, Context *context) {
         size
     };
 
-    Vector2 mouse = GetMousePosition();
+    Vector2 mouse = context->mouseWorld;
 
-    if (CheckCollisionPointRec(mouse, iconBounds) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    if (CheckCollisionPointRec(mouse, iconBounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
+        NodePool_Touch(context->pool, node);
         node->isExpanded = !node->isExpanded;
+        if (node->isExpanded && node->type == NODE_DEFAULT) Node_MaterializeText(node);
+        SpatialGrid_Update(&context->grid, node);
+        MarkNodeMembershipDirty(node, context);
     }
 }
 
@@ -620,79 +778,781 @@ void Behavior_FocusOnClick(Node *node, Context *context) {
         (float)(node->isExpanded ? node->height * 5 : node->height)
     };
 
-    if (CheckCollisionPointRec(GetMousePosition(), bounds) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+    if (CheckCollisionPointRec(context->mouseWorld, bounds) && Input_Pressed(context, MOUSE_LEFT_BUTTON)) {
         context->bringToFront = node;
     }
 }
 
 // Bring node to top function
 void BringNodeToTop(Node *target, Context *context) {
-    if (!target || !context || !context->head || !(*context->head)) return;
+    if (!target || !context || target->type == NODE_COUNT) return;
+    if (context->zTail == target) return;  // already last
 
-    Node *head = *context->head;
+    ZList_Unlink(target, context);
+    ZList_PushTop(target, context);
+}
 
-    if (head == target && target->nextZ == NULL) return;  // already last
+// Z-LIST: O(1) helpers, head and tail live in the context so no walk is needed
+void ZList_PushBottom(Node *node, Context *context) {
+    NodePool_Touch(context->pool, node);
+    node->zKey = --context->zBottomKey;
+    node->prevZ = NULL;
+    node->nextZ = context->zHead;
+    if (context->zHead) context->zHead->prevZ = node;
+    else context->zTail = node;
+    context->zHead = node;
+}
 
-    // Unlink target
-    if (head == target) {
-        *context->head = target->nextZ;
-    } else {
-        Node *prev = head;
-        while (prev->nextZ && prev->nextZ != target) {
-            prev = prev->nextZ;
-        }
-        if (prev->nextZ == target) {
-            prev->nextZ = target->nextZ;
-        } else {
-            return; // not found (shouldn't happen)
-        }
+void ZList_PushTop(Node *node, Context *context) {
+    NodePool_Touch(context->pool, node);
+    node->zKey = ++context->zTopKey;
+    node->nextZ = NULL;
+    node->prevZ = context->zTail;
+    if (context->zTail) context->zTail->nextZ = node;
+    else context->zHead = node;
+    context->zTail = node;
+}
+
+void ZList_Unlink(Node *node, Context *context) {
+    if (node->prevZ) node->prevZ->nextZ = node->nextZ;
+    else if (context->zHead == node) context->zHead = node->nextZ;
+    if (node->nextZ) node->nextZ->prevZ = node->prevZ;
+    else if (context->zTail == node) context->zTail = node->prevZ;
+    node->nextZ = NULL;
+    node->prevZ = NULL;
+}
+
+
+
+// NODE POOL
+// Adds one chunk and threads its slots onto the free list, existing chunks are never moved
+static bool NodePool_Grow(NodePool *pool) {
+    if (pool->chunkCount == pool->chunkCapacity) {
+        int newCapacity = pool->chunkCapacity ? pool->chunkCapacity * 2 : 8;
+        Node **table = realloc(pool->chunks, newCapacity * sizeof(Node *));
+        if (!table) return false;
+        pool->chunks = table;
+        pool->chunkCapacity = newCapacity;
     }
 
-    // Find tail and insert at the end
-    Node *tail = *context->head;
-    if (!tail) {
-        *context->head = target;
-        target->nextZ = NULL;
-        return;
+    Node *chunk = calloc(NODE_POOL_CHUNK, sizeof(Node));
+    if (!chunk) return false;
+
+    int base = pool->chunkCount * NODE_POOL_CHUNK;
+    pool->chunks[pool->chunkCount++] = chunk;
+
+    // Push in reverse so the lowest index is handed out first
+    for (int i = NODE_POOL_CHUNK - 1; i >= 0; i--) {
+        chunk[i].type = NODE_COUNT;  // mark as unused
+        chunk[i].index = base + i;
+        chunk[i].generation = 1;     // generation 0 is reserved for empty handles
+        chunk[i].nextFree = pool->freeList;
+        if (pool->freeList) pool->freeList->prevFree = &chunk[i];
+        pool->freeList = &chunk[i];
     }
+    return true;
+}
+
+// Allocates the first chunk so the editor starts with room for NODE_POOL_CHUNK nodes
+bool NodePool_Init(NodePool *pool) {
+    *pool = (NodePool){0};
+    return NodePool_Grow(pool);
+}
 
-    while (tail->nextZ) {
-        tail = tail->nextZ;
+void NodePool_Destroy(NodePool *pool) {
+    for (int i = 0; i < pool->chunkCount; i++) {
+        free(pool->chunks[i]);
     }
+    free(pool->chunks);
+    free(pool->changedSlots);
+    free(pool->removedKeys);
+    *pool = (NodePool){0};
+}
 
-    tail->nextZ = target;
-    target->nextZ = NULL;
+// Pops a cleared slot from the free list, grows the pool when it runs dry
+Node* NodePool_Alloc(NodePool *pool) {
+    if (!pool->freeList && !NodePool_Grow(pool)) return NULL;
+
+    Node *slot = pool->freeList;
+    NodePool_Touch(pool, slot);
+    pool->freeList = slot->nextFree;
+    if (pool->freeList) pool->freeList->prevFree = NULL;
+
+    int index = slot->index;
+    unsigned int generation = slot->generation;
+    bool changeQueued = slot->changeQueued;
+    memset(slot, 0, sizeof(Node));  // clear all fields just to be safe
+    slot->index = index;
+    slot->generation = generation;
+    slot->changeQueued = changeQueued;  // the slot may still sit in changedSlots
+    slot->saveKey = ++pool->lastSaveKey;
+    slot->firstEdge = -1;
+    slot->type = NODE_COUNT;        // caller decides the real type
+    pool->liveCount++;
+    return slot;
 }
 
+// Returns a slot to the free list, the memory stays inside its chunk.
+// The generation bump invalidates every outstanding handle to the node.
+void NodePool_Free(NodePool *pool, Node *node) {
+    if (!node) return;
+    NodePool_Touch(pool, node);
+
+    // the journal has to tell replay to drop the node, the slot itself may be reused by then
+    if (pool->removedCount == pool->removedCapacity) {
+        int newCapacity = pool->removedCapacity ? pool->removedCapacity * 2 : 64;
+        unsigned int *keys = realloc(pool->removedKeys, newCapacity * sizeof(unsigned int));
+        if (keys) {
+            pool->removedKeys = keys;
+            pool->removedCapacity = newCapacity;
+        }
+    }
+    if (pool->removedCount < pool->removedCapacity) pool->removedKeys[pool->removedCount++] = node->saveKey;
+    else pool->changesLost = true;
+
+    node->type = NODE_COUNT;
+    node->nextZ = NULL;
+    node->prevZ = NULL;
+    if (++node->generation == 0) node->generation = 1;
+    node->prevFree = NULL;
+    node->nextFree = pool->freeList;
+    if (pool->freeList) pool->freeList->prevFree = node;
+    pool->freeList = node;
+    pool->liveCount--;
+}
 
+// Amount of slots (used and unused) the pool has handed out room for
+int NodePool_SlotCount(const NodePool *pool) {
+    return pool->chunkCount * NODE_POOL_CHUNK;
+}
 
-// register connectors
-void RegisterBasicConnectors(Node *node) {
-    float radius = 6.0f;
-    float padding = 4.0f;
+Node* NodePool_At(const NodePool *pool, int index) {
+    return &pool->chunks[index / NODE_POOL_CHUNK][index % NODE_POOL_CHUNK];
+}
 
-    // Input on the left side
-    node->connectors[0] = (Connector){
-        .center = {
-            node->position.x + padding + radius,
-            node->position.y + node->height / 2
-        },
-        .radius = radius,
-        .type = CONNECTOR_INPUT,
-        .parentType = node->type,
-        .with = {0}
-    };
+NodeHandle NodePool_Handle(const Node *node) {
+    if (!node) return (NodeHandle){0};
+    return (NodeHandle){ .index = node->index, .generation = node->generation };
+}
 
-    // Output on the right side
-    node->connectors[1] = (Connector){
-        .center = {
-            node->position.x + node->width - padding - radius,
-            node->position.y + node->height / 2
-        },
-        .radius = radius,
+// O(1) lookup, NULL for empty handles and for nodes that were deleted since the handle was taken
+Node* NodePool_Resolve(const NodePool *pool, NodeHandle handle) {
+    if (handle.generation == 0 || handle.index < 0 || handle.index >= NodePool_SlotCount(pool)) return NULL;
+
+    Node *node = NodePool_At(pool, handle.index);
+    if (node->generation != handle.generation || node->type == NODE_COUNT) return NULL;
+    return node;
+}
+
+// Undo support: takes a freed slot back out of the free list so old handles resolve again.
+// Only succeeds when the slot has not been reused since the handle was taken.
+// The slot comes back with type NODE_COUNT, the caller restores its contents.
+Node* NodePool_Revive(NodePool *pool, NodeHandle handle) {
+    if (handle.generation == 0 || handle.index < 0 || handle.index >= NodePool_SlotCount(pool)) return NULL;
+
+    Node *node = NodePool_At(pool, handle.index);
+    unsigned int releasedGeneration = handle.generation + 1 == 0 ? 1 : handle.generation + 1;
+    if (node->type != NODE_COUNT || node->generation != releasedGeneration) return NULL;
+    NodePool_Touch(pool, node);
+
+    // Unlink from the free list
+    if (node->prevFree) node->prevFree->nextFree = node->nextFree;
+    else pool->freeList = node->nextFree;
+    if (node->nextFree) node->nextFree->prevFree = node->prevFree;
+    node->nextFree = NULL;
+    node->prevFree = NULL;
+
+    node->generation = handle.generation;
+    pool->liveCount++;
+    return node;
+}
+
+// Copy-on-write for background snapshots: call before writing any field that gets saved
+// (position, size, type, payload, text, connections, z-key, generation). While a snapshot is
+// pending, the first write to a chunk keeps a copy of the chunk as it was when the snapshot
+// was taken. Costs one compare otherwise.
+// Also lists the slot for the next journal save.
+void NodePool_Touch(NodePool *pool, Node *node) {
+    int chunk = node->index / NODE_POOL_CHUNK;
+    pool->revision++;
+    NodePool_QueueChange(pool, node);
+
+    if (chunk >= pool->frozenCount || pool->frozen[chunk]) return;
+
+    Node *copy = malloc(NODE_POOL_CHUNK * sizeof(Node));
+    if (!copy) {
+        pool->frozenFailed = true;
+        return;
+    }
+    memcpy(copy, pool->chunks[chunk], NODE_POOL_CHUNK * sizeof(Node));
+    pool->frozen[chunk] = copy;
+}
+
+// Lists the slot for the next journal save, once per slot
+void NodePool_QueueChange(NodePool *pool, Node *node) {
+    if (node->changeQueued) return;
+
+    if (pool->changedCount == pool->changedCapacity) {
+        int newCapacity = pool->changedCapacity ? pool->changedCapacity * 2 : 256;
+        int *slots = realloc(pool->changedSlots, newCapacity * sizeof(int));
+        if (!slots) {
+            pool->changesLost = true;
+            return;
+        }
+        pool->changedSlots = slots;
+        pool->changedCapacity = newCapacity;
+    }
+    pool->changedSlots[pool->changedCount++] = node->index;
+    node->changeQueued = true;
+}
+
+// Forgets the tracked changes, called once they are on disk (or replayed from it)
+void NodePool_ClearChanges(NodePool *pool) {
+    for (int i = 0; i < pool->changedCount; i++) {
+        NodePool_At(pool, pool->changedSlots[i])->changeQueued = false;
+    }
+    pool->changedCount = 0;
+    pool->removedCount = 0;
+    pool->changesLost = false;
+}
+
+// CURVE GRID
+// Same hashing as the spatial grid, over curve indices instead of nodes
+static unsigned int CurveGrid_Hash(int cx, int cy) {
+    return ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+}
+
+static void CurveGrid_Destroy(CurveGrid *grid) {
+    for (int i = 0; i < grid->cellCount; i++) {
+        free(grid->cells[i].items);
+    }
+    free(grid->cells);
+    free(grid->buckets);
+    free(grid->wide);
+    free(grid->entries);
+    *grid = (CurveGrid){0};
+}
+
+static int CurveGrid_FindCell(const CurveGrid *grid, int cx, int cy) {
+    if (grid->bucketCount == 0) return -1;
+
+    int i = grid->buckets[CurveGrid_Hash(cx, cy) & (grid->bucketCount - 1)];
+    while (i != -1 && (grid->cells[i].cx != cx || grid->cells[i].cy != cy)) {
+        i = grid->cells[i].next;
+    }
+    return i;
+}
+
+// Looks a cell up and creates it on first use, cells are never released
+static CurveCell* CurveGrid_Cell(CurveGrid *grid, int cx, int cy) {
+    int i = CurveGrid_FindCell(grid, cx, cy);
+    if (i != -1) return &grid->cells[i];
+
+    if (grid->cellCount == grid->cellCapacity) {
+        int newCapacity = grid->cellCapacity ? grid->cellCapacity * 2 : 256;
+        CurveCell *cells = realloc(grid->cells, newCapacity * sizeof(CurveCell));
+        if (!cells) return NULL;
+        grid->cells = cells;
+        grid->cellCapacity = newCapacity;
+    }
+
+    if (grid->cellCount >= grid->bucketCount) {
+        int newBucketCount = grid->bucketCount ? grid->bucketCount * 2 : 256;
+        int *buckets = realloc(grid->buckets, newBucketCount * sizeof(int));
+        if (!buckets) return NULL;
+        grid->buckets = buckets;
+        grid->bucketCount = newBucketCount;
+
+        for (int b = 0; b < newBucketCount; b++) grid->buckets[b] = -1;
+        for (int c = 0; c < grid->cellCount; c++) {
+            unsigned int b = CurveGrid_Hash(grid->cells[c].cx, grid->cells[c].cy) & (newBucketCount - 1);
+            grid->cells[c].next = grid->buckets[b];
+            grid->buckets[b] = c;
+        }
+    }
+
+    i = grid->cellCount++;
+    unsigned int b = CurveGrid_Hash(cx, cy) & (grid->bucketCount - 1);
+    grid->cells[i] = (CurveCell){ .cx = cx, .cy = cy, .next = grid->buckets[b] };
+    grid->buckets[b] = i;
+    return &grid->cells[i];
+}
+
+static bool CurveGrid_Push(int **items, int *count, int *capacity, int value) {
+    if (*count == *capacity) {
+        int newCapacity = *capacity ? *capacity * 2 : 4;
+        int *grown = realloc(*items, newCapacity * sizeof(int));
+        if (!grown) return false;
+        *items = grown;
+        *capacity = newCapacity;
+    }
+    (*items)[(*count)++] = value;
+    return true;
+}
+
+// Cell range of the bounds, false if they belong in the wide list
+static bool CurveGrid_Range(Rectangle bounds, int *minX, int *minY, int *maxX, int *maxY) {
+    if (!isfinite(bounds.x) || !isfinite(bounds.y) || !isfinite(bounds.width) || !isfinite(bounds.height)) return false;
+    float x0 = floorf(bounds.x / CURVE_GRID_CELL_SIZE), y0 = floorf(bounds.y / CURVE_GRID_CELL_SIZE);
+    float x1 = floorf((bounds.x + bounds.width) / CURVE_GRID_CELL_SIZE), y1 = floorf((bounds.y + bounds.height) / CURVE_GRID_CELL_SIZE);
+    if ((x1 - x0 + 1) * (y1 - y0 + 1) > CURVE_GRID_MAX_CELLS || fabsf(x0) > INT_MAX / 2 || fabsf(y0) > INT_MAX / 2) return false;
+    *minX = (int)x0;
+    *minY = (int)y0;
+    *maxX = (int)x1;
+    *maxY = (int)y1;
+    return true;
+}
+
+static void CurveGrid_Insert(CurveGrid *grid, int index, Rectangle bounds) {
+    CurveGridEntry *entry = &grid->entries[index];
+    *entry = (CurveGridEntry){ .minX = 0, .maxX = -1, .wideSlot = -1 };   // registered nowhere
+
+    int minX, minY, maxX, maxY;
+    if (!CurveGrid_Range(bounds, &minX, &minY, &maxX, &maxY)) {
+        if (CurveGrid_Push(&grid->wide, &grid->wideCount, &grid->wideCapacity, index)) entry->wideSlot = grid->wideCount - 1;
+        return;
+    }
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            CurveCell *cell = CurveGrid_Cell(grid, cx, cy);
+            if (cell) CurveGrid_Push(&cell->items, &cell->count, &cell->capacity, index);
+        }
+    }
+    *entry = (CurveGridEntry){ .minX = minX, .minY = minY, .maxX = maxX, .maxY = maxY, .wideSlot = -1 };
+}
+
+static void CurveGrid_Remove(CurveGrid *grid, int index) {
+    CurveGridEntry *entry = &grid->entries[index];
+    if (entry->wideSlot >= 0) {
+        int last = grid->wide[--grid->wideCount];
+        grid->wide[entry->wideSlot] = last;
+        grid->entries[last].wideSlot = entry->wideSlot;
+    } else {
+        for (int cy = entry->minY; cy <= entry->maxY; cy++) {
+            for (int cx = entry->minX; cx <= entry->maxX; cx++) {
+                int i = CurveGrid_FindCell(grid, cx, cy);
+                if (i == -1) continue;
+
+                CurveCell *cell = &grid->cells[i];
+                for (int k = 0; k < cell->count; k++) {
+                    if (cell->items[k] == index) {
+                        cell->items[k] = cell->items[--cell->count];
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    *entry = (CurveGridEntry){ .minX = 0, .maxX = -1, .wideSlot = -1 };
+}
+
+// The curve at index from was moved to index to by a swap-remove
+static void CurveGrid_Rename(CurveGrid *grid, int from, int to) {
+    CurveGridEntry *entry = &grid->entries[from];
+    if (entry->wideSlot >= 0) {
+        grid->wide[entry->wideSlot] = to;
+    } else {
+        for (int cy = entry->minY; cy <= entry->maxY; cy++) {
+            for (int cx = entry->minX; cx <= entry->maxX; cx++) {
+                int i = CurveGrid_FindCell(grid, cx, cy);
+                if (i == -1) continue;
+
+                CurveCell *cell = &grid->cells[i];
+                for (int k = 0; k < cell->count; k++) {
+                    if (cell->items[k] == from) {
+                        cell->items[k] = to;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    grid->entries[to] = *entry;
+}
+
+// EDGE STORE
+void EdgeStore_Init(EdgeStore *store) {
+    *store = (EdgeStore){0};
+}
+
+void EdgeStore_Destroy(EdgeStore *store) {
+    for (int i = 0; i < store->chunkCount; i++) {
+        free(store->chunks[i]);
+    }
+    free(store->chunks);
+    CurveGrid_Destroy(&store->grid);
+    *store = (EdgeStore){0};
+}
+
+BezierCurve* EdgeStore_At(const EdgeStore *store, int index) {
+    return &store->chunks[index / EDGE_STORE_CHUNK][index % EDGE_STORE_CHUNK];
+}
+
+// Pushes the curve end of one side onto the front of the owner's incidence list
+static void EdgeStore_Link(EdgeStore *store, int index, int side, Node *owner) {
+    BezierCurve *curve = EdgeStore_At(store, index);
+    int ref = EDGE_REF(index, side);
+
+    curve->prevEdge[side] = -1;
+    curve->nextEdge[side] = owner->firstEdge;
+    if (owner->firstEdge != -1) {
+        EdgeStore_At(store, EDGE_REF_INDEX(owner->firstEdge))->prevEdge[EDGE_REF_SIDE(owner->firstEdge)] = ref;
+    }
+    owner->firstEdge = ref;
+    owner->degree++;
+}
+
+static void EdgeStore_Unlink(EdgeStore *store, int index, int side, Node *owner) {
+    BezierCurve *curve = EdgeStore_At(store, index);
+    int prev = curve->prevEdge[side];
+    int next = curve->nextEdge[side];
+
+    if (prev != -1) EdgeStore_At(store, EDGE_REF_INDEX(prev))->nextEdge[EDGE_REF_SIDE(prev)] = next;
+    else owner->firstEdge = next;
+    if (next != -1) EdgeStore_At(store, EDGE_REF_INDEX(next))->prevEdge[EDGE_REF_SIDE(next)] = prev;
+    owner->degree--;
+}
+
+// Appends a curve and links it into both endpoint incidence lists, returns its index or -1
+int EdgeStore_Add(EdgeStore *store, NodePool *pool, BezierCurve curve) {
+    Node *from = NodePool_Resolve(pool, curve.fromNode);
+    Node *to = NodePool_Resolve(pool, curve.toNode);
+    if (!from || !to) return -1;
+
+    if (store->count == store->grid.entryCapacity) {
+        int newCapacity = store->grid.entryCapacity ? store->grid.entryCapacity * 2 : EDGE_STORE_CHUNK;
+        CurveGridEntry *entries = realloc(store->grid.entries, newCapacity * sizeof(CurveGridEntry));
+        if (!entries) return -1;
+        store->grid.entries = entries;
+        store->grid.entryCapacity = newCapacity;
+    }
+    if (store->count == store->chunkCount * EDGE_STORE_CHUNK) {
+        if (store->chunkCount == store->chunkCapacity) {
+            int newCapacity = store->chunkCapacity ? store->chunkCapacity * 2 : 8;
+            BezierCurve **table = realloc(store->chunks, newCapacity * sizeof(BezierCurve *));
+            if (!table) return -1;
+            store->chunks = table;
+            store->chunkCapacity = newCapacity;
+        }
+        BezierCurve *chunk = malloc(EDGE_STORE_CHUNK * sizeof(BezierCurve));
+        if (!chunk) return -1;
+        store->chunks[store->chunkCount++] = chunk;
+    }
+
+    int index = store->count++;
+    EdgeStore_Touch(store, index);
+    UpdateBezierBounds(&curve);
+    *EdgeStore_At(store, index) = curve;
+    EdgeStore_Link(store, index, 0, from);
+    EdgeStore_Link(store, index, 1, to);
+    CurveGrid_Insert(&store->grid, index, curve.bounds);
+    return index;
+}
+
+// After the points of a stored curve changed: new culling box, re-registered where it moved to.
+// Costs no more than the box while the curve stays inside the same cells.
+void EdgeStore_UpdateBounds(EdgeStore *store, int index) {
+    BezierCurve *curve = EdgeStore_At(store, index);
+    UpdateBezierBounds(curve);
+
+    CurveGridEntry *entry = &store->grid.entries[index];
+    int minX, minY, maxX, maxY;
+    if (entry->wideSlot < 0 && CurveGrid_Range(curve->bounds, &minX, &minY, &maxX, &maxY) &&
+        minX == entry->minX && minY == entry->minY && maxX == entry->maxX && maxY == entry->maxY) return;
+    CurveGrid_Remove(&store->grid, index);
+    CurveGrid_Insert(&store->grid, index, curve->bounds);
+}
+
+// Collects every curve whose bounds overlap the area once, growing *out as needed. Returns the amount found.
+int EdgeStore_Query(EdgeStore *store, Rectangle area, int **out, int *capacity) {
+    CurveGrid *grid = &store->grid;
+    int minX = (int)floorf(area.x / CURVE_GRID_CELL_SIZE);
+    int minY = (int)floorf(area.y / CURVE_GRID_CELL_SIZE);
+    int maxX = (int)floorf((area.x + area.width) / CURVE_GRID_CELL_SIZE);
+    int maxY = (int)floorf((area.y + area.height) / CURVE_GRID_CELL_SIZE);
+    unsigned int stamp = ++grid->queryStamp;
+    int found = 0;
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int i = CurveGrid_FindCell(grid, cx, cy);
+            if (i == -1) continue;
+
+            const CurveCell *cell = &grid->cells[i];
+            for (int k = 0; k < cell->count; k++) {
+                int index = cell->items[k];
+                if (grid->entries[index].queryStamp == stamp) continue;  // already reported by a neighbour cell
+                grid->entries[index].queryStamp = stamp;
+                if (!CheckCollisionRecs(area, EdgeStore_At(store, index)->bounds)) continue;
+                if (!CurveGrid_Push(out, &found, capacity, index)) return found;
+            }
+        }
+    }
+    for (int k = 0; k < grid->wideCount; k++) {
+        int index = grid->wide[k];
+        if (!CheckCollisionRecs(area, EdgeStore_At(store, index)->bounds)) continue;
+        if (!CurveGrid_Push(out, &found, capacity, index)) return found;
+    }
+    return found;
+}
+
+// Same copy-on-write contract as NodePool_Touch, for the saved fields of a curve (points, anchors, ends)
+void EdgeStore_Touch(EdgeStore *store, int index) {
+    int chunk = index / EDGE_STORE_CHUNK;
+    if (chunk >= store->frozenChunkCount || store->frozen[chunk]) return;
+
+    BezierCurve *copy = malloc(EDGE_STORE_CHUNK * sizeof(BezierCurve));
+    if (!copy) {
+        store->frozenFailed = true;
+        return;
+    }
+    memcpy(copy, store->chunks[chunk], EDGE_STORE_CHUNK * sizeof(BezierCurve));
+    store->frozen[chunk] = copy;
+}
+
+// O(1) removal: unlink the curve, then move the last curve into its slot and patch its neighbours
+void EdgeStore_Remove(EdgeStore *store, NodePool *pool, int index) {
+    if (index < 0 || index >= store->count) return;
+    EdgeStore_Touch(store, index);
+    EdgeStore_Touch(store, store->count - 1);
+
+    BezierCurve *curve = EdgeStore_At(store, index);
+    Node *from = NodePool_Resolve(pool, curve->fromNode);
+    Node *to = NodePool_Resolve(pool, curve->toNode);
+    if (from) EdgeStore_Unlink(store, index, 0, from);
+    if (to) EdgeStore_Unlink(store, index, 1, to);
+    CurveGrid_Remove(&store->grid, index);
+
+    int last = --store->count;
+    if (index == last) return;
+
+    BezierCurve *moved = EdgeStore_At(store, index);
+    *moved = *EdgeStore_At(store, last);
+    CurveGrid_Rename(&store->grid, last, index);
+
+    // A curve looping back to its own node can point at itself, rename those links first
+    for (int side = 0; side < 2; side++) {
+        if (moved->prevEdge[side] != -1 && EDGE_REF_INDEX(moved->prevEdge[side]) == last) {
+            moved->prevEdge[side] = EDGE_REF(index, EDGE_REF_SIDE(moved->prevEdge[side]));
+        }
+        if (moved->nextEdge[side] != -1 && EDGE_REF_INDEX(moved->nextEdge[side]) == last) {
+            moved->nextEdge[side] = EDGE_REF(index, EDGE_REF_SIDE(moved->nextEdge[side]));
+        }
+    }
+
+    for (int side = 0; side < 2; side++) {
+        Node *owner = NodePool_Resolve(pool, side == 0 ? moved->fromNode : moved->toNode);
+        int prev = moved->prevEdge[side];
+        int next = moved->nextEdge[side];
+
+        if (prev != -1) EdgeStore_At(store, EDGE_REF_INDEX(prev))->nextEdge[EDGE_REF_SIDE(prev)] = EDGE_REF(index, side);
+        else if (owner) owner->firstEdge = EDGE_REF(index, side);
+        if (next != -1) EdgeStore_At(store, EDGE_REF_INDEX(next))->prevEdge[EDGE_REF_SIDE(next)] = EDGE_REF(index, side);
+    }
+}
+
+// SPATIAL GRID
+void SpatialGrid_Init(SpatialGrid *grid) {
+    *grid = (SpatialGrid){0};
+}
+
+void SpatialGrid_Destroy(SpatialGrid *grid) {
+    for (int i = 0; i < grid->cellCount; i++) {
+        free(grid->cells[i].items);
+    }
+    free(grid->cells);
+    free(grid->buckets);
+    *grid = (SpatialGrid){0};
+}
+
+static unsigned int SpatialGrid_Hash(int cx, int cy) {
+    return ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+}
+
+static int SpatialGrid_FindCell(const SpatialGrid *grid, int cx, int cy) {
+    if (grid->bucketCount == 0) return -1;
+
+    int i = grid->buckets[SpatialGrid_Hash(cx, cy) & (grid->bucketCount - 1)];
+    while (i != -1 && (grid->cells[i].cx != cx || grid->cells[i].cy != cy)) {
+        i = grid->cells[i].next;
+    }
+    return i;
+}
+
+// Looks a cell up and creates it on first use, cells are never released so indices stay valid
+static GridCell* SpatialGrid_Cell(SpatialGrid *grid, int cx, int cy) {
+    int i = SpatialGrid_FindCell(grid, cx, cy);
+    if (i != -1) return &grid->cells[i];
+
+    if (grid->cellCount == grid->cellCapacity) {
+        int newCapacity = grid->cellCapacity ? grid->cellCapacity * 2 : 256;
+        GridCell *cells = realloc(grid->cells, newCapacity * sizeof(GridCell));
+        if (!cells) return NULL;
+        grid->cells = cells;
+        grid->cellCapacity = newCapacity;
+    }
+
+    // Keep chains short: rehash once there are more cells than buckets
+    if (grid->cellCount >= grid->bucketCount) {
+        int newBucketCount = grid->bucketCount ? grid->bucketCount * 2 : 256;
+        int *buckets = realloc(grid->buckets, newBucketCount * sizeof(int));
+        if (!buckets) return NULL;
+        grid->buckets = buckets;
+        grid->bucketCount = newBucketCount;
+
+        for (int b = 0; b < newBucketCount; b++) grid->buckets[b] = -1;
+        for (int c = 0; c < grid->cellCount; c++) {
+            unsigned int b = SpatialGrid_Hash(grid->cells[c].cx, grid->cells[c].cy) & (newBucketCount - 1);
+            grid->cells[c].next = grid->buckets[b];
+            grid->buckets[b] = c;
+        }
+    }
+
+    i = grid->cellCount++;
+    unsigned int b = SpatialGrid_Hash(cx, cy) & (grid->bucketCount - 1);
+    grid->cells[i] = (GridCell){ .cx = cx, .cy = cy, .next = grid->buckets[b] };
+    grid->buckets[b] = i;
+    return &grid->cells[i];
+}
+
+// Drops the node from every cell of its registered range
+void SpatialGrid_Remove(SpatialGrid *grid, Node *node) {
+    if (!node->inGrid) return;
+
+    for (int cy = node->gridMinY; cy <= node->gridMaxY; cy++) {
+        for (int cx = node->gridMinX; cx <= node->gridMaxX; cx++) {
+            int i = SpatialGrid_FindCell(grid, cx, cy);
+            if (i == -1) continue;
+
+            GridCell *cell = &grid->cells[i];
+            for (int k = 0; k < cell->count; k++) {
+                if (cell->items[k] == node) {
+                    cell->items[k] = cell->items[--cell->count];
+                    break;
+                }
+            }
+        }
+    }
+    node->inGrid = false;
+}
+
+// (Re)registers the node after it was created, moved or resized.
+// Costs nothing while the node stays inside the same cells, which is the common case when dragging.
+void SpatialGrid_Update(SpatialGrid *grid, Node *node) {
+    Rectangle bounds = GetNodeBounds(node);
+    int minX = (int)floorf(bounds.x / GRID_CELL_SIZE);
+    int minY = (int)floorf(bounds.y / GRID_CELL_SIZE);
+    int maxX = (int)floorf((bounds.x + bounds.width) / GRID_CELL_SIZE);
+    int maxY = (int)floorf((bounds.y + bounds.height) / GRID_CELL_SIZE);
+
+    if (node->inGrid && minX == node->gridMinX && minY == node->gridMinY &&
+        maxX == node->gridMaxX && maxY == node->gridMaxY) return;
+
+    SpatialGrid_Remove(grid, node);
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            GridCell *cell = SpatialGrid_Cell(grid, cx, cy);
+            if (!cell) continue;
+
+            if (cell->count == cell->capacity) {
+                int newCapacity = cell->capacity ? cell->capacity * 2 : 4;
+                Node **items = realloc(cell->items, newCapacity * sizeof(Node *));
+                if (!items) continue;
+                cell->items = items;
+                cell->capacity = newCapacity;
+            }
+            cell->items[cell->count++] = node;
+        }
+    }
+
+    node->gridMinX = minX;
+    node->gridMinY = minY;
+    node->gridMaxX = maxX;
+    node->gridMaxY = maxY;
+    node->inGrid = true;
+}
+
+// Collects every node touching the area once, growing *out as needed. Returns the amount found.
+int SpatialGrid_Query(SpatialGrid *grid, Rectangle area, Node ***out, int *capacity) {
+    int minX = (int)floorf(area.x / GRID_CELL_SIZE);
+    int minY = (int)floorf(area.y / GRID_CELL_SIZE);
+    int maxX = (int)floorf((area.x + area.width) / GRID_CELL_SIZE);
+    int maxY = (int)floorf((area.y + area.height) / GRID_CELL_SIZE);
+    unsigned int stamp = ++grid->queryStamp;
+    int found = 0;
+
+    for (int cy = minY; cy <= maxY; cy++) {
+        for (int cx = minX; cx <= maxX; cx++) {
+            int i = SpatialGrid_FindCell(grid, cx, cy);
+            if (i == -1) continue;
+
+            GridCell *cell = &grid->cells[i];
+            for (int k = 0; k < cell->count; k++) {
+                Node *node = cell->items[k];
+                if (node->queryStamp == stamp) continue;  // already reported by a neighbour cell
+                node->queryStamp = stamp;
+                if (!CheckCollisionRecs(area, GetNodeBounds(node))) continue;
+
+                if (found == *capacity) {
+                    int newCapacity = *capacity ? *capacity * 2 : 256;
+                    Node **items = realloc(*out, newCapacity * sizeof(Node *));
+                    if (!items) return found;
+                    *out = items;
+                    *capacity = newCapacity;
+                }
+                (*out)[found++] = node;
+            }
+        }
+    }
+    return found;
+}
+
+// Topmost node whose bounds contain the point, NULL over empty canvas
+Node* SpatialGrid_TopNodeAt(const SpatialGrid *grid, Vector2 point) {
+    int i = SpatialGrid_FindCell(grid, (int)floorf(point.x / GRID_CELL_SIZE), (int)floorf(point.y / GRID_CELL_SIZE));
+    if (i == -1) return NULL;
+
+    const GridCell *cell = &grid->cells[i];
+    Node *top = NULL;
+    PROFILE_COUNT(PROFILE_COUNTER_HIT_TESTS, cell->count);
+    for (int k = 0; k < cell->count; k++) {
+        Node *node = cell->items[k];
+        if ((!top || node->zKey > top->zKey) && CheckCollisionPointRec(point, GetNodeBounds(node))) {
+            top = node;
+        }
+    }
+    return top;
+}
+
+// register connectors
+void RegisterBasicConnectors(Node *node) {
+    float radius = 6.0f;
+    float padding = 4.0f;
+
+    // Input on the left side
+    node->connectors[0] = (Connector){
+        .center = {
+            node->position.x + padding + radius,
+            node->position.y + node->height / 2
+        },
+        .radius = radius,
+        .type = CONNECTOR_INPUT,
+        .parentType = node->type,
+        .with = {{0}, {0}}
+    };
+
+    // Output on the right side
+    node->connectors[1] = (Connector){
+        .center = {
+            node->position.x + node->width - padding - radius,
+            node->position.y + node->height / 2
+        },
+        .radius = radius,
         .type = CONNECTOR_OUTPUT,
         .parentType = node->type,
-        .with = {0}
+        .with = {{0}, {0}}
     };
 }
 
@@ -717,7 +1577,7 @@ void UpdateConnectorPositions(Node *node) {
 
 // Behaviour on connector click
 void Behavior_ConnectorClick(Node *node, Context *context) {
-    Vector2 mouse = GetMousePosition();
+    Vector2 mouse = context->mouseWorld;
 
     for (int c = 0; c < MAX_CONNECTORS; c++) {
         Connector *conn = &node->connectors[c];
@@ -743,7 +1603,7 @@ void Behavior_ConnectorClick(Node *node, Context *context) {
         // === FINISHING a connection at an INPUT ===
         if (context->connecting &&
             conn->type == CONNECTOR_INPUT &&
-            IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
+            Input_Pressed(context, MOUSE_LEFT_BUTTON) &&
             CheckCollisionPointRec(mouse, hitbox)) {
 
             Node *from = context->connectingFromNode;
@@ -753,32 +1613,31 @@ void Behavior_ConnectorClick(Node *node, Context *context) {
                 Connector *fromConn = &from->connectors[fromIndex];
 
                 // Store connection
-                fromConn->with.to = node;
-                conn->with.from = from;
+                NodePool_Touch(context->pool, from);
+                NodePool_Touch(context->pool, node);
+                fromConn->with.to = NodePool_Handle(node);
+                conn->with.from = NodePool_Handle(from);
                 
                 // === 2. Store permanent Bézier for visual link ===
-                if (context->bezierCount < MAX_BEZIERS) {
-                    
-                    context->permanentBeziers[context->bezierCount++] = (BezierCurve){
-                        .points = {
-                            context->bezier[0],
-                            context->bezier[1],
-                            context->bezier[2],
-                            context->bezier[3]
-                        },
-                        .fromNode = from,
-                        .toNode = node,
-                        .relativeposition = {
-                            {
-                                context->bezier[0].x - from->position.x,
-                                context->bezier[0].y - from->position.y
-                            },{
-                                context->bezier[3].x - node->position.x,
-                                context->bezier[3].y - node->position.y
-                            }
+                EdgeStore_Add(&context->edges, context->pool, (BezierCurve){
+                    .points = {
+                        context->bezier[0],
+                        context->bezier[1],
+                        context->bezier[2],
+                        context->bezier[3]
+                    },
+                    .fromNode = NodePool_Handle(from),
+                    .toNode = NodePool_Handle(node),
+                    .relativeposition = {
+                        {
+                            context->bezier[0].x - from->position.x,
+                            context->bezier[0].y - from->position.y
+                        },{
+                            context->bezier[3].x - node->position.x,
+                            context->bezier[3].y - node->position.y
                         }
-                    };
-                }
+                    }
+                });
 
             }
 
@@ -792,7 +1651,7 @@ void Behavior_ConnectorClick(Node *node, Context *context) {
         // === STARTING a connection from OUTPUT ===
         if (!context->connecting &&
             conn->type == CONNECTOR_OUTPUT &&
-            IsMouseButtonPressed(MOUSE_LEFT_BUTTON) &&
+            Input_Pressed(context, MOUSE_LEFT_BUTTON) &&
             CheckCollisionPointRec(mouse, hitbox)) {
 
             context->connecting = true;
@@ -814,181 +1673,625 @@ void Behavior_ConnectorClick(Node *node, Context *context) {
 
 //full canvas panning
 void Behavior_PanCanvas(Context *context) {
-    Vector2 mouse = GetMousePosition();
+    Vector2 mouse = context->input.mouse;
 
     if (!context->isPanning) {
         // Start panning on Middle Mouse Button
-        if (IsMouseButtonPressed(MOUSE_MIDDLE_BUTTON)) {
+        if (Input_Pressed(context, MOUSE_MIDDLE_BUTTON)) {
             context->isPanning = true;
             context->panStartMouse = mouse;
-            SetMouseCursor(MOUSE_CURSOR_RESIZE_ALL);
+            context->cursor = MOUSE_CURSOR_RESIZE_ALL;
         }
     } else {
         // While holding the middle button
-        if (IsMouseButtonDown(MOUSE_MIDDLE_BUTTON)) {
+        if (Input_Down(context, MOUSE_MIDDLE_BUTTON)) {
             Vector2 delta = Vector2Subtract(mouse, context->panStartMouse);
 
-            // Move nodes
-            Node *current = *(context->head);
-            while (current != NULL) {
-                current->position = Vector2Add(current->position, delta);
-                UpdateConnectorPositions(current);
-                current = current->nextZ;
-            }
+            // Move the camera, not the world: screen delta converted to world units
+            context->camera.target = Vector2Subtract(context->camera.target,
+                                                     Vector2Scale(delta, 1.0f / context->camera.zoom));
 
-            // Move bezier anchors and relative positions
-            for (int i = 0; i < context->bezierCount; i++) {
-                BezierCurve *curve = &context->permanentBeziers[i];
+            context->panStartMouse = mouse;
+        } else {
+            context->isPanning = false;
+            context->cursor = MOUSE_CURSOR_DEFAULT;
+        }
+    }
+}
+
+// mouse wheel zoom, keeps the world point under the cursor in place
+void Behavior_ZoomCanvas(Context *context) {
+    float wheel = context->input.wheel;
+    if (wheel == 0) return;
+
+    Vector2 mouse = context->input.mouse;
+    Vector2 mouseWorld = GetScreenToWorld2D(mouse, context->camera);
+
+    // Anchor the camera at the cursor so zooming pivots around it
+    context->camera.offset = mouse;
+    context->camera.target = mouseWorld;
+    context->camera.zoom = Clamp(context->camera.zoom * expf(0.1f * wheel), CAMERA_MIN_ZOOM, CAMERA_MAX_ZOOM);
+}
+
+// the screen rectangle in world space, everything outside it is culled
+void UpdateVisibleWorldRect(Context *context, int screenWidth, int screenHeight) {
+    Vector2 topLeft = GetScreenToWorld2D((Vector2){0, 0}, context->camera);
+    Vector2 bottomRight = GetScreenToWorld2D((Vector2){(float)screenWidth, (float)screenHeight}, context->camera);
+    context->viewWorld = (Rectangle){ topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y };
+}
+
+static int CompareNodeZ(const void *a, const void *b) {
+    long long za = (*(Node *const *)a)->zKey;
+    long long zb = (*(Node *const *)b)->zKey;
+    return (za > zb) - (za < zb);
+}
+
+// Asks the spatial grid for the on-screen nodes and orders them bottom to top for drawing,
+// and the curve grid for the curves crossing the view
+void CollectVisibleNodes(Context *context) {
+    context->visibleCount = SpatialGrid_Query(&context->grid, context->viewWorld,
+                                              &context->visibleNodes, &context->visibleCapacity);
+    qsort(context->visibleNodes, context->visibleCount, sizeof(Node *), CompareNodeZ);
+    context->visibleCurveCount = EdgeStore_Query(&context->edges, context->viewWorld,
+                                                 &context->visibleCurves, &context->visibleCurveCapacity);
+}
+
+// screen -> world once per frame, every world-space behaviour reads context->mouseWorld
+void UpdateMouseWorldPosition(Context *context) {
+    context->mouseWorld = GetScreenToWorld2D(context->input.mouse, context->camera);
+}
+
+// true while an interaction animates every frame
+static bool NeedsContinuousFrames(const Context *context) {
+    return context->isDragging || context->dragCandidateNode || context->isPanning ||
+           context->connecting || context->isDrawingScene || context->draggedScene ||
+           context->isResizingScene || context->isResizingSceneVertically ||
+           (context->playtest && context->playtest->state.status == NARRATIVE_RUNNING);
+}
+
+// any input since the last poll, each one may change hover states or the graph
+static bool HasFrameInput(const FrameInput *input) {
+    return input->mouseDelta.x != 0 || input->mouseDelta.y != 0 || input->wheel != 0 ||
+           input->buttonsPressed || input->buttonsReleased || input->keyActivity || input->resized;
+}
+
+// Switches between event waiting, slow polling and full frame rate. Returns true if this frame must be drawn.
+bool UpdateRedrawMode(Context *context) {
+    RedrawMode mode = REDRAW_EVENT;
+    if (NeedsContinuousFrames(context)) mode = REDRAW_CONTINUOUS;
+    else if (context->pendingJobs > 0) mode = REDRAW_POLL;
+
+    if (mode != context->redrawMode) {
+        context->redrawMode = mode;
+        context->redrawRequested = true;  // draw the frame that ends the interaction
+    }
+
+    bool redraw = mode == REDRAW_CONTINUOUS || context->redrawRequested || HasFrameInput(&context->input);
+    context->redrawRequested = false;
+    return redraw;
+}
+
+// For changes that do not come from input, e.g. a background job that finished
+void RequestRedraw(Context *context) {
+    context->redrawRequested = true;
+}
+
+// Menu bar buttons, the project always lives next to the executable for now.
+// Once split into a scene store, save and load go through the store instead of the journal.
+void HandleMenuAction(MenuAction action, Context *context) {
+    JournalStats stats = {0};
+    SceneStoreStats scenes = {0};
+    double start = Clock_Seconds();
+
+    if (action == MENU_ACTION_SAVE && context->sceneStore) {
+        if (SceneStore_Save(context, &scenes)) {
+            TraceLog(LOG_INFO, "SCENES: Saved %u nodes, rewrote %u of %u chunks (%u bytes) in %.2f ms",
+                     scenes.nodes, scenes.chunksWritten, scenes.scenes + 1, scenes.bytes, (Clock_Seconds() - start) * 1000.0);
+        }
+    } else if (action == MENU_ACTION_LOAD && SceneStore_Exists(SCENE_STORE_DIR)) {
+        if (SceneStore_Open(context, SCENE_STORE_DIR, &scenes)) {
+            TraceLog(LOG_INFO, "SCENES: Opened %u scenes, %u nodes loaded (%u bytes) in %.2f ms",
+                     scenes.scenes, scenes.nodes, scenes.bytes, (Clock_Seconds() - start) * 1000.0);
+        }
+        RequestRedraw(context);
+    } else if (action == MENU_ACTION_SPLIT) {
+        if (SceneStore_Create(context, SCENE_STORE_DIR, &scenes)) {
+            TraceLog(LOG_INFO, "SCENES: Split %u nodes into %u scene chunks (%u bytes) in %.2f ms",
+                     scenes.nodes, scenes.scenes, scenes.bytes, (Clock_Seconds() - start) * 1000.0);
+        }
+    } else if (action == MENU_ACTION_SAVE) {
+        if (!Journal_Save(context, PROJECT_FILE_PATH, &stats)) return;
+        if (stats.fullSave) {
+            TraceLog(LOG_INFO, "PROJECT: Saved %u nodes, %u edges, %u scenes (%u bytes) in %.2f ms",
+                     stats.project.nodes, stats.project.edges, stats.project.scenes, stats.project.bytes,
+                     (Clock_Seconds() - start) * 1000.0);
+        } else {
+            TraceLog(LOG_INFO, "JOURNAL: Appended %u records (%u bytes, log %u bytes) in %.2f ms%s",
+                     stats.records, stats.bytes, stats.logBytes, (Clock_Seconds() - start) * 1000.0,
+                     stats.compacting ? ", compacting" : "");
+        }
+    } else if (action == MENU_ACTION_LOAD) {
+        if (Journal_Load(context, PROJECT_FILE_PATH, &stats)) {
+            TraceLog(LOG_INFO, "PROJECT: Loaded %u nodes, %u edges, %u scenes (%u bytes), replayed %u batches in %.2f ms",
+                     stats.project.nodes, stats.project.edges, stats.project.scenes, stats.project.bytes,
+                     stats.batches, (Clock_Seconds() - start) * 1000.0);
+        }
+        RequestRedraw(context);
+    } else if (action == MENU_ACTION_EXPORT_TEXT) {
+        SceneStore_LoadAll(context);    // the text file is the whole project
+        if (ProjectText_Save(context, PROJECT_TEXT_FILE_PATH, &stats.project)) {
+            TraceLog(LOG_INFO, "PROJECT: Exported %u nodes, %u edges, %u scenes as text (%u bytes) in %.2f ms",
+                     stats.project.nodes, stats.project.edges, stats.project.scenes, stats.project.bytes,
+                     (Clock_Seconds() - start) * 1000.0);
+        }
+    } else if (action == MENU_ACTION_RUN) {
+        Playtest_Start(context);
+    } else if (action == MENU_ACTION_BUILD_STORY) {
+        Story_Build(context, STORY_FILE_PATH);
+    } else if (action == MENU_ACTION_IMPORT_TEXT) {
+        if (ProjectText_Load(context, PROJECT_TEXT_FILE_PATH, &stats.project)) {
+            TraceLog(LOG_INFO, "PROJECT: Imported %u nodes, %u edges, %u scenes from text (%u bytes) in %.2f ms",
+                     stats.project.nodes, stats.project.edges, stats.project.scenes, stats.project.bytes,
+                     (Clock_Seconds() - start) * 1000.0);
+        }
+        RequestRedraw(context);
+    }
+}
+
+// === Editor frame ===
+// The front end and tools/replay.c run the same frame: Editor_Update with this frame's input,
+// UpdateRedrawMode, the draw pass when it says so, then the playtest answer and the menu action.
+
+// Fresh editor: the intro scene and one dialogue node. False when the pool cannot be allocated.
+bool Editor_Init(Context *context, NodePool *pool) {
+    if (!NodePool_Init(pool)) return false;
+
+    Node *head = NodePool_Alloc(pool);
+
+    //intitial clean context
+    *context = (Context){
+        .pool = pool,
+        .isDragging = false,
+        .draggedNode = NULL,
+        .dragOffset = {0},
+        .lastClickTime = 0,
+        .zHead = NULL,
+        .zTail = NULL,
+        .dragStartTime = 0,
+        .dragCandidateNode = NULL,
+        .bringToFront = NULL,
+        .connecting = false,
+        .connectionStart = {0},
+        .bezier = {{0},{0},{0},{0}},
+        .connectingFromNode = NULL,
+        .connectingFromConnectorIndex = -1,
+        .hoveredInputNode = NULL,
+        .hoveredInputConnectorIndex = -1,
+        .sceneList = {.count = 0},          // no scenes yet
+        .isDrawingScene = false,            // not currently drawing
+        .sceneStartPos = {0, 0},            // initial mouse origin (irrelevant at boot)
+        .draggedScene = NULL,
+        .sceneDragOffset = {0, 0},
+        .isResizingScene = false,
+        .isResizingSceneVertically = false,
+        .resizingScene = NULL,
+        .initialSceneWidth = 0,
+        .initialSceneHeight = 0,
+        .resizeStartX = 0,
+        .resizeStartY = 0,
+        .camera = { .offset = {0, 0}, .target = {0, 0}, .rotation = 0.0f, .zoom = 1.0f },
+        .cursor = MOUSE_CURSOR_DEFAULT,
+        .redrawMode = REDRAW_CONTINUOUS,
+        .redrawRequested = true,            // first frame is always drawn
+        .pendingJobs = 0
+    };
+
+    EdgeStore_Init(&context->edges);
+    SpatialGrid_Init(&context->grid);
+    CreateInitialScene(context);
+
+    //initial node for testing
+    head->position = (Vector2){ 200, 200 };
+    head->width = 200;
+    head->height = 60;
+    head->isExpanded = false;
+    head->type = NODE_DEFAULT;
+    strcpy(head->id, "AAAA0001");
+    RegisterBasicConnectors(head);
+    ZList_PushTop(head, context);
+    SpatialGrid_Update(&context->grid, head);
+    MarkNodeMembershipDirty(head, context);
+    return true;
+}
+
+// Everything that reacts to context->input, in order. screen gives the size of the view.
+void Editor_Update(Context *context, const ScreenSettings *screen) {
+    PROFILE_BEGIN(PROFILE_ZONE_PAN_ZOOM);
+    Behavior_ZoomCanvas(context);
+    Behavior_PanCanvas(context);
+    UpdateMouseWorldPosition(context);
+    UpdateVisibleWorldRect(context, screen->width, screen->height);
+    PROFILE_END(PROFILE_ZONE_PAN_ZOOM);
+
+    PROFILE_BEGIN(PROFILE_ZONE_SCENE_STORE);
+    SceneStore_Update(context);
+    PROFILE_END(PROFILE_ZONE_SCENE_STORE);
+
+    PROFILE_BEGIN(PROFILE_ZONE_NODE_CREATION);
+    HandleNodeCreationClick(context);
+    PROFILE_END(PROFILE_ZONE_NODE_CREATION);
+
+    PROFILE_BEGIN(PROFILE_ZONE_SCENE_OUTLINE);
+    Behavior_DrawSceneOutline(context);
+    PROFILE_END(PROFILE_ZONE_SCENE_OUTLINE);
+
+    PROFILE_BEGIN(PROFILE_ZONE_NODE_BEHAVIORS);
+    DispatchNodeBehaviors(context);
+    PROFILE_END(PROFILE_ZONE_NODE_BEHAVIORS);
+
+    PROFILE_BEGIN(PROFILE_ZONE_SCENE_BEHAVIORS);
+    Behavior_SceneOutlines(context);
+    Behavior_LiveConnection(context);
+    PROFILE_END(PROFILE_ZONE_SCENE_BEHAVIORS);
+
+    PROFILE_BEGIN(PROFILE_ZONE_MEMBERSHIP);
+    UpdateSceneNodeMembership(context);
+    PROFILE_END(PROFILE_ZONE_MEMBERSHIP);
+
+    PROFILE_BEGIN(PROFILE_ZONE_AUTOSAVE);
+    Autosave_Update(context);
+    PROFILE_END(PROFILE_ZONE_AUTOSAVE);
+
+    PROFILE_BEGIN(PROFILE_ZONE_PLAYTEST);
+    Playtest_Update(context);
+    PROFILE_END(PROFILE_ZONE_PLAYTEST);
+}
+
+// Stops the background work and releases everything Editor_Init and the session allocated
+void Editor_Shutdown(Context *context) {
+    Playtest_Stop(context);
+    Autosave_Stop(context);
+    Journal_Close(context);
+    SceneStore_Close(context);
+    SpatialGrid_Destroy(&context->grid);
+    free(context->visibleNodes);
+    free(context->visibleCurves);
+    free(context->membershipQueue);
+    free(context->membershipCandidates);
+    for (int i = 0; i < context->sceneList.count; i++) SceneOutline_Free(&context->sceneList.scenes[i]);
+    EdgeStore_Destroy(&context->edges);
+    NodePool_Destroy(context->pool);
+    FileMap_Close(&context->projectMap);
+}
+
+// SCENE MEMBERSHIP
+// Membership only changes on node create, move-end, expand and delete, or when a scene is
+// created, resized or dropped. Those events queue work here, every other frame costs nothing.
+bool SceneOutline_HasNode(const SceneOutline *scene, const Node *node) {
+    int word = node->index / 32;
+    return word < scene->memberWords && (scene->memberBits[word] & (1u << (node->index % 32)));
+}
+
+void SceneOutline_AddNode(SceneOutline *scene, Node *node) {
+    int word = node->index / 32;
+    if (word >= scene->memberWords) {
+        int newWords = (word + 1) * 2;
+        unsigned int *bits = realloc(scene->memberBits, newWords * sizeof(unsigned int));
+        if (!bits) return;
+        memset(bits + scene->memberWords, 0, (newWords - scene->memberWords) * sizeof(unsigned int));
+        scene->memberBits = bits;
+        scene->memberWords = newWords;
+    }
+    if (scene->nodeCount == scene->nodeCapacity) {
+        int newCapacity = scene->nodeCapacity ? scene->nodeCapacity * 2 : 16;
+        NodeHandle *nodes = realloc(scene->containedNodes, newCapacity * sizeof(NodeHandle));
+        if (!nodes) return;
+        scene->containedNodes = nodes;
+        scene->nodeCapacity = newCapacity;
+    }
+
+    scene->memberBits[word] |= 1u << (node->index % 32);
+    scene->containedNodes[scene->nodeCount++] = NodePool_Handle(node);
+}
+
+static void SceneOutline_RemoveNode(SceneOutline *scene, Node *node) {
+    scene->memberBits[node->index / 32] &= ~(1u << (node->index % 32));
+
+    // keep join order, scenes hold few nodes compared to the graph
+    for (int i = 0; i < scene->nodeCount; i++) {
+        if (NodeHandle_Is(scene->containedNodes[i], node)) {
+            memmove(&scene->containedNodes[i], &scene->containedNodes[i + 1],
+                    (scene->nodeCount - i - 1) * sizeof(NodeHandle));
+            scene->nodeCount--;
+            break;
+        }
+    }
+}
+
+void SceneOutline_Free(SceneOutline *scene) {
+    free(scene->containedNodes);
+    free(scene->memberBits);
+    scene->containedNodes = NULL;
+    scene->memberBits = NULL;
+    scene->nodeCount = scene->nodeCapacity = scene->memberWords = 0;
+}
+
+void MarkNodeMembershipDirty(Node *node, Context *context) {
+    if (node->membershipQueued) return;
+
+    if (context->membershipQueueCount == context->membershipQueueCapacity) {
+        int newCapacity = context->membershipQueueCapacity ? context->membershipQueueCapacity * 2 : 64;
+        NodeHandle *queue = realloc(context->membershipQueue, newCapacity * sizeof(NodeHandle));
+        if (!queue) return;
+        context->membershipQueue = queue;
+        context->membershipQueueCapacity = newCapacity;
+    }
+    context->membershipQueue[context->membershipQueueCount++] = NodePool_Handle(node);
+    node->membershipQueued = true;
+}
+
+void MarkSceneMembershipDirty(SceneOutline *scene, Context *context) {
+    scene->membershipDirty = true;
+    context->scenesDirty = true;
+}
+
+// deleted nodes leave every scene right away, before their slot can be reused
+void RemoveNodeFromScenes(Node *node, Context *context) {
+    for (int s = 0; s < context->sceneList.count; s++) {
+        SceneOutline *scene = &context->sceneList.scenes[s];
+        if (SceneOutline_HasNode(scene, node)) SceneOutline_RemoveNode(scene, node);
+    }
+}
+
+// Applies the join / stay / leave rules for one node and one scene. Returns true if the scene grew.
+static bool ApplySceneMembership(SceneOutline *scene, Node *node, Context *context) {
+    const float paddingX = 20.0f;
+    const float paddingY = 20.0f;
 
-                // Move anchor points
-                for (int j = 0; j < 4; j++) {
-                    curve->points[j] = Vector2Add(curve->points[j], delta);
+    Rectangle sceneBounds = scene->bounds;
+    Rectangle nodeBounds = GetNodeBounds(node);
+
+    bool topLeftInside = CheckCollisionPointRec(node->position, sceneBounds);
+    bool intersects = CheckCollisionRecs(nodeBounds, sceneBounds);
+    bool wasInScene = SceneOutline_HasNode(scene, node);
+
+    // === CASE A: Node was NOT in scene, but now is (top-left inside)
+    // === CASE C: Node intersects but was never in the scene
+    if (!wasInScene && (topLeftInside || intersects)) {
+        // Expand bounds immediately to fit node fully (move top/left if needed)
+        float requiredLeft   = fminf(sceneBounds.x, nodeBounds.x - paddingX);
+        float requiredTop    = fminf(sceneBounds.y, nodeBounds.y - paddingY);
+        float requiredRight  = fmaxf(sceneBounds.x + sceneBounds.width, nodeBounds.x + nodeBounds.width + paddingX);
+        float requiredBottom = fmaxf(sceneBounds.y + sceneBounds.height, nodeBounds.y + nodeBounds.height + paddingY);
+
+        sceneBounds.x = requiredLeft;
+        sceneBounds.y = requiredTop;
+        sceneBounds.width = requiredRight - requiredLeft;
+        sceneBounds.height = requiredBottom - requiredTop;
+
+        // Re-check top-left inclusion
+        if (CheckCollisionPointRec(node->position, sceneBounds)) {
+            SceneOutline_AddNode(scene, node);
+        }
+    }
+
+    // === CASE B: Node was already in scene
+    else if (wasInScene) {
+        if (topLeftInside) {
+            // Only expand bounds if not actively dragging this node
+            if (context->draggedNode != node) {
+                float requiredRight  = nodeBounds.x + nodeBounds.width + paddingX;
+                float requiredBottom = nodeBounds.y + nodeBounds.height + paddingY;
+
+                float currentRight = sceneBounds.x + sceneBounds.width;
+                float currentBottom = sceneBounds.y + sceneBounds.height;
+
+                if (requiredRight > currentRight) {
+                    sceneBounds.width = requiredRight - sceneBounds.x;
                 }
 
-                /*
-                // Move relative positions too
-                for (int j = 0; j < 2; j++) {
-                    curve->relativeposition[j].x += delta.x;
-                    curve->relativeposition[j].y += delta.y;
+                if (requiredBottom > currentBottom) {
+                    sceneBounds.height = requiredBottom - sceneBounds.y;
                 }
-                */
             }
+        } else {
+            // top-left left the scene → drop node from scene
+            SceneOutline_RemoveNode(scene, node);
+        }
+    }
 
-            // Move scene outlines
-            for (int i = 0; i < context->sceneList.count; i++) {
-                context->sceneList.scenes[i].bounds.x += delta.x;
-                context->sceneList.scenes[i].bounds.y += delta.y;
-            }
+    // Else: not in scene, not intersecting → ignore
 
-            context->panStartMouse = mouse;
-        } else {
-            context->isPanning = false;
-            SetMouseCursor(MOUSE_CURSOR_DEFAULT);
+    bool grew = sceneBounds.x != scene->bounds.x || sceneBounds.y != scene->bounds.y ||
+                sceneBounds.width != scene->bounds.width || sceneBounds.height != scene->bounds.height;
+    scene->bounds = sceneBounds;
+    return grew;
+}
+
+// Re-checks the members plus every node the grid reports inside the scene bounds
+// A growing scene can swallow more nodes, so this repeats until the bounds settle. The bounds only
+// grow and a node grows them at most once, when it joins or first gets fitted, so that ends.
+static void RefreshSceneMembership(SceneOutline *scene, Context *context) {
+    for (;;) {
+        bool grew = false;
+
+        for (int i = scene->nodeCount - 1; i >= 0; i--) {
+            Node *node = NodePool_Resolve(context->pool, scene->containedNodes[i]);
+            if (node) grew |= ApplySceneMembership(scene, node, context);
+        }
+
+        int count = SpatialGrid_Query(&context->grid, scene->bounds, &context->membershipCandidates,
+                                      &context->membershipCandidateCapacity);
+        for (int i = 0; i < count; i++) {
+            Node *node = context->membershipCandidates[i];
+            if (!SceneOutline_HasNode(scene, node)) {
+                grew |= ApplySceneMembership(scene, node, context);
+            }
         }
+
+        if (!grew) break;
     }
+    scene->membershipDirty = false;
 }
 
 //function that adds nodes into scene visually
 void UpdateSceneNodeMembership(Context *context) {
-    if (!context || !context->nodes) return;
+    if (!context || !context->pool) return;
     
     
     if (context->isDragging || context->draggedNode != NULL) {
         return;
     }
 
-    const float paddingX = 20.0f;
-    const float paddingY = 20.0f;
+    // 💤 Idle frames: nothing queued, nothing to do
+    if (!context->scenesDirty && context->membershipQueueCount == 0) return;
 
-    for (int s = 0; s < context->sceneList.count; s++) {
-        SceneOutline *scene = &context->sceneList.scenes[s];
+    // === Scenes whose bounds changed ===
+    if (context->scenesDirty) {
+        bool deferred = false;
+        for (int s = 0; s < context->sceneList.count; s++) {
+            SceneOutline *scene = &context->sceneList.scenes[s];
+            if (!scene->membershipDirty || scene->unloaded) continue;
 
-        // Skip active resizing (we still want to allow node dragging logic)
-        if (context->resizingScene == scene) continue;
+            // Skip active resizing (picked up again once the resize ends)
+            if (context->resizingScene == scene) {
+                deferred = true;
+                continue;
+            }
+            RefreshSceneMembership(scene, context);
+        }
+        context->scenesDirty = deferred;
+    }
 
-        // Backup previous state
-        memcpy(scene->previousNodes, scene->containedNodes, sizeof(scene->containedNodes));
-        scene->previousNodeCount = scene->nodeCount;
-        scene->nodeCount = 0;
+    // === Nodes that were created, moved, expanded ===
+    for (int i = 0; i < context->membershipQueueCount; i++) {
+        Node *node = NodePool_Resolve(context->pool, context->membershipQueue[i]);
+        if (!node) continue;  // deleted while queued
+        node->membershipQueued = false;
+
+        Rectangle nodeBounds = GetNodeBounds(node);
+        for (int s = 0; s < context->sceneList.count; s++) {
+            SceneOutline *scene = &context->sceneList.scenes[s];
+            if (context->resizingScene == scene || scene->unloaded) continue;  // frozen until loaded
+
+            // only scenes touching the node, or holding it, can change
+            if (SceneOutline_HasNode(scene, node) || CheckCollisionRecs(nodeBounds, scene->bounds)) {
+                if (ApplySceneMembership(scene, node, context)) {
+                    MarkSceneMembershipDirty(scene, context);  // grown scene may now reach other nodes
+                }
+            }
+        }
+    }
+    context->membershipQueueCount = 0;
+    RequestRedraw(context);  // scene bounds may have grown
+}
 
-        Rectangle sceneBounds = scene->bounds;
+// SCENE AND NODE HELPERS
+// Measured here for the behaviours, ui.c draws the same bounds
+// Name bar in the top-left corner of a scene, the handle for dragging it. label receives its text.
+// Sized by characters rather than with the editor font, which a headless core never loads: the hit
+// box has to be the same with and without a window, or a replay would miss recorded scene drags.
+Rectangle GetSceneLabelBounds(const SceneOutline *scene, char *label, int labelSize) {
+    float labelHeight = SCENE_LABEL_HEIGHT;
+    float labelPadding = 12.0f;
+    snprintf(label, labelSize, "Scene: %s", scene->name[0] != '\0' ? scene->name : "Unnamed");
+
+    int characters = 0;
+    for (const char *c = label; *c; c++) {
+        if (((unsigned char)*c & 0xC0) != 0x80) characters++;     // UTF-8 continuation bytes do not count
+    }
+    return (Rectangle){ scene->bounds.x, scene->bounds.y, characters * SCENE_LABEL_CHAR_WIDTH + labelPadding, labelHeight };
+}
 
-        for (int i = 0; i < MAX_NODES; i++) {
-            Node *node = &context->nodes[i];
-            if (node->type == NODE_COUNT) continue;
+// Icons in the top-right corner of a scene, slot 0 is the rightmost (delete), slot 1 shrinks
+Rectangle GetSceneIconBounds(const SceneOutline *scene, int slot) {
+    float iconSize = 16.0f;
+    float iconPadding = 4.0f;
+    return (Rectangle){
+        scene->bounds.x + scene->bounds.width - (slot + 1) * (iconSize + iconPadding),
+        scene->bounds.y + iconPadding,
+        iconSize,
+        iconSize
+    };
+}
 
-            // Compute bounding box of this node
-            float nodeHeight = node->isExpanded ? node->height * 5 : node->height;
-            Rectangle nodeBounds = {
-                node->position.x,
-                node->position.y,
-                (float)node->width,
-                nodeHeight
-            };
+// What the view has to overlap for any part of the scene to show: the name bar can run past a
+// narrow scene's right edge, the border straddles the bounds
+Rectangle GetSceneCullBounds(const SceneOutline *scene) {
+    return (Rectangle){
+        scene->bounds.x - SCENE_LABEL_HEIGHT,
+        scene->bounds.y - SCENE_LABEL_HEIGHT,
+        scene->bounds.width + 2 * SCENE_LABEL_HEIGHT,
+        scene->bounds.height + 2 * SCENE_LABEL_HEIGHT
+    };
+}
 
-            bool topLeftInside = CheckCollisionPointRec(node->position, sceneBounds);
-            bool intersects = CheckCollisionRecs(nodeBounds, sceneBounds);
+// Fits the scene around its member nodes
+void ShrinkSceneToFitContent(SceneOutline *scene, Context *context){
+    if (!scene || scene->nodeCount == 0) return;
 
-            // Check previous membership
-            bool wasInScene = false;
-            for (int j = 0; j < scene->previousNodeCount; j++) {
-                if (scene->previousNodes[j] == node) {
-                    wasInScene = true;
-                    break;
-                }
-            }
+    const float paddingX = 20.0f;
+    const float paddingY = 20.0f;
 
-            // === CASE A: Node was NOT in scene, but now is (top-left inside)
-            if (!wasInScene && topLeftInside) {
-                // Expand bounds immediately to fit node fully
-                float requiredLeft   = fminf(sceneBounds.x, nodeBounds.x - paddingX);
-                float requiredTop    = fminf(sceneBounds.y, nodeBounds.y - paddingY);
-                float requiredRight  = fmaxf(sceneBounds.x + sceneBounds.width, nodeBounds.x + nodeBounds.width + paddingX);
-                float requiredBottom = fmaxf(sceneBounds.y + sceneBounds.height, nodeBounds.y + nodeBounds.height + paddingY);
-
-                sceneBounds.x = requiredLeft;
-                sceneBounds.y = requiredTop;
-                sceneBounds.width = requiredRight - requiredLeft;
-                sceneBounds.height = requiredBottom - requiredTop;
-
-                if (scene->nodeCount < MAX_SCENE_NODES) {
-                    scene->containedNodes[scene->nodeCount++] = node;
-                }
-            }
+    float minX = FLT_MAX, minY = FLT_MAX;
+    float maxX = -FLT_MAX, maxY = -FLT_MAX;
 
-            // === CASE B: Node was already in scene
-            else if (wasInScene) {
-                if (topLeftInside) {
-                    // Only expand bounds if not actively dragging this node
-                    if (context->draggedNode != node) {
-                        float requiredRight  = nodeBounds.x + nodeBounds.width + paddingX;
-                        float requiredBottom = nodeBounds.y + nodeBounds.height + paddingY;
+    for (int i = 0; i < scene->nodeCount; i++) {
+        Node *node = NodePool_Resolve(context->pool, scene->containedNodes[i]);
+        if (!node) continue;
 
-                        float currentRight = sceneBounds.x + sceneBounds.width;
-                        float currentBottom = sceneBounds.y + sceneBounds.height;
+        float nodeHeight = node->isExpanded ? node->height * 5 : node->height;
 
-                        if (requiredRight > currentRight) {
-                            sceneBounds.width = requiredRight - sceneBounds.x;
-                        }
+        float left = node->position.x;
+        float top = node->position.y;
+        float right = left + node->width;
+        float bottom = top + nodeHeight;
 
-                        if (requiredBottom > currentBottom) {
-                            sceneBounds.height = requiredBottom - sceneBounds.y;
-                        }
-                    }
+        if (left < minX) minX = left;
+        if (top < minY) minY = top;
+        if (right > maxX) maxX = right;
+        if (bottom > maxY) maxY = bottom;
+    }
 
-                    if (scene->nodeCount < MAX_SCENE_NODES) {
-                        scene->containedNodes[scene->nodeCount++] = node;
-                    }
-                }
-                // Optional: if top-left is now outside → drop node from scene
-            }
+    scene->bounds.x = minX - paddingX;
+    scene->bounds.y = minY - (2*paddingY);
+    scene->bounds.width = (maxX - minX) + 2 * paddingX;
+    scene->bounds.height = (maxY - minY) + 2 * paddingY;
+}
 
-            // === CASE C: Node intersects but was never in the scene
-            else if (!wasInScene && !topLeftInside && intersects) {
-                // Push scene to include this node (move top/left if needed)
-                float requiredLeft   = fminf(sceneBounds.x, nodeBounds.x - paddingX);
-                float requiredTop    = fminf(sceneBounds.y, nodeBounds.y - paddingY);
-                float requiredRight  = fmaxf(sceneBounds.x + sceneBounds.width, nodeBounds.x + nodeBounds.width + paddingX);
-                float requiredBottom = fmaxf(sceneBounds.y + sceneBounds.height, nodeBounds.y + nodeBounds.height + paddingY);
-
-                sceneBounds.x = requiredLeft;
-                sceneBounds.y = requiredTop;
-                sceneBounds.width = requiredRight - requiredLeft;
-                sceneBounds.height = requiredBottom - requiredTop;
-
-                // Re-check top-left inclusion
-                if (CheckCollisionPointRec(node->position, sceneBounds)) {
-                    if (scene->nodeCount < MAX_SCENE_NODES) {
-                        scene->containedNodes[scene->nodeCount++] = node;
-                    }
-                }
-            }
+void CreateInitialScene(Context *context) {
+    if (context->sceneList.count < MAX_SCENES) {
+        SceneOutline scene = {
+            .bounds = (Rectangle){ 150, 150, 300, 200 }
+        };
+        strncpy(scene.name, "Intro", sizeof(scene.name));
+        context->sceneList.scenes[context->sceneList.count++] = scene;
+        MarkSceneMembershipDirty(&context->sceneList.scenes[context->sceneList.count - 1], context);
+    }
+}
 
-            // Else: not in scene, not intersecting → ignore
-        }
+// Helper function, give it the enum type (which defaults to an int) and get the string
+const char* GetNodeTypeName(int type) {
+    static const char* names[] = {
+        "Dialogue Node", "Stack Node", "Random Node", "Random Bag",
+        "User Choice", "Skill Gate", "Go To", "If/Else"
+    };
+    return (type >= 0 && type < NODE_COUNT) ? names[type] : "Unknown";
+}
 
-        scene->bounds = sceneBounds;
+// RandomID, from a PCG stream of its own: raylib's generator is shared and only seeded by InitWindow
+void GenerateRandomID(char *buffer, int length) {
+    static NarrativeRandom random;
+    static bool seeded = false;
+    if (!seeded) {
+        NarrativeRandom_Seed(&random, ((uint64_t)time(NULL) << 24) ^ (uint64_t)clock(), (uint64_t)(uintptr_t)&random);
+        seeded = true;
     }
+    const char charset[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    for (int i = 0; i < length; i++) {
+        buffer[i] = charset[NarrativeRandom_Below(&random, (uint32_t)(sizeof(charset) - 1))];
+    }
+    buffer[length] = '\0';
 }
 
 // DEBUG FUNCTIONS 
@@ -996,41 +2299,32 @@ void UpdateSceneNodeMembership(Context *context) {
 
 use:
 
-Debug_PrintNodes(nodes, head);
+Debug_PrintNodes(&pool, context.zHead);
 
 in main()
 
 */
-void Debug_PrintNodes(Node *nodes, Node *head) {
+void Debug_PrintNodes(NodePool *pool, Node *head) {
     printf("---- NODE LIST DEBUG ----\n");
 
     Node *current = head;
     int guard = 0;
 
-    while (current != NULL && guard++ < MAX_NODES) {
-        // Find index of this node in the array
-        int index = -1;
-        for (int i = 0; i < MAX_NODES; i++) {
-            if (&nodes[i] == current) {
-                index = i;
-                break;
-            }
-        }
-
-        printf("Node #%d (array index: %d) | Type: %d | Pos: (%.1f, %.1f)\n",
-               guard, index, current->type, current->position.x, current->position.y);
+    while (current != NULL && guard++ < pool->liveCount) {
+        printf("Node #%d (pool index: %d) | Type: %d | Pos: (%.1f, %.1f)\n",
+               guard, current->index, current->type, current->position.x, current->position.y);
 
         current = current->nextZ;
     }
 
-    if (guard >= MAX_NODES) {
-        printf("Warning: node traversal exceeded MAX_NODES — possible cyclic or corrupted list!\n");
+    if (current != NULL) {
+        printf("Warning: node traversal exceeded the live node count — possible cyclic or corrupted list!\n");
     }
 
     printf("-------------------------\n");
 }
 
-void Debug_ContextAfterDelete(Node *nodes, Context *context) {
+void Debug_ContextAfterDelete(Context *context) {
     printf("==== Context After Deletion ====\n");
 
     printf("IsDragging: %s\n", context->isDragging ? "true" : "false");
@@ -1038,11 +2332,11 @@ void Debug_ContextAfterDelete(Node *nodes, Context *context) {
     printf("Drag Offset: (%.1f, %.1f)\n", context->dragOffset.x, context->dragOffset.y);
     printf("Last Click Time: %.2f\n", context->lastClickTime);
 
-    if (context->head && *(context->head)) {
-        printf("Head Node: %p\n", (void*)*(context->head));
+    if (context->zHead) {
+        printf("Head Node: %p\n", (void*)context->zHead);
     } else {
         printf("Head Node: NULL\n");
     }
 
-    Debug_PrintNodes(nodes, *(context->head));
+    Debug_PrintNodes(context->pool, context->zHead);
 }
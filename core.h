@@ -1,5 +1,6 @@
 #pragma once
 #include "nodetypes.h"
+#include "filemap.h"
 
 extern Font globalFont;
 
@@ -10,18 +11,31 @@ extern Font globalFont;
 
 // Defines
 #define MAX_CONNECTORS 12 //amount of connectors per node
-#define MAX_NODES 250     //amount of nodes in the graph
-#define MAX_BEZIERS 300   //amount of permanent bezier curves 
-#define MAX_SCENES 50     //amount of scenes inside a project
-#define MAX_SCENE_NODES 32
+#define NODE_POOL_CHUNK 256 //amount of nodes per pool chunk, chunks never move once allocated
+#define EDGE_STORE_CHUNK 256 //amount of bezier curves per edge store chunk
+#define MAX_SCENES 512    //amount of scenes inside a project
+#define GRID_CELL_SIZE 256.0f //world units covered by one spatial grid cell
+#define CURVE_GRID_CELL_SIZE 1024.0f //world units covered by one cell of the curve grid
+#define CURVE_GRID_MAX_CELLS 64 //curves covering more cells than this are kept in a list instead
+#define NODE_MIN_SIZE 8         //smallest node width and height a loaded file may give
+#define NODE_MAX_SIZE 4096      //largest one
+#define WORLD_LIMIT 1000000.0f  //loaded coordinates stay within +-WORLD_LIMIT
+#define CAMERA_MIN_ZOOM 0.125f  //zoom range of the mouse wheel, and of a loaded view
+#define CAMERA_MAX_ZOOM 4.0f
 
 typedef struct {
     Rectangle bounds;
     char name[32];
-    Node *containedNodes[MAX_SCENE_NODES];
-    Node *previousNodes[MAX_SCENE_NODES];
-    int previousNodeCount;
+    NodeHandle *containedNodes;     // member nodes in join order
     int nodeCount;
+    int nodeCapacity;
+    unsigned int *memberBits;       // one bit per node pool slot, O(1) membership test
+    int memberWords;
+    bool membershipDirty;           // bounds changed, members must be re-checked
+    // scene store, see scenestore.h
+    unsigned int chunkId;           // chunk holding the scene's nodes, 0 until the scene is first stored
+    bool unloaded;                  // nodes are in the chunk, not in the pool; membership is frozen
+    unsigned int lastVisible;       // store frame the scene was last near the view
 } SceneOutline;
 
 typedef struct {
@@ -34,13 +48,83 @@ typedef enum {
     VIEW_MODE_SCRIPT
 } ViewMode;
 
+// Menu bar button that was clicked this frame, handled by the main loop once drawing is done
+typedef enum {
+    MENU_ACTION_NONE,
+    MENU_ACTION_SAVE,
+    MENU_ACTION_LOAD,
+    MENU_ACTION_RUN,
+    MENU_ACTION_EXPORT_TEXT,    // canonical text project for version control, see projecttext.h
+    MENU_ACTION_IMPORT_TEXT,
+    MENU_ACTION_SPLIT,          // store the project as one chunk per scene, see scenestore.h
+    MENU_ACTION_BUILD_STORY     // narrative blob for the game runtime, see story.h
+} MenuAction;
+
 typedef struct {
     Vector2 points[4];  // Cubic Bézier: start, control1, control2, end
     Vector2 relativeposition[2];   // xy vs corner startnode, xy vs corner endnode
-    Node *fromNode;                // Pointer to the node where connection starts
-    Node *toNode;                  // Pointer to the node where connection ends
+    Rectangle bounds;              // AABB of the control points, the curve never leaves it
+    NodeHandle fromNode;           // Handle of the node where connection starts
+    NodeHandle toNode;             // Handle of the node where connection ends
+    int nextEdge[2];               // next curve in the incidence list of fromNode [0] / toNode [1] (EDGE_REF), -1 ends
+    int prevEdge[2];               // previous curve in the same incidence lists (EDGE_REF), -1 at the head
 } BezierCurve;
 
+// Incidence lists store edge references: the curve index plus the side (0 = fromNode, 1 = toNode)
+// of the node that owns the list, so a curve from a node to itself sits in its list twice
+#define EDGE_REF(index, side) (((index) << 1) | (side))
+#define EDGE_REF_INDEX(ref) ((ref) >> 1)
+#define EDGE_REF_SIDE(ref) ((ref) & 1)
+
+// One occupied cell of the curve grid, lists the index of every curve whose bounds touch it
+typedef struct {
+    int cx, cy;         // cell coordinates (world position / CURVE_GRID_CELL_SIZE, floored)
+    int *items;
+    int count;
+    int capacity;
+    int next;           // next cell in the same hash bucket, -1 ends the chain
+} CurveCell;
+
+// Where one curve is registered, kept per curve index next to the store
+typedef struct {
+    int minX, minY, maxX, maxY;
+    int wideSlot;               // position in CurveGrid.wide, -1 while the curve sits in cells
+    unsigned int queryStamp;    // last query that reported the curve
+} CurveGridEntry;
+
+// Curve bounds hashed into coarse cells like the node grid, so drawing finds every curve that
+// crosses the view, ends off screen or not. A long link would fill thousands of cells: past
+// CURVE_GRID_MAX_CELLS (or with bounds that are not finite) a curve goes to the wide list, which
+// every query tests curve by curve.
+typedef struct {
+    int *buckets;       // first cell of each hash chain, -1 if empty
+    int bucketCount;    // power of two
+    CurveCell *cells;
+    int cellCount;
+    int cellCapacity;
+    int *wide;          // curve indices
+    int wideCount;
+    int wideCapacity;
+    CurveGridEntry *entries;    // by curve index
+    int entryCapacity;
+    unsigned int queryStamp;
+} CurveGrid;
+
+// Arena of permanent bezier curves. Curves are packed in [0, count) and removed by swapping the
+// last curve into the hole, every node threads its own curves through BezierCurve.nextEdge/prevEdge
+typedef struct {
+    BezierCurve **chunks;   // table of chunks, each chunk holds EDGE_STORE_CHUNK curves
+    int chunkCount;
+    int chunkCapacity;
+    int count;              // amount of curves in use
+    // copy-on-write while a snapshot is taken, see EdgeStore_Touch
+    BezierCurve **frozen;   // pre-edit copies of chunks [0, frozenChunkCount), NULL until first written
+    int frozenChunkCount;   // 0 when no snapshot is pending
+    int frozenCount;        // curve count when the snapshot was taken
+    bool frozenFailed;      // a copy could not be allocated, the snapshot is unusable
+    CurveGrid grid;         // the bounds of the live curves, not part of a snapshot
+} EdgeStore;
+
 // Enum to track screen mode
 typedef enum {
     SCREEN_SMALL,
@@ -70,10 +154,87 @@ typedef struct {
     Connection with;
 } Connector;
 
+// Heap-backed node storage. Nodes live in fixed-size chunks so a Node* stays valid when the pool grows,
+// unused slots are threaded on an intrusive free list for O(1) alloc and release
+typedef struct {
+    Node **chunks;      // table of chunks, each chunk holds NODE_POOL_CHUNK nodes
+    int chunkCount;
+    int chunkCapacity;
+    Node *freeList;     // unused slots, doubly linked through Node.nextFree / Node.prevFree
+    int liveCount;      // amount of nodes currently in use
+    unsigned int revision;  // bumped on every saved-field write, tells autosave something changed
+    // copy-on-write while a snapshot is taken, see NodePool_Touch
+    Node **frozen;      // pre-edit copies of chunks [0, frozenCount), NULL until first written
+    int frozenCount;    // 0 when no snapshot is pending
+    bool frozenFailed;  // a copy could not be allocated, the snapshot is unusable
+    // change tracking for the project journal, see Journal_Save
+    unsigned int lastSaveKey;   // last Node.saveKey handed out
+    int *changedSlots;          // slots written since the last journal save, each listed once
+    int changedCount;
+    int changedCapacity;
+    unsigned int *removedKeys;  // save keys of the nodes released since the last journal save
+    int removedCount;
+    int removedCapacity;
+    bool changesLost;           // a list could not grow, the next save has to write everything
+} NodePool;
+
+// One occupied cell of the spatial grid, lists every node whose bounds touch it
+typedef struct {
+    int cx, cy;         // cell coordinates (world position / GRID_CELL_SIZE, floored)
+    Node **items;
+    int count;
+    int capacity;
+    int next;           // next cell in the same hash bucket, -1 ends the chain
+} GridCell;
+
+// Uniform grid over node bounds, hashed so the canvas can be unbounded.
+// Answers "which node is under the cursor" by looking at a single cell.
+typedef struct {
+    int *buckets;       // first cell of each hash chain, -1 if empty
+    int bucketCount;    // power of two
+    GridCell *cells;
+    int cellCount;
+    int cellCapacity;
+    unsigned int queryStamp;    // bumped per range query
+} SpatialGrid;
+
+// How the main loop waits for the next frame
+typedef enum {
+    REDRAW_EVENT,       // idle: block until an input event arrives
+    REDRAW_POLL,        // background work pending: wake up a few times per second
+    REDRAW_CONTINUOUS   // dragging, panning, connecting...: full frame rate
+} RedrawMode;
+
+// One frame of input. The front end (main.c) polls it from the window once per frame, a benchmark
+// or a test fills it in by hand: behaviours never ask raylib for the mouse, the buttons or the time.
+typedef struct {
+    double time;                    // seconds, drives double clicks, the drag delay and autosave
+    Vector2 mouse;                  // cursor in screen space
+    Vector2 mouseDelta;
+    float wheel;
+    unsigned int buttonsDown;       // one bit per MouseButton, see INPUT_BUTTON
+    unsigned int buttonsPressed;    // went down this frame
+    unsigned int buttonsReleased;   // went up this frame
+    bool keyActivity;               // any key went down or up, only wakes the redraw
+    bool resized;                   // the window changed size
+} FrameInput;
+
+#define INPUT_BUTTON(button) (1u << (button))
+
+// Per-frame culling counters, filled by the draw pass
+typedef struct {
+    int nodesDrawn;
+    int nodesCulled;
+    int curvesDrawn;
+    int curvesCulled;
+    int scenesDrawn;
+    int scenesCulled;
+} RenderStats;
+
 // Global context that is shared between functions
 typedef struct {
     // nodes
-    Node *nodes; 
+    NodePool *pool; 
     // dragging
     bool isDragging;
     Node *draggedNode;
@@ -92,8 +253,7 @@ typedef struct {
     int connectingFromConnectorIndex;
     Node *hoveredInputNode;
     int hoveredInputConnectorIndex;
-    BezierCurve permanentBeziers[MAX_BEZIERS];
-    int bezierCount;
+    EdgeStore edges;
     // Draw scene context variables
     SceneList sceneList;
     bool isDrawingScene;
@@ -107,12 +267,57 @@ typedef struct {
     float initialSceneHeight;
     float resizeStartX;
     float resizeStartY;    
-    // Panning
+    // Scene membership work queue, nothing to do while it is empty
+    NodeHandle *membershipQueue;
+    int membershipQueueCount;
+    int membershipQueueCapacity;
+    Node **membershipCandidates;    // grid query results of the scene being refreshed
+    int membershipCandidateCapacity;
+    bool scenesDirty;       // at least one scene has membershipDirty set
+    // Panning and zooming
     bool isPanning;
     Vector2 panStartMouse;
     Vector2 panStartOffset;
-    // head linked list
-    Node **head; 
+    Camera2D camera;        // world <-> screen transform, applied once in the draw pass
+    Vector2 mouseWorld;     // cursor in world space, refreshed once per frame after pan/zoom
+    // Culling
+    Rectangle viewWorld;    // part of the world that is on screen this frame
+    Node **visibleNodes;    // nodes overlapping viewWorld, sorted bottom to top
+    int visibleCount;
+    int visibleCapacity;
+    int *visibleCurves;     // indices of the curves whose bounds overlap viewWorld
+    int visibleCurveCount;
+    int visibleCurveCapacity;
+    RenderStats renderStats;
+    // this frame's input, set by the front end before the behaviours run
+    FrameInput input;
+    // requests to the front end, applied once the frame is done
+    MouseCursor cursor;     // shape of the mouse cursor
+    bool warpMouse;         // move the cursor to warpMouseTo (screen space)
+    Vector2 warpMouseTo;
+    // Redraw scheduling
+    RedrawMode redrawMode;  // how the front end should wait for the next frame
+    bool redrawRequested;   // something changed outside of input (job finished, project loaded...)
+    int pendingJobs;        // background jobs still running, keeps the loop polling
+    bool deterministic;     // replay: frame budgets count work instead of timing it, autosave writes inline
+    // z-ordered doubly linked list, zHead is drawn first (bottom), zTail last (top)
+    Node *zHead;
+    Node *zTail;
+    long long zTopKey;      // last key handed out by ZList_PushTop
+    long long zBottomKey;   // last key handed out by ZList_PushBottom
+    // hit testing
+    SpatialGrid grid;
+    // loaded project file, stays mapped while node text still points into it
+    FileMap projectMap;
+    char projectMapPath[260];
+    // background autosave, NULL when disabled
+    struct Autosave *autosave;
+    // append-only save journal of the open project, NULL until the first save or load
+    struct Journal *journal;
+    // per-scene chunk store the project was opened from, NULL for single-file projects
+    struct SceneStore *sceneStore;
+    // story playtest started by Run, NULL while the panel is closed
+    struct Playtest *playtest;
 } Context;
 
 //ffwd declaration for behavioral node functions
@@ -130,6 +335,21 @@ typedef struct Node {
     int width;                             //screen width
     int height;                            //screen height
     Node* nextZ;                           //pointer to next node on z-level
+    Node* prevZ;                           //pointer to previous node on z-level
+    Node* nextFree;                        //next unused slot while the node sits in the pool free list
+    Node* prevFree;                        //previous unused slot, lets undo pull a slot out of the free list
+    int index;                             //stable slot index inside the node pool
+    int firstEdge;                         //head of the incidence list of permanent curves (EDGE_REF), -1 if none
+    int degree;                            //amount of curve ends attached to this node
+    long long zKey;                        //grows towards the top of the z-order, used to pick the topmost hit
+    int gridMinX, gridMinY;                //cell range currently registered in the spatial grid
+    int gridMaxX, gridMaxY;
+    bool inGrid;
+    bool membershipQueued;                 //waiting in the scene membership queue
+    unsigned int queryStamp;               //last grid query that reported this node, avoids duplicates
+    unsigned int generation;               //bumped on every release, stale handles stop resolving
+    unsigned int saveKey;                  //identity in project files and the save journal, never reused
+    bool changeQueued;                     //listed in the pool changedSlots
     bool isExpanded;                       //nodes can be expanded or compacted
     Connector connectors[MAX_CONNECTORS];  //list of connectors on the node for nested hitbox detection
     BehaviorStack behavior;                //per-node stack of behaviour functions
@@ -147,13 +367,28 @@ typedef struct Node {
     } data;
 } Node;
 
+// true when the handle refers to this exact node (same slot and same generation)
+static inline bool NodeHandle_Is(NodeHandle handle, const Node *node) {
+    return node && handle.index == node->index && handle.generation == node->generation;
+}
+
+// Button edges of the current frame, button is a MouseButton
+static inline bool Input_Pressed(const Context *context, int button) {
+    return (context->input.buttonsPressed & INPUT_BUTTON(button)) != 0;
+}
+
+static inline bool Input_Down(const Context *context, int button) {
+    return (context->input.buttonsDown & INPUT_BUTTON(button)) != 0;
+}
+
+static inline bool Input_Released(const Context *context, int button) {
+    return (context->input.buttonsReleased & INPUT_BUTTON(button)) != 0;
+}
 
 
-// Event Handlers
-void HandleScreenToggle(ScreenSettings *screen);
 
 // Dispatcher function
-void DispatchNodeBehaviors(Node *head, Context *context);
+void DispatchNodeBehaviors(Context *context);
 
 // Behaviour functions
 void Behavior_Drag(Node *node, Context *context);
@@ -164,27 +399,104 @@ void Behavior_FocusOnClick(Node *node, Context *context);
 void Behavior_ConnectorClick(Node *node, Context *context);
 void Scene_ShrinkClick(SceneOutline *scene, Context *context);
 void Scene_DeleteClick(SceneOutline *scene, Context *context);
+void Behavior_SceneOutlines(Context *context);
+void Behavior_LiveConnection(Context *context);
 
 // General Behavior functions
-void HandleNodeCreationClick(Context *context, Node **head, Node *nodes);
+void HandleNodeCreationClick(Context *context);
 void Behavior_PanCanvas(Context *context);
+void Behavior_ZoomCanvas(Context *context);
+void UpdateMouseWorldPosition(Context *context);
+void UpdateVisibleWorldRect(Context *context, int screenWidth, int screenHeight);
+void CollectVisibleNodes(Context *context);
+bool UpdateRedrawMode(Context *context);
+void RequestRedraw(Context *context);
 void Behavior_DrawSceneOutline(Context *context);
 void UpdateSceneNodeMembership(Context *context);
+void MarkNodeMembershipDirty(Node *node, Context *context);
+void MarkSceneMembershipDirty(SceneOutline *scene, Context *context);
+void RemoveNodeFromScenes(Node *node, Context *context);
+bool SceneOutline_HasNode(const SceneOutline *scene, const Node *node);
+void SceneOutline_AddNode(SceneOutline *scene, Node *node);
+void SceneOutline_Free(SceneOutline *scene);
+
+// Editor frame, shared by the window front end (main.c) and tools/replay.c
+bool Editor_Init(Context *context, NodePool *pool);
+void Editor_Update(Context *context, const ScreenSettings *screen);
+void Editor_Shutdown(Context *context);
+void HandleMenuAction(MenuAction action, Context *context);
+
 
 
+// Node pool functions
+bool NodePool_Init(NodePool *pool);
+void NodePool_Destroy(NodePool *pool);
+Node* NodePool_Alloc(NodePool *pool);
+void NodePool_Free(NodePool *pool, Node *node);
+int NodePool_SlotCount(const NodePool *pool);
+Node* NodePool_At(const NodePool *pool, int index);
+NodeHandle NodePool_Handle(const Node *node);
+Node* NodePool_Resolve(const NodePool *pool, NodeHandle handle);
+Node* NodePool_Revive(NodePool *pool, NodeHandle handle);
+void NodePool_Touch(NodePool *pool, Node *node);
+void NodePool_QueueChange(NodePool *pool, Node *node);
+void NodePool_ClearChanges(NodePool *pool);
+
+// Edge store functions
+void EdgeStore_Init(EdgeStore *store);
+void EdgeStore_Destroy(EdgeStore *store);
+BezierCurve* EdgeStore_At(const EdgeStore *store, int index);
+int EdgeStore_Add(EdgeStore *store, NodePool *pool, BezierCurve curve);
+void EdgeStore_Remove(EdgeStore *store, NodePool *pool, int index);
+void EdgeStore_Touch(EdgeStore *store, int index);
+void EdgeStore_UpdateBounds(EdgeStore *store, int index);
+int EdgeStore_Query(EdgeStore *store, Rectangle area, int **out, int *capacity);
+
+// Spatial grid functions
+void SpatialGrid_Init(SpatialGrid *grid);
+void SpatialGrid_Destroy(SpatialGrid *grid);
+void SpatialGrid_Update(SpatialGrid *grid, Node *node);
+void SpatialGrid_Remove(SpatialGrid *grid, Node *node);
+Node* SpatialGrid_TopNodeAt(const SpatialGrid *grid, Vector2 point);
+int SpatialGrid_Query(SpatialGrid *grid, Rectangle area, Node ***out, int *capacity);
 
 //  node functions
-Node* CreateNodeAt(Vector2 position, Node *head, Node *nodes, Context *context);
+Node* CreateNodeAt(Vector2 position, Context *context);
 void BringNodeToTop(Node *target, Context *context);
+void ZList_PushBottom(Node *node, Context *context);
+void ZList_PushTop(Node *node, Context *context);
+void ZList_Unlink(Node *node, Context *context);
 void DeleteNodeFromList(Node *target, Context *context);
+const char* Node_TextView(const Node *node, unsigned int *length);
+char* Node_MaterializeText(Node *node);
 
 // Node draw decorations
 void UpdateConnectorPositions(Node *node);
 
 // Helper function
 bool IsMouseDoubleClick(Context *context);
+Rectangle GetNodeBounds(const Node *node);
+bool Node_ValidGeometry(Vector2 position, long long width, long long height);
+bool Scene_ValidBounds(Rectangle bounds);
+bool Camera_ValidView(Vector2 target, float zoom);
+void UpdateBezierBounds(BezierCurve *curve);
 void RegisterBasicConnectors(Node *node);
+const char* GetNodeTypeName(int type); //feed it an enum and get the string
+void GenerateRandomID(char *buffer, int length);
+
+// Scene helpers
+void CreateInitialScene(Context *context);
+void ShrinkSceneToFitContent(SceneOutline *scene, Context *context);
+Rectangle GetSceneLabelBounds(const SceneOutline *scene, char *label, int labelSize);
+Rectangle GetSceneIconBounds(const SceneOutline *scene, int slot);
+Rectangle GetSceneCullBounds(const SceneOutline *scene);
+
+// Scene icon slots, counted from the right edge
+#define SCENE_ICON_DELETE 0
+#define SCENE_ICON_SHRINK 1
+#define SCENE_LABEL_HEIGHT 20.0f
+#define SCENE_LABEL_CHAR_WIDTH 8.0f  // name bar width per character, a little over the 12 px editor font's
 
 // DEBUG
-void Debug_PrintNodes(Node *nodes, Node *head);
-void Debug_ContextAfterDelete(Node *nodes, Context *context);
\ No newline at end of file
+void Debug_PrintNodes(NodePool *pool, Node *head);
+void Debug_ContextAfterDelete(Context *context);
\ No newline at end of file
@@ -0,0 +1,147 @@
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200112L     // mmap, fstat under -std=c99
+#endif
+#include "filemap.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+
+bool FileMap_Open(FileMap *map, const char *path) {
+    *map = (FileMap){0};
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    map->data = view;
+    map->size = (size_t)size.QuadPart;
+    map->file = (intptr_t)file;
+    map->mapping = (intptr_t)mapping;
+    return true;
+}
+
+void FileMap_Close(FileMap *map) {
+    if (!map->data) return;
+    UnmapViewOfFile(map->data);
+    CloseHandle((HANDLE)map->mapping);
+    CloseHandle((HANDLE)map->file);
+    *map = (FileMap){0};
+}
+
+bool File_Sync(FILE *file) {
+    return _commit(_fileno(file)) == 0;
+}
+
+bool File_Replace(const char *fromPath, const char *toPath) {
+    return MoveFileExA(fromPath, toPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+// true when the directory exists afterwards
+bool File_MakeDir(const char *path) {
+    return CreateDirectoryA(path, NULL) || GetLastError() == ERROR_ALREADY_EXISTS;
+}
+
+double Clock_Seconds(void) {
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)frequency.QuadPart;
+}
+
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+bool FileMap_Open(FileMap *map, const char *path) {
+    *map = (FileMap){0};
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    map->data = view;
+    map->size = (size_t)info.st_size;
+    map->file = fd;
+    return true;
+}
+
+void FileMap_Close(FileMap *map) {
+    if (!map->data) return;
+    munmap((void *)map->data, map->size);
+    close((int)map->file);
+    *map = (FileMap){0};
+}
+
+bool File_Sync(FILE *file) {
+    return fsync(fileno(file)) == 0;
+}
+
+// rename() replaces atomically, syncing the directory makes the new name itself survive a crash
+bool File_Replace(const char *fromPath, const char *toPath) {
+    if (rename(fromPath, toPath) != 0) return false;
+
+    char directory[260] = ".";
+    const char *slash = strrchr(toPath, '/');
+    if (slash == toPath) {
+        strcpy(directory, "/");
+    } else if (slash && (size_t)(slash - toPath) < sizeof(directory)) {
+        memcpy(directory, toPath, slash - toPath);
+        directory[slash - toPath] = '\0';
+    }
+
+    int fd = open(directory, O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return true;
+}
+
+bool File_MakeDir(const char *path) {
+    return mkdir(path, 0777) == 0 || errno == EEXIST;
+}
+
+double Clock_Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef FILEMAP_H
+#define FILEMAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Read-only memory mapping of a whole file (mmap on POSIX, MapViewOfFile on Windows).
+// Kept free of raylib so windows.h can be included on its own in filemap.c.
+typedef struct {
+    const unsigned char *data;  // NULL while nothing is mapped
+    size_t size;
+    intptr_t file;              // file descriptor / HANDLE
+    intptr_t mapping;           // mapping object HANDLE, unused on POSIX
+} FileMap;
+
+bool FileMap_Open(FileMap *map, const char *path);
+void FileMap_Close(FileMap *map);
+
+// Durable file replacement: sync the written file, then swap it in with one atomic rename
+bool File_Sync(FILE *file);
+bool File_Replace(const char *fromPath, const char *toPath);
+bool File_MakeDir(const char *path);
+
+// Monotonic seconds for work budgets and timings, needs no window unlike raylib's GetTime
+double Clock_Seconds(void);
+
+#endif
@@ -0,0 +1,173 @@
+#include "raylib.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graphgen.h"
+#include "runtime/narrative.h"
+
+#define GRAPHGEN_CELL_WIDTH 260.0f
+#define GRAPHGEN_CELL_HEIGHT 120.0f
+#define GRAPHGEN_SCENE_GAP 200.0f
+#define GRAPHGEN_REACH 32           // branch targets lie at most this many nodes ahead
+
+// Mostly dialogue with a choice every few lines, like the stories writers build
+GraphSpec GraphGen_DefaultSpec(int nodeCount) {
+    GraphSpec spec = {
+        .nodeCount = nodeCount,
+        .branching = 3,
+        .sceneCount = nodeCount / 500 + 1,
+        .textBytes = 48,
+        .seed = 1,
+        .origin = { 0, 400 }        // below the editor's intro scene
+    };
+    static const int weights[NODE_COUNT] = { 55, 5, 8, 5, 15, 5, 4, 3 };
+    memcpy(spec.typeWeights, weights, sizeof(weights));
+    return spec;
+}
+
+// "55,5,8,5,15,5,4,3": one weight per node type, missing ones are 0. False on anything else.
+bool GraphGen_ParseWeights(GraphSpec *spec, const char *list) {
+    int weights[NODE_COUNT] = {0}, total = 0;
+    const char *p = list;
+    for (int type = 0; type < NODE_COUNT && *p; type++) {
+        char *end;
+        long weight = strtol(p, &end, 10);
+        if (end == p || weight < 0 || weight > 1000000) return false;
+        weights[type] = (int)weight;
+        total += (int)weight;
+        p = end;
+        if (*p == ',') p++;
+        else if (*p) return false;
+    }
+    if (*p || total == 0) return false;
+    memcpy(spec->typeWeights, weights, sizeof(weights));
+    return true;
+}
+
+static NodeType GraphGen_PickType(const GraphSpec *spec, int total, NarrativeRandom *random) {
+    int pick = (int)NarrativeRandom_Below(random, (uint32_t)total);
+    for (int type = 0; type < NODE_COUNT; type++) {
+        if (pick < spec->typeWeights[type]) return (NodeType)type;
+        pick -= spec->typeWeights[type];
+    }
+    return NODE_DEFAULT;
+}
+
+static char* GraphGen_Text(int length, NarrativeRandom *random) {
+    static const char filler[] = "The narrator pauses, then carries on. A door creaks somewhere below. ";
+    char *text = malloc(length + 1);
+    if (!text) return NULL;
+    uint32_t start = NarrativeRandom_Below(random, sizeof(filler) - 1);
+    for (int k = 0; k < length; k++) text[k] = filler[(start + k) % (sizeof(filler) - 1)];
+    text[length] = '\0';
+    return text;
+}
+
+// Curve from the output connector of from to the input of to, as a drag in the editor makes it
+static void GraphGen_Link(Context *context, Node *from, Node *to) {
+    Vector2 start = from->connectors[1].center, end = to->connectors[0].center;
+    EdgeStore_Add(&context->edges, context->pool, (BezierCurve){
+        .points = { start, { start.x + 50, start.y }, { end.x - 50, end.y }, end },
+        .fromNode = NodePool_Handle(from),
+        .toNode = NodePool_Handle(to),
+        .relativeposition = {
+            { start.x - from->position.x, start.y - from->position.y },
+            { end.x - to->position.x, end.y - to->position.y }
+        }
+    });
+}
+
+// Adds the graph to the context. Returns the nodes created, fewer than asked for only when the
+// pool could not grow. Scene membership is queued, UpdateSceneNodeMembership settles it.
+int GraphGen_Build(Context *context, const GraphSpec *spec) {
+    int nodeCount = spec->nodeCount > 0 ? spec->nodeCount : 0;
+    Node **nodes = malloc((nodeCount + 1) * sizeof(Node *));
+    if (!nodes) return 0;
+
+    int totalWeight = 0;
+    for (int type = 0; type < NODE_COUNT; type++) totalWeight += spec->typeWeights[type] > 0 ? spec->typeWeights[type] : 0;
+
+    NarrativeRandom random;
+    NarrativeRandom_Seed(&random, spec->seed, 0x67726170u);
+
+    // === Layout ===
+    int blocks = spec->sceneCount > 0 ? spec->sceneCount : 1;
+    if (spec->sceneCount > 0 && blocks > MAX_SCENES - context->sceneList.count) blocks = MAX_SCENES - context->sceneList.count;
+    if (blocks < 1) blocks = 1;
+    int perBlock = (nodeCount + blocks - 1) / blocks;
+    int columns = (int)ceilf(sqrtf(perBlock * GRAPHGEN_CELL_HEIGHT / GRAPHGEN_CELL_WIDTH));
+    if (columns < 1) columns = 1;
+    int rows = (perBlock + columns - 1) / columns;
+    int blockColumns = (int)ceilf(sqrtf((float)blocks));
+    Vector2 blockSize = { columns * GRAPHGEN_CELL_WIDTH, rows * GRAPHGEN_CELL_HEIGHT + 40 };
+
+    int created = 0;
+    bool full = false;
+    for (int b = 0; b < blocks && created < nodeCount && !full; b++) {
+        Vector2 corner = {
+            spec->origin.x + (b % blockColumns) * (blockSize.x + GRAPHGEN_SCENE_GAP),
+            spec->origin.y + (b / blockColumns) * (blockSize.y + GRAPHGEN_SCENE_GAP)
+        };
+        if (spec->sceneCount > 0) {
+            SceneOutline *scene = &context->sceneList.scenes[context->sceneList.count++];
+            *scene = (SceneOutline){ .bounds = { corner.x, corner.y, blockSize.x, blockSize.y } };
+            snprintf(scene->name, sizeof(scene->name), "Scene %d", b + 1);
+            MarkSceneMembershipDirty(scene, context);
+        }
+
+        for (int k = 0; k < perBlock && created < nodeCount && !full; k++) {
+            Vector2 position = {
+                corner.x + 20 + (k % columns) * GRAPHGEN_CELL_WIDTH,
+                corner.y + 40 + (k / columns) * GRAPHGEN_CELL_HEIGHT
+            };
+            Node *node = CreateNodeAt(position, context);
+            if (!node) {
+                full = true;
+                break;
+            }
+
+            static const char charset[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+            for (int c = 0; c < 8; c++) node->id[c] = charset[NarrativeRandom_Below(&random, sizeof(charset) - 1)];
+            node->type = totalWeight > 0 ? GraphGen_PickType(spec, totalWeight, &random) : NODE_DEFAULT;
+            if (node->type == NODE_DEFAULT && spec->textBytes > 0) {
+                node->data.defaultNode.text = GraphGen_Text(spec->textBytes, &random);
+            }
+            if (node->type == NODE_RANDOM) node->data.randomNode.seed = NarrativeRandom_Next(&random);
+            if (node->type == NODE_RANDOM_BAG) node->data.randomBagNode.seed = NarrativeRandom_Next(&random);
+            nodes[created++] = node;
+        }
+    }
+
+    // === Links ===
+    for (int i = 0; i + 1 < created; i++) {     // the last node ends the chain
+        Node *node = nodes[i];
+        Node *next = nodes[i + 1];
+
+        int targets = 1;
+        switch (node->type) {
+            case NODE_USER_CHOICE:
+            case NODE_RANDOM:
+            case NODE_RANDOM_BAG: targets = spec->branching > 1 ? spec->branching : 1; break;
+            case NODE_SKILL_GATE:
+            case NODE_CONDITIONAL: targets = 2; break;
+            default: break;
+        }
+
+        if (node->type == NODE_DEFAULT) {
+            node->connectors[1].with.to = NodePool_Handle(next);
+            next->connectors[0].with.from = NodePool_Handle(node);
+            node->data.defaultNode.next = (Connection){ NodePool_Handle(node), NodePool_Handle(next) };
+        }
+        GraphGen_Link(context, node, next);
+
+        for (int t = 1; t < targets; t++) {
+            int target = (i + 2 + (int)NarrativeRandom_Below(&random, GRAPHGEN_REACH)) % created;
+            if (target != i) GraphGen_Link(context, node, nodes[target]);
+        }
+    }
+
+    free(nodes);
+    return created;
+}
@@ -0,0 +1,26 @@
+#ifndef GRAPHGEN_H
+#define GRAPHGEN_H
+
+#include "core.h"
+#include <stdint.h>
+
+// Synthetic story graphs for stress tests and benchmarks (tools/gen_project.c, bench/editor_bench.c)
+// Nodes are laid out in a grid inside each scene, the scenes in a grid of their own. Every node
+// continues to the next one, so the graph is one connected chain; branching nodes add targets a
+// little further on, which keeps most curves short like a hand-made story. The same spec and seed
+// give the same graph.
+typedef struct {
+    int nodeCount;
+    int branching;                  // targets of a choice, random or bag node; skill gates and conditions take 2
+    int sceneCount;                 // 0: the nodes in one block without a scene
+    int textBytes;                  // text of each dialogue node
+    int typeWeights[NODE_COUNT];    // relative share of each node type, GetNodeTypeName order
+    uint32_t seed;
+    Vector2 origin;                 // top-left corner of the layout in world space
+} GraphSpec;
+
+GraphSpec GraphGen_DefaultSpec(int nodeCount);
+bool GraphGen_ParseWeights(GraphSpec *spec, const char *list);
+int GraphGen_Build(Context *context, const GraphSpec *spec);
+
+#endif
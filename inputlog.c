@@ -0,0 +1,114 @@
+#include "raylib.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "inputlog.h"
+
+static void Put_F64(unsigned char *p, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Put_U32(p, (uint32_t)bits);
+    Put_U32(p + 4, (uint32_t)(bits >> 32));
+}
+
+static double Get_F64(const unsigned char *p) {
+    uint64_t bits = (uint64_t)Get_U32(p) | ((uint64_t)Get_U32(p + 4) << 32);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+bool InputLog_Create(InputLog *log, const char *path) {
+    *log = (InputLog){0};
+    log->file = fopen(path, "wb");
+    if (!log->file) {
+        TraceLog(LOG_WARNING, "INPUT: Could not create %s", path);
+        return false;
+    }
+
+    unsigned char header[INPUT_LOG_HEADER_SIZE] = {0};
+    memcpy(header, INPUT_LOG_MAGIC, 4);
+    Put_U32(header + 4, INPUT_LOG_VERSION);
+    Put_U32(header + 8, INPUT_LOG_RECORD_SIZE);
+    if (fwrite(header, 1, sizeof(header), log->file) != sizeof(header)) {
+        InputLog_Close(log);
+        return false;
+    }
+    return true;
+}
+
+bool InputLog_Open(InputLog *log, const char *path) {
+    *log = (InputLog){0};
+    log->file = fopen(path, "rb");
+    if (!log->file) return false;
+
+    unsigned char header[INPUT_LOG_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), log->file) != sizeof(header) ||
+        memcmp(header, INPUT_LOG_MAGIC, 4) != 0 ||
+        Get_U32(header + 4) != INPUT_LOG_VERSION ||
+        Get_U32(header + 8) != INPUT_LOG_RECORD_SIZE) {
+        TraceLog(LOG_WARNING, "INPUT: %s is not an input recording of this version", path);
+        InputLog_Close(log);
+        return false;
+    }
+    return true;
+}
+
+// Buffered by stdio, a session that crashes loses at most the last few frames
+bool InputLog_Write(InputLog *log, const InputFrame *frame) {
+    if (!log->file) return false;
+
+    const FrameInput *input = &frame->input;
+    unsigned char p[INPUT_LOG_RECORD_SIZE] = {0};
+    Put_F64(p + 0, input->time);
+    Put_F32(p + 8, input->mouse.x);
+    Put_F32(p + 12, input->mouse.y);
+    Put_F32(p + 16, input->mouseDelta.x);
+    Put_F32(p + 20, input->mouseDelta.y);
+    Put_F32(p + 24, input->wheel);
+    p[28] = (unsigned char)input->buttonsDown;
+    p[29] = (unsigned char)input->buttonsPressed;
+    p[30] = (unsigned char)input->buttonsReleased;
+    p[31] = (unsigned char)((input->keyActivity ? INPUT_LOG_KEY_ACTIVITY : 0) | (input->resized ? INPUT_LOG_RESIZED : 0));
+    Put_U16(p + 32, (uint16_t)frame->screenWidth);
+    Put_U16(p + 34, (uint16_t)frame->screenHeight);
+    p[36] = (unsigned char)frame->menuAction;
+    Put_U16(p + 38, (uint16_t)(int16_t)frame->playtestInput);
+
+    if (fwrite(p, 1, sizeof(p), log->file) != sizeof(p)) return false;
+    log->frames++;
+    return true;
+}
+
+// False at the end of the recording, a torn last record included
+bool InputLog_Read(InputLog *log, InputFrame *frame) {
+    unsigned char p[INPUT_LOG_RECORD_SIZE];
+    if (!log->file || fread(p, 1, sizeof(p), log->file) != sizeof(p)) return false;
+
+    *frame = (InputFrame){
+        .input = {
+            .time = Get_F64(p + 0),
+            .mouse = { Get_F32(p + 8), Get_F32(p + 12) },
+            .mouseDelta = { Get_F32(p + 16), Get_F32(p + 20) },
+            .wheel = Get_F32(p + 24),
+            .buttonsDown = p[28],
+            .buttonsPressed = p[29],
+            .buttonsReleased = p[30],
+            .keyActivity = (p[31] & INPUT_LOG_KEY_ACTIVITY) != 0,
+            .resized = (p[31] & INPUT_LOG_RESIZED) != 0
+        },
+        .screenWidth = Get_U16(p + 32),
+        .screenHeight = Get_U16(p + 34),
+        .menuAction = p[36] <= MENU_ACTION_BUILD_STORY ? (MenuAction)p[36] : MENU_ACTION_NONE,
+        .playtestInput = (int16_t)Get_U16(p + 38)
+    };
+    log->frames++;
+    return true;
+}
+
+void InputLog_Close(InputLog *log) {
+    if (log->file) fclose(log->file);
+    log->file = NULL;
+}
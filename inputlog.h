@@ -0,0 +1,45 @@
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include "core.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// Input recording (.ninput)
+// Started with --record <file>, the editor appends one record per frame it runs: the FrameInput
+// the core saw, the size of the view, and what the raygui widgets answered (menu button and
+// playtest panel), so a replay needs neither the window nor raygui. tools/replay.c feeds the
+// records back through Editor_Update with the recorded time, frame by frame.
+//
+// Little-endian. Header: magic[4], u32 version, u32 record size, u32 0.
+// Record: f64 time, f32 mouse x, y, f32 delta x, y, f32 wheel, u8 buttons down, pressed,
+// released, u8 flags (1 key activity, 2 resized), u16 view width, height, u8 menu action,
+// u8 0, i16 playtest input.
+#define INPUT_LOG_MAGIC "NPIN"
+#define INPUT_LOG_VERSION 1
+#define INPUT_LOG_HEADER_SIZE 16
+#define INPUT_LOG_RECORD_SIZE 40
+
+#define INPUT_LOG_KEY_ACTIVITY 1
+#define INPUT_LOG_RESIZED 2
+
+typedef struct {
+    FrameInput input;
+    int screenWidth;
+    int screenHeight;
+    MenuAction menuAction;
+    int playtestInput;      // DrawPlaytestPanel result, PLAYTEST_INPUT_NONE on most frames
+} InputFrame;
+
+typedef struct {
+    FILE *file;             // NULL while closed
+    uint32_t frames;        // records written or read so far
+} InputLog;
+
+bool InputLog_Create(InputLog *log, const char *path);
+bool InputLog_Open(InputLog *log, const char *path);
+bool InputLog_Write(InputLog *log, const InputFrame *frame);
+bool InputLog_Read(InputLog *log, InputFrame *frame);
+void InputLog_Close(InputLog *log);
+
+#endif
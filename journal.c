@@ -0,0 +1,848 @@
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "autosave.h"
+#include "journal.h"
+
+#define JOURNAL_MAX_LINKS (MAX_CONNECTORS + 10)    // connectors + the stack node next[] table
+
+struct Journal {
+    char path[260];             // project file
+    char logPath[264];
+    char tmpPath[268];
+    uint32_t seq;               // last batch written or replayed
+    uint32_t logBytes;          // end of the last valid batch, the next batch is written here
+    uint32_t projectBytes;      // compaction starts once the log is bigger than the project file
+    // what the log already covers, anything newer goes into the next batch
+    long long savedTopKey;
+    long long savedBottomKey;
+    unsigned int sceneHash;
+    Camera2D camera;
+    // compaction in flight
+    bool compacting;
+    uint32_t compactLogBytes;   // log size when the snapshot was taken, every batch before it is folded
+};
+
+typedef struct Journal Journal;
+
+// One Connection value a node owns, same kinds as the project file links
+typedef struct {
+    ProjectLinkKind kind;
+    int slot;
+    Connection connection;
+} JournalLink;
+
+// Changed node on its way into a batch
+typedef struct {
+    Node *node;
+    int group;          // 0: z-order unchanged, 1: raised, 2: lowered
+    long long order;    // replay order inside the group
+} JournalPut;
+
+static uint32_t Journal_Checksum(const unsigned char *data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+// Scenes are few, hashing them on save is cheaper than tracking every bounds and member edit
+static unsigned int Journal_SceneHash(const SceneList *list) {
+    unsigned int hash = 2166136261u ^ (unsigned int)list->count;
+    for (int s = 0; s < list->count; s++) {
+        const SceneOutline *scene = &list->scenes[s];
+        hash = Journal_Checksum((const unsigned char *)&scene->bounds, sizeof(scene->bounds)) ^ (hash * 16777619u);
+        hash = Journal_Checksum((const unsigned char *)scene->name, sizeof(scene->name)) ^ (hash * 16777619u);
+        hash = Journal_Checksum((const unsigned char *)scene->containedNodes, scene->nodeCount * sizeof(NodeHandle)) ^ (hash * 16777619u);
+    }
+    return hash;
+}
+
+static uint32_t Journal_Key(const NodePool *pool, NodeHandle handle) {
+    Node *node = NodePool_Resolve(pool, handle);
+    return node ? node->saveKey : 0;
+}
+
+static int Journal_CollectLinks(const Node *node, JournalLink links[JOURNAL_MAX_LINKS]) {
+    int count = 0;
+    for (int c = 0; c < MAX_CONNECTORS; c++) {
+        links[count++] = (JournalLink){ PROJECT_LINK_CONNECTOR, c, node->connectors[c].with };
+    }
+    if (node->type == NODE_DEFAULT) {
+        links[count++] = (JournalLink){ PROJECT_LINK_DEFAULT_NEXT, 0, node->data.defaultNode.next };
+    } else if (node->type == NODE_STACK) {
+        for (int i = 0; i < 10; i++) {
+            links[count++] = (JournalLink){ PROJECT_LINK_STACK_NEXT, i, node->data.stackNode.next[i] };
+        }
+    }
+    return count;
+}
+
+// Where the state the log already covers is remembered, called after every save and load
+static void Journal_MarkSaved(Context *context, Journal *journal) {
+    NodePool_ClearChanges(context->pool);
+    journal->savedTopKey = context->zTopKey;
+    journal->savedBottomKey = context->zBottomKey;
+    journal->sceneHash = Journal_SceneHash(&context->sceneList);
+    journal->camera = context->camera;
+}
+
+static Journal* Journal_Open(Context *context, const char *path) {
+    Journal_Close(context);
+
+    Journal *journal = calloc(1, sizeof(Journal));
+    if (!journal) return NULL;
+    snprintf(journal->path, sizeof(journal->path), "%s", path);
+    snprintf(journal->logPath, sizeof(journal->logPath), "%s.log", path);
+    snprintf(journal->tmpPath, sizeof(journal->tmpPath), "%s.log.tmp", path);
+    context->journal = journal;
+    return journal;
+}
+
+// Replaces the log with a header and the given batches, synced and renamed like the project file
+static bool Journal_RewriteLog(Journal *journal, const unsigned char *batches, uint32_t size) {
+    unsigned char header[JOURNAL_HEADER_SIZE] = {0};
+    memcpy(header, JOURNAL_MAGIC, 4);
+    Put_U32(header + 4, JOURNAL_VERSION);
+
+    FILE *file = fopen(journal->tmpPath, "wb");
+    if (!file) return false;
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    if (ok && size) ok = fwrite(batches, 1, size, file) == size;
+    ok = ok && fflush(file) == 0 && File_Sync(file);
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || !File_Replace(journal->tmpPath, journal->logPath)) {
+        remove(journal->tmpPath);
+        return false;
+    }
+
+    journal->logBytes = JOURNAL_HEADER_SIZE + size;
+    return true;
+}
+
+// === SAVE ===
+// A curve is saved with the node it starts at. A moved node drags the ends of its incoming
+// curves along, so the nodes those curves start at go into the batch as well.
+static void Journal_QueueCurveSources(Context *context) {
+    NodePool *pool = context->pool;
+    int changedCount = pool->changedCount;
+
+    for (int i = 0; i < changedCount; i++) {
+        Node *node = NodePool_At(pool, pool->changedSlots[i]);
+        if (node->type == NODE_COUNT) continue;
+
+        for (int ref = node->firstEdge; ref != -1; ) {
+            BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+            int side = EDGE_REF_SIDE(ref);
+            if (side == 1) {
+                Node *source = NodePool_Resolve(pool, curve->fromNode);
+                if (source) NodePool_QueueChange(pool, source);
+            }
+            ref = curve->nextEdge[side];
+        }
+    }
+}
+
+static unsigned char* Journal_Record(ByteBuffer *batch, JournalRecordKind kind, uint16_t flags, size_t size) {
+    unsigned char *p = ByteBuffer_Reserve(batch, JOURNAL_RECORD_HEADER_SIZE + size);
+    if (!p) return NULL;
+    Put_U16(p + 0, (uint16_t)kind);
+    Put_U16(p + 2, flags);
+    Put_U32(p + 4, (uint32_t)size);
+    return p + JOURNAL_RECORD_HEADER_SIZE;
+}
+
+static void Journal_PutNode(ByteBuffer *batch, const Context *context, const Node *node, uint16_t flags) {
+    const NodePool *pool = context->pool;
+
+    JournalLink links[JOURNAL_MAX_LINKS];
+    uint32_t linkKeys[JOURNAL_MAX_LINKS][2];
+    int linkTotal = Journal_CollectLinks(node, links);
+    int linkCount = 0;
+    for (int i = 0; i < linkTotal; i++) {
+        uint32_t from = Journal_Key(pool, links[i].connection.from);
+        uint32_t to = Journal_Key(pool, links[i].connection.to);
+        if (!from && !to) continue;
+        links[linkCount] = links[i];
+        linkKeys[linkCount][0] = from;
+        linkKeys[linkCount][1] = to;
+        linkCount++;
+    }
+
+    uint32_t curveCount = 0;
+    for (int ref = node->firstEdge; ref != -1; ) {
+        BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+        if (EDGE_REF_SIDE(ref) == 0) curveCount++;
+        ref = curve->nextEdge[EDGE_REF_SIDE(ref)];
+    }
+
+    unsigned int textLength = 0;
+    const char *text = Node_TextView(node, &textLength);
+    size_t textSize = (textLength + 3) & ~(size_t)3;
+    size_t size = JOURNAL_NODE_FIXED_SIZE + textSize + linkCount * JOURNAL_LINK_SIZE + curveCount * JOURNAL_CURVE_SIZE;
+
+    unsigned char *p = Journal_Record(batch, JOURNAL_RECORD_NODE_PUT, flags, size);
+    if (!p) return;
+    memset(p, 0, JOURNAL_NODE_FIXED_SIZE + textSize);
+
+    Put_U32(p + 0, node->saveKey);
+    Put_F32(p + 4, node->position.x);
+    Put_F32(p + 8, node->position.y);
+    Put_U32(p + 12, (uint32_t)node->width);
+    Put_U32(p + 16, (uint32_t)node->height);
+    p[20] = (unsigned char)node->type;
+    p[21] = node->isExpanded ? 1 : 0;
+    memcpy(p + 24, node->id, 8);
+    Put_U32(p + 32, (uint32_t)NodePayloadValue(node));
+    Put_U32(p + 36, textLength);
+    Put_U32(p + 40, (uint32_t)linkCount);
+    Put_U32(p + 44, curveCount);
+    if (textLength) memcpy(p + JOURNAL_NODE_FIXED_SIZE, text, textLength);
+    p += JOURNAL_NODE_FIXED_SIZE + textSize;
+
+    for (int i = 0; i < linkCount; i++, p += JOURNAL_LINK_SIZE) {
+        Put_U16(p + 0, (uint16_t)links[i].kind);
+        Put_U16(p + 2, (uint16_t)links[i].slot);
+        Put_U32(p + 4, linkKeys[i][0]);
+        Put_U32(p + 8, linkKeys[i][1]);
+    }
+
+    for (int ref = node->firstEdge; ref != -1; ) {
+        BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+        if (EDGE_REF_SIDE(ref) == 0) {
+            Put_U32(p + 0, Journal_Key(pool, curve->toNode));
+            for (int k = 0; k < 4; k++) {
+                Put_F32(p + 4 + k * 8, curve->points[k].x);
+                Put_F32(p + 8 + k * 8, curve->points[k].y);
+            }
+            for (int k = 0; k < 2; k++) {
+                Put_F32(p + 36 + k * 8, curve->relativeposition[k].x);
+                Put_F32(p + 40 + k * 8, curve->relativeposition[k].y);
+            }
+            p += JOURNAL_CURVE_SIZE;
+        }
+        ref = curve->nextEdge[EDGE_REF_SIDE(ref)];
+    }
+}
+
+static void Journal_PutScenes(ByteBuffer *batch, const Context *context) {
+    const SceneList *list = &context->sceneList;
+
+    size_t size = 4;
+    for (int s = 0; s < list->count; s++) {
+        const SceneOutline *scene = &list->scenes[s];
+        size += 16 + sizeof(scene->name) + 4;
+        for (int n = 0; n < scene->nodeCount; n++) {
+            if (NodePool_Resolve(context->pool, scene->containedNodes[n])) size += 4;
+        }
+    }
+
+    unsigned char *p = Journal_Record(batch, JOURNAL_RECORD_SCENES, 0, size);
+    if (!p) return;
+    Put_U32(p, (uint32_t)list->count);
+    p += 4;
+
+    for (int s = 0; s < list->count; s++) {
+        const SceneOutline *scene = &list->scenes[s];
+        Put_F32(p + 0, scene->bounds.x);
+        Put_F32(p + 4, scene->bounds.y);
+        Put_F32(p + 8, scene->bounds.width);
+        Put_F32(p + 12, scene->bounds.height);
+        memcpy(p + 16, scene->name, sizeof(scene->name));
+        p += 16 + sizeof(scene->name);
+
+        unsigned char *count = p;
+        uint32_t memberCount = 0;
+        p += 4;
+        for (int n = 0; n < scene->nodeCount; n++) {
+            Node *node = NodePool_Resolve(context->pool, scene->containedNodes[n]);
+            if (!node) continue;
+            Put_U32(p, node->saveKey);
+            p += 4;
+            memberCount++;
+        }
+        Put_U32(count, memberCount);
+    }
+}
+
+static int ComparePut(const void *a, const void *b) {
+    const JournalPut *pa = a, *pb = b;
+    if (pa->group != pb->group) return pa->group - pb->group;
+    return (pa->order > pb->order) - (pa->order < pb->order);
+}
+
+// Writes everything the pool and the scenes changed since the last batch as one new batch
+static bool Journal_Append(Context *context, Journal *journal, JournalStats *stats) {
+    NodePool *pool = context->pool;
+    ByteBuffer batch = {0};
+    uint32_t records = 0;
+
+    // === Removed nodes first, a revived node comes back through its put ===
+    for (int i = 0; i < pool->removedCount; i++) {
+        unsigned char *p = Journal_Record(&batch, JOURNAL_RECORD_NODE_REMOVE, 0, 4);
+        if (p) Put_U32(p, pool->removedKeys[i]);
+        records++;
+    }
+
+    // === Changed nodes. Raised nodes replay bottom to top, lowered ones top to bottom,
+    // so pushing them onto the z-list one by one rebuilds the same order ===
+    JournalPut *puts = malloc((pool->changedCount + 1) * sizeof(JournalPut));
+    if (!puts) {
+        free(batch.data);
+        return false;
+    }
+    int putCount = 0;
+    for (int i = 0; i < pool->changedCount; i++) {
+        Node *node = NodePool_At(pool, pool->changedSlots[i]);
+        if (node->type == NODE_COUNT) continue;
+
+        JournalPut *put = &puts[putCount++];
+        put->node = node;
+        put->group = node->zKey > journal->savedTopKey ? 1 : node->zKey < journal->savedBottomKey ? 2 : 0;
+        put->order = put->group == 2 ? -node->zKey : node->zKey;
+    }
+    qsort(puts, putCount, sizeof(JournalPut), ComparePut);
+    for (int i = 0; i < putCount; i++) {
+        uint16_t flags = puts[i].group == 1 ? JOURNAL_PUT_TOP : puts[i].group == 2 ? JOURNAL_PUT_BOTTOM : 0;
+        Journal_PutNode(&batch, context, puts[i].node, flags);
+        records++;
+    }
+    free(puts);
+
+    // === Scenes and view, whole, only when they differ ===
+    unsigned int sceneHash = Journal_SceneHash(&context->sceneList);
+    if (sceneHash != journal->sceneHash) {
+        Journal_PutScenes(&batch, context);
+        records++;
+    }
+    Camera2D camera = context->camera;
+    if (camera.target.x != journal->camera.target.x || camera.target.y != journal->camera.target.y ||
+        camera.zoom != journal->camera.zoom) {
+        unsigned char *p = Journal_Record(&batch, JOURNAL_RECORD_VIEW, 0, PROJECT_VIEW_RECORD_SIZE);
+        if (p) {
+            Put_F32(p + 0, camera.target.x);
+            Put_F32(p + 4, camera.target.y);
+            Put_F32(p + 8, camera.zoom);
+        }
+        records++;
+    }
+
+    if (batch.failed) {
+        free(batch.data);
+        TraceLog(LOG_WARNING, "JOURNAL: Out of memory while saving [%s]", journal->path);
+        return false;
+    }
+    if (records == 0) {
+        Journal_MarkSaved(context, journal);
+        stats->logBytes = journal->logBytes;
+        return true;
+    }
+
+    // === Write the batch over whatever follows the last valid one, then make it durable ===
+    unsigned char header[JOURNAL_BATCH_HEADER_SIZE];
+    Put_U32(header + 0, journal->seq + 1);
+    Put_U32(header + 4, (uint32_t)batch.size);
+    Put_U32(header + 8, Journal_Checksum(batch.data, batch.size));
+
+    FILE *file = fopen(journal->logPath, "r+b");
+    bool ok = file != NULL;
+    if (ok) ok = fseek(file, (long)journal->logBytes, SEEK_SET) == 0;
+    if (ok) ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    if (ok) ok = fwrite(batch.data, 1, batch.size, file) == batch.size;
+    if (ok) ok = fflush(file) == 0 && File_Sync(file);
+    if (file) ok = (fclose(file) == 0) && ok;
+    free(batch.data);
+
+    if (!ok) {
+        TraceLog(LOG_WARNING, "JOURNAL: Failed appending to [%s]", journal->logPath);
+        return false;
+    }
+
+    journal->seq++;
+    journal->logBytes += (uint32_t)(sizeof(header) + batch.size);
+    Journal_MarkSaved(context, journal);
+    stats->records = records;
+    stats->batches = 1;
+    stats->bytes = (uint32_t)(sizeof(header) + batch.size);
+    stats->logBytes = journal->logBytes;
+    return true;
+}
+
+// Rewrites the project file and starts an empty log
+static bool Journal_FullSave(Context *context, const char *path, JournalStats *stats) {
+    Journal *journal = context->journal;
+    bool fresh = !journal || strcmp(journal->path, path) != 0;
+
+    // a compaction in flight would rename an older snapshot over the new file
+    if (journal && journal->compacting) Autosave_Cancel(context);
+
+    // A log left by another session may continue past batch 0, drop it before the project file
+    // says "nothing folded yet". An open journal keeps its log until the file contains it.
+    if (fresh) {
+        journal = Journal_Open(context, path);
+        if (!journal) return false;
+        if (!Journal_RewriteLog(journal, NULL, 0)) {
+            TraceLog(LOG_WARNING, "JOURNAL: Could not create [%s]", journal->logPath);
+        }
+    }
+
+    if (!Project_SaveAt(context, path, journal->seq, true, &stats->project)) return false;
+    if (!fresh && !Journal_RewriteLog(journal, NULL, 0)) {
+        // the old batches are all folded into the file now, appending after them is still correct
+        TraceLog(LOG_WARNING, "JOURNAL: Could not reset [%s]", journal->logPath);
+    }
+
+    journal->projectBytes = stats->project.bytes;
+    Journal_MarkSaved(context, journal);
+    stats->fullSave = true;
+    stats->logBytes = journal->logBytes;
+    return true;
+}
+
+// Folds the log back into the project file once it is bigger than the file itself
+static void Journal_MaybeCompact(Context *context, Journal *journal, JournalStats *stats) {
+    if (journal->compacting || journal->logBytes < JOURNAL_COMPACT_MIN_BYTES) return;
+    if (journal->logBytes < journal->projectBytes) return;
+
+    // no worker thread: compact right away, it is a full save
+    if (!context->autosave) {
+        Journal_FullSave(context, journal->path, stats);
+        return;
+    }
+    if (Autosave_IsBusy(context)) return;  // the next save tries again
+
+    // the project file is about to be replaced, text still read from its mapping has to move out
+    if (context->projectMap.data && strcmp(context->projectMapPath, journal->path) == 0) {
+        if (!Project_DetachMap(context)) return;
+        NodePool_ClearChanges(context->pool);  // taking the text over is not an edit
+    }
+
+    if (!Autosave_Compact(context, journal->path, journal->seq)) return;
+    journal->compacting = true;
+    journal->compactLogBytes = journal->logBytes;
+    stats->compacting = true;
+}
+
+bool Journal_Save(Context *context, const char *path, JournalStats *stats) {
+    Journal *journal = context->journal;
+    JournalStats result = {0};
+    bool appending = journal && strcmp(journal->path, path) == 0;
+    bool ok = false;
+
+    if (appending) Journal_QueueCurveSources(context);
+    if (appending && !context->pool->changesLost) {
+        ok = Journal_Append(context, journal, &result);
+        if (ok) Journal_MaybeCompact(context, journal, &result);
+    }
+    if (!ok) ok = Journal_FullSave(context, path, &result);
+
+    if (stats) *stats = result;
+    return ok;
+}
+
+// Called by the autosave worker hand-off once the snapshot replaced (or failed to replace) the project file
+void Journal_CompactDone(Context *context, bool ok, uint32_t projectBytes) {
+    Journal *journal = context->journal;
+    if (!journal || !journal->compacting) return;
+    journal->compacting = false;
+
+    if (!ok) {
+        TraceLog(LOG_WARNING, "JOURNAL: Compacting [%s] failed, the log is kept", journal->path);
+        return;
+    }
+    journal->projectBytes = projectBytes;
+
+    // Batches appended while the snapshot was written are not in the file, they stay
+    uint32_t tailSize = journal->logBytes - journal->compactLogBytes;
+    unsigned char *tail = malloc(tailSize + 1);
+    FILE *file = tail ? fopen(journal->logPath, "rb") : NULL;
+    bool read = file && fseek(file, (long)journal->compactLogBytes, SEEK_SET) == 0 &&
+                fread(tail, 1, tailSize, file) == tailSize;
+    if (file) fclose(file);
+
+    // replay skips the folded batches anyway, a log that could not be rewritten only costs space
+    uint32_t oldBytes = journal->logBytes;
+    if (read && Journal_RewriteLog(journal, tail, tailSize)) {
+        TraceLog(LOG_INFO, "JOURNAL: Compacted [%s], log %u -> %u bytes", journal->path, oldBytes, journal->logBytes);
+    } else {
+        TraceLog(LOG_WARNING, "JOURNAL: Could not shrink [%s]", journal->logPath);
+    }
+    free(tail);
+}
+
+// === LOAD ===
+// saveKey -> node, open addressing. Removed nodes keep their entry with a NULL node.
+typedef struct {
+    uint32_t key;
+    Node *node;
+} KeySlot;
+
+typedef struct {
+    KeySlot *slots;
+    uint32_t capacity;  // power of two
+    uint32_t count;
+} KeyMap;
+
+static KeySlot* KeyMap_Find(const KeyMap *map, uint32_t key) {
+    uint32_t mask = map->capacity - 1;
+    for (uint32_t i = (key * 2654435761u) & mask; ; i = (i + 1) & mask) {
+        if (map->slots[i].key == key || map->slots[i].key == 0) return &map->slots[i];
+    }
+}
+
+static bool KeyMap_Put(KeyMap *map, uint32_t key, Node *node) {
+    if ((map->count + 1) * 2 > map->capacity) {
+        KeyMap grown = { .capacity = map->capacity ? map->capacity * 2 : 1024 };
+        grown.slots = calloc(grown.capacity, sizeof(KeySlot));
+        if (!grown.slots) return false;
+        for (uint32_t i = 0; i < map->capacity; i++) {
+            if (map->slots[i].key) *KeyMap_Find(&grown, map->slots[i].key) = map->slots[i];
+        }
+        grown.count = map->count;
+        free(map->slots);
+        *map = grown;
+    }
+
+    KeySlot *slot = KeyMap_Find(map, key);
+    if (slot->key == 0) map->count++;
+    *slot = (KeySlot){ key, node };
+    return true;
+}
+
+static Node* KeyMap_Get(const KeyMap *map, uint32_t key) {
+    if (key == 0 || map->capacity == 0) return NULL;
+    return KeyMap_Find(map, key)->node;
+}
+
+// Checks every record of a batch before any of it is applied
+static bool Journal_CheckBatch(const unsigned char *data, uint32_t size) {
+    uint32_t offset = 0;
+    while (offset < size) {
+        if (size - offset < JOURNAL_RECORD_HEADER_SIZE) return false;
+        uint16_t kind = Get_U16(data + offset);
+        uint32_t recordSize = Get_U32(data + offset + 4);
+        const unsigned char *p = data + offset + JOURNAL_RECORD_HEADER_SIZE;
+        offset += JOURNAL_RECORD_HEADER_SIZE;
+        if (recordSize > size - offset) return false;
+        offset += recordSize;
+
+        if (kind == JOURNAL_RECORD_NODE_REMOVE) {
+            if (recordSize != 4) return false;
+        } else if (kind == JOURNAL_RECORD_NODE_PUT) {
+            if (recordSize < JOURNAL_NODE_FIXED_SIZE || Get_U32(p) == 0 || p[20] >= NODE_COUNT) return false;
+            uint64_t textSize = ((uint64_t)Get_U32(p + 36) + 3) & ~(uint64_t)3;
+            uint64_t links = Get_U32(p + 40), curves = Get_U32(p + 44);
+            if (JOURNAL_NODE_FIXED_SIZE + textSize + links * JOURNAL_LINK_SIZE + curves * JOURNAL_CURVE_SIZE != recordSize) return false;
+            if (!Node_ValidGeometry((Vector2){ Get_F32(p + 4), Get_F32(p + 8) }, (int32_t)Get_U32(p + 12), (int32_t)Get_U32(p + 16))) return false;
+
+            const unsigned char *link = p + JOURNAL_NODE_FIXED_SIZE + textSize;
+            for (uint64_t i = 0; i < links; i++, link += JOURNAL_LINK_SIZE) {
+                uint16_t linkKind = Get_U16(link), slot = Get_U16(link + 2);
+                if (linkKind == PROJECT_LINK_CONNECTOR && slot >= MAX_CONNECTORS) return false;
+                if (linkKind == PROJECT_LINK_STACK_NEXT && slot >= 10) return false;
+            }
+        } else if (kind == JOURNAL_RECORD_SCENES) {
+            if (recordSize < 4 || Get_U32(p) > MAX_SCENES) return false;
+            uint32_t at = 4;
+            for (uint32_t s = 0; s < Get_U32(p); s++) {
+                uint32_t head = 16 + sizeof(((SceneOutline *)0)->name);
+                if (recordSize - at < head + 4) return false;
+                const unsigned char *b = p + at;
+                if (!Scene_ValidBounds((Rectangle){ Get_F32(b + 0), Get_F32(b + 4), Get_F32(b + 8), Get_F32(b + 12) })) return false;
+                uint32_t members = Get_U32(p + at + head);
+                at += head + 4;
+                if (members > (recordSize - at) / 4) return false;
+                at += members * 4;
+            }
+            if (at != recordSize) return false;
+        } else if (kind == JOURNAL_RECORD_VIEW) {
+            if (recordSize != PROJECT_VIEW_RECORD_SIZE) return false;
+            if (!Camera_ValidView((Vector2){ Get_F32(p + 0), Get_F32(p + 4) }, Get_F32(p + 8))) return false;
+        }
+        // unknown kinds come from newer editors, they are skipped
+    }
+    return true;
+}
+
+// Pass 1 of a put: the node itself, created on first sight
+static bool Journal_ApplyNode(Context *context, KeyMap *map, const unsigned char *p, uint16_t flags) {
+    NodePool *pool = context->pool;
+    uint32_t key = Get_U32(p);
+    Node *node = KeyMap_Get(map, key);
+    bool created = node == NULL;
+
+    if (created) {
+        node = NodePool_Alloc(pool);
+        if (!node) return false;
+        node->saveKey = key;
+        if (key > pool->lastSaveKey) pool->lastSaveKey = key;
+        if (!KeyMap_Put(map, key, node)) return false;
+    }
+
+    // the union belongs to the saved type, links are filled in by pass 2
+    if (node->type == NODE_DEFAULT) Autosave_ReleaseText(context, node->data.defaultNode.text);
+    memset(&node->data, 0, sizeof(node->data));
+
+    node->position = (Vector2){ Get_F32(p + 4), Get_F32(p + 8) };
+    node->width = (int)Get_U32(p + 12);
+    node->height = (int)Get_U32(p + 16);
+    node->type = (NodeType)p[20];
+    node->isExpanded = (p[21] & 1) != 0;
+    memcpy(node->id, p + 24, 8);
+    node->id[8] = '\0';
+    SetNodePayloadValue(node, (int32_t)Get_U32(p + 32));
+
+    uint32_t textLength = Get_U32(p + 36);
+    if (node->type == NODE_DEFAULT && textLength > 0) {
+        char *text = malloc(textLength + 1);
+        if (!text) return false;
+        memcpy(text, p + JOURNAL_NODE_FIXED_SIZE, textLength);
+        text[textLength] = '\0';
+        node->data.defaultNode.text = text;
+    }
+
+    if (created) RegisterBasicConnectors(node);
+    else UpdateConnectorPositions(node);
+
+    if (created || (flags & (JOURNAL_PUT_TOP | JOURNAL_PUT_BOTTOM))) {
+        if (!created) ZList_Unlink(node, context);
+        if (flags & JOURNAL_PUT_BOTTOM) ZList_PushBottom(node, context);
+        else ZList_PushTop(node, context);
+    }
+    SpatialGrid_Update(&context->grid, node);
+    return true;
+}
+
+// Pass 2 of a put: links and outgoing curves, every node of the batch exists by now
+static bool Journal_ApplyLinks(Context *context, const KeyMap *map, const unsigned char *p) {
+    Node *node = KeyMap_Get(map, Get_U32(p));
+    if (!node) return true;
+
+    for (int c = 0; c < MAX_CONNECTORS; c++) node->connectors[c].with = (Connection){0};
+    if (node->type == NODE_DEFAULT) node->data.defaultNode.next = (Connection){0};
+    if (node->type == NODE_STACK) memset(node->data.stackNode.next, 0, sizeof(node->data.stackNode.next));
+
+    uint32_t textSize = (Get_U32(p + 36) + 3) & ~3u;
+    uint32_t linkCount = Get_U32(p + 40);
+    uint32_t curveCount = Get_U32(p + 44);
+    const unsigned char *link = p + JOURNAL_NODE_FIXED_SIZE + textSize;
+
+    for (uint32_t i = 0; i < linkCount; i++, link += JOURNAL_LINK_SIZE) {
+        uint16_t slot = Get_U16(link + 2);
+        Connection connection = {
+            .from = NodePool_Handle(KeyMap_Get(map, Get_U32(link + 4))),
+            .to = NodePool_Handle(KeyMap_Get(map, Get_U32(link + 8)))
+        };
+        switch (Get_U16(link)) {
+            case PROJECT_LINK_CONNECTOR:
+                node->connectors[slot].with = connection;
+                break;
+            case PROJECT_LINK_DEFAULT_NEXT:
+                if (node->type == NODE_DEFAULT) node->data.defaultNode.next = connection;
+                break;
+            case PROJECT_LINK_STACK_NEXT:
+                if (node->type == NODE_STACK) node->data.stackNode.next[slot] = connection;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the put lists every curve starting here, the old ones go
+    for (;;) {
+        int start = -1;
+        for (int ref = node->firstEdge; ref != -1; ) {
+            BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+            if (EDGE_REF_SIDE(ref) == 0) {
+                start = EDGE_REF_INDEX(ref);
+                break;
+            }
+            ref = curve->nextEdge[EDGE_REF_SIDE(ref)];
+        }
+        if (start == -1) break;
+        EdgeStore_Remove(&context->edges, context->pool, start);
+    }
+
+    const unsigned char *c = link;
+    for (uint32_t i = 0; i < curveCount; i++, c += JOURNAL_CURVE_SIZE) {
+        Node *to = KeyMap_Get(map, Get_U32(c));
+        if (!to) continue;
+
+        BezierCurve curve = { .fromNode = NodePool_Handle(node), .toNode = NodePool_Handle(to) };
+        for (int k = 0; k < 4; k++) {
+            curve.points[k] = (Vector2){ Get_F32(c + 4 + k * 8), Get_F32(c + 8 + k * 8) };
+        }
+        for (int k = 0; k < 2; k++) {
+            curve.relativeposition[k] = (Vector2){ Get_F32(c + 36 + k * 8), Get_F32(c + 40 + k * 8) };
+        }
+        if (EdgeStore_Add(&context->edges, context->pool, curve) < 0) return false;
+    }
+    return true;
+}
+
+static void Journal_ApplyScenes(Context *context, const KeyMap *map, const unsigned char *p) {
+    SceneList *list = &context->sceneList;
+    for (int s = 0; s < list->count; s++) SceneOutline_Free(&list->scenes[s]);
+    list->count = 0;
+
+    uint32_t count = Get_U32(p);
+    p += 4;
+    for (uint32_t s = 0; s < count; s++) {
+        SceneOutline *scene = &list->scenes[list->count++];
+        *scene = (SceneOutline){
+            .bounds = { Get_F32(p + 0), Get_F32(p + 4), Get_F32(p + 8), Get_F32(p + 12) }
+        };
+        memcpy(scene->name, p + 16, sizeof(scene->name));
+        scene->name[sizeof(scene->name) - 1] = '\0';
+        p += 16 + sizeof(scene->name);
+
+        uint32_t members = Get_U32(p);
+        p += 4;
+        for (uint32_t m = 0; m < members; m++, p += 4) {
+            Node *node = KeyMap_Get(map, Get_U32(p));
+            if (node) SceneOutline_AddNode(scene, node);
+        }
+    }
+}
+
+static bool Journal_ApplyBatch(Context *context, KeyMap *map, const unsigned char *data, uint32_t size, uint32_t *records) {
+    // === Pass 1: removals, node fields, z-order and view ===
+    for (uint32_t offset = 0; offset < size; ) {
+        uint16_t kind = Get_U16(data + offset);
+        uint16_t flags = Get_U16(data + offset + 2);
+        uint32_t recordSize = Get_U32(data + offset + 4);
+        const unsigned char *p = data + offset + JOURNAL_RECORD_HEADER_SIZE;
+        offset += JOURNAL_RECORD_HEADER_SIZE + recordSize;
+        (*records)++;
+
+        if (kind == JOURNAL_RECORD_NODE_REMOVE) {
+            uint32_t key = Get_U32(p);
+            Node *node = KeyMap_Get(map, key);
+            if (node) {
+                DeleteNodeFromList(node, context);
+                KeyMap_Put(map, key, NULL);
+            }
+        } else if (kind == JOURNAL_RECORD_NODE_PUT) {
+            if (!Journal_ApplyNode(context, map, p, flags)) return false;
+        } else if (kind == JOURNAL_RECORD_VIEW) {
+            context->camera.target = (Vector2){ Get_F32(p + 0), Get_F32(p + 4) };
+            context->camera.zoom = Get_F32(p + 8);   // Journal_CheckBatch checked the view
+        }
+    }
+
+    // === Pass 2: everything that points at other nodes ===
+    for (uint32_t offset = 0; offset < size; ) {
+        uint16_t kind = Get_U16(data + offset);
+        uint32_t recordSize = Get_U32(data + offset + 4);
+        const unsigned char *p = data + offset + JOURNAL_RECORD_HEADER_SIZE;
+        offset += JOURNAL_RECORD_HEADER_SIZE + recordSize;
+
+        if (kind == JOURNAL_RECORD_NODE_PUT) {
+            if (!Journal_ApplyLinks(context, map, p)) return false;
+        } else if (kind == JOURNAL_RECORD_SCENES) {
+            Journal_ApplyScenes(context, map, p);
+        }
+    }
+    return true;
+}
+
+static unsigned char* Journal_ReadLog(const char *path, uint32_t *size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    unsigned char *data = NULL;
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) length = ftell(file);
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = malloc((size_t)length + 1);
+        if (data && fread(data, 1, (size_t)length, file) != (size_t)length) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    *size = data ? (uint32_t)length : 0;
+    return data;
+}
+
+// Maps the project file and replays every batch written after it
+bool Journal_Load(Context *context, const char *path, JournalStats *stats) {
+    JournalStats result = {0};
+
+    // a compaction in flight is about to replace the very file that gets mapped
+    Autosave_Cancel(context);
+    if (!Project_Load(context, path, &result.project)) return false;
+
+    Journal *journal = Journal_Open(context, path);
+    if (!journal) return true;  // loaded, the next save is a full one
+    journal->seq = result.project.journalSeq;
+    journal->projectBytes = result.project.bytes;
+
+    uint32_t logSize = 0;
+    unsigned char *log = Journal_ReadLog(journal->logPath, &logSize);
+    if (!log || logSize < JOURNAL_HEADER_SIZE || memcmp(log, JOURNAL_MAGIC, 4) != 0 ||
+        Get_U32(log + 4) != JOURNAL_VERSION) {
+        if (log) TraceLog(LOG_WARNING, "JOURNAL: [%s] is not a version %d journal, starting a new one", journal->logPath, JOURNAL_VERSION);
+        free(log);
+        if (!Journal_RewriteLog(journal, NULL, 0)) TraceLog(LOG_WARNING, "JOURNAL: Could not create [%s]", journal->logPath);
+        Journal_MarkSaved(context, journal);
+        result.logBytes = journal->logBytes;
+        if (stats) *stats = result;
+        return true;
+    }
+
+    // every live node by key, replay adds and removes entries as it goes
+    KeyMap map = {0};
+    bool ok = true;
+    for (Node *node = context->zHead; node && ok; node = node->nextZ) ok = KeyMap_Put(&map, node->saveKey, node);
+
+    uint32_t offset = JOURNAL_HEADER_SIZE;
+    uint32_t previous = 0;
+    bool foreign = false;
+    while (ok && logSize - offset >= JOURNAL_BATCH_HEADER_SIZE) {
+        uint32_t seq = Get_U32(log + offset);
+        uint32_t size = Get_U32(log + offset + 4);
+        const unsigned char *data = log + offset + JOURNAL_BATCH_HEADER_SIZE;
+
+        // a torn last write or leftovers behind it end the log
+        if (size > logSize - offset - JOURNAL_BATCH_HEADER_SIZE) break;
+        if (Journal_Checksum(data, size) != Get_U32(log + offset + 8)) break;
+        if (previous && seq != previous + 1) break;
+        if (!Journal_CheckBatch(data, size)) break;
+
+        if (seq > journal->seq) {
+            if (seq != journal->seq + 1) {
+                foreign = true;  // written against another project file
+                break;
+            }
+            ok = Journal_ApplyBatch(context, &map, data, size, &result.records);
+            journal->seq = seq;
+            result.batches++;
+            result.bytes += JOURNAL_BATCH_HEADER_SIZE + size;
+        }
+        previous = seq;
+        offset += JOURNAL_BATCH_HEADER_SIZE + size;
+    }
+    journal->logBytes = offset;
+    free(map.slots);
+    free(log);
+
+    if (foreign) {
+        TraceLog(LOG_WARNING, "JOURNAL: [%s] does not continue [%s], starting a new one", journal->logPath, path);
+        if (!Journal_RewriteLog(journal, NULL, 0)) TraceLog(LOG_WARNING, "JOURNAL: Could not reset [%s]", journal->logPath);
+    }
+    if (!ok) TraceLog(LOG_WARNING, "JOURNAL: [%s] was only partially replayed, out of memory", journal->logPath);
+
+    Journal_MarkSaved(context, journal);
+    result.logBytes = journal->logBytes;
+    if (stats) *stats = result;
+    return ok;
+}
+
+void Journal_Close(Context *context) {
+    free(context->journal);
+    context->journal = NULL;
+}
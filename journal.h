@@ -0,0 +1,57 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "core.h"
+#include "project.h"
+#include <stdint.h>
+
+// Save journal (<project>.log)
+// A save appends one batch to a log next to the project file. The batch holds only what changed
+// since the previous save (nodes, removed nodes, scenes, view), so a save costs O(changes)
+// instead of rewriting the whole project. Loading maps the project file and replays the batches
+// written after it. Once the log outgrows the project file, the autosave worker writes a fresh
+// project file from a snapshot and the folded batches are dropped from the log (compaction).
+//
+// Little-endian like the project file. Header: magic[4], u32 version, u32 0, u32 0.
+// Batch: u32 seq, u32 size, u32 checksum (FNV-1a of the records), then size bytes of records.
+// Record: u16 kind, u16 flags, u32 size, then the body. Nodes are referenced by Node.saveKey, 0 is none.
+// Batch numbers follow each other without gaps, replay stops at the first torn or foreign batch.
+#define JOURNAL_MAGIC "NPJL"
+#define JOURNAL_VERSION 1
+#define JOURNAL_HEADER_SIZE 16
+#define JOURNAL_BATCH_HEADER_SIZE 12
+#define JOURNAL_RECORD_HEADER_SIZE 8
+#define JOURNAL_NODE_FIXED_SIZE 48      // node body before text, links and curves
+#define JOURNAL_LINK_SIZE 12            // u16 kind, u16 slot, u32 from key, u32 to key
+#define JOURNAL_CURVE_SIZE 52           // u32 to key, 4 points, 2 anchors
+#ifndef JOURNAL_COMPACT_MIN_BYTES
+#define JOURNAL_COMPACT_MIN_BYTES (256 * 1024)  // smaller logs are never compacted
+#endif
+
+typedef enum {
+    JOURNAL_RECORD_NODE_REMOVE = 1, // u32 key
+    JOURNAL_RECORD_NODE_PUT,        // whole node: fields, text, links and outgoing curves
+    JOURNAL_RECORD_SCENES,          // the whole scene list, members as keys
+    JOURNAL_RECORD_VIEW             // camera target and zoom
+} JournalRecordKind;
+
+// NODE_PUT flags: the node was raised / lowered in the z-order since the previous batch
+#define JOURNAL_PUT_TOP 1
+#define JOURNAL_PUT_BOTTOM 2
+
+typedef struct {
+    ProjectStats project;   // the project file, when it was written or loaded
+    uint32_t records;       // save: records appended, load: records replayed
+    uint32_t batches;       // load: batches replayed
+    uint32_t bytes;         // save: bytes appended, load: bytes replayed
+    uint32_t logBytes;      // size of the log afterwards
+    bool fullSave;          // save: the project file itself was rewritten
+    bool compacting;        // save: a compaction was started
+} JournalStats;
+
+bool Journal_Save(Context *context, const char *path, JournalStats *stats);
+bool Journal_Load(Context *context, const char *path, JournalStats *stats);
+void Journal_CompactDone(Context *context, bool ok, uint32_t projectBytes);
+void Journal_Close(Context *context);
+
+#endif
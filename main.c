@@ -0,0 +1,254 @@
+// Editor front end: the window, raygui and the main loop. Everything else (the graph, the
+// behaviours, project files, the story compiler) is the core, which only sees one FrameInput per
+// frame and never touches the window itself, so tools and benchmarks link the core without this file.
+// The raygui implementation is compiled here, for this file and the drawing code in ui.c.
+#define RAYGUI_IMPLEMENTATION
+#define RAYGUI_SUPPORT_ICONS
+#include "raylib.h"
+#include "raygui.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "ui.h"
+#include "autosave.h"
+#include "story.h"
+#include "inputlog.h"
+#include "profiler.h"
+#include "trace.h"
+
+//Screen F1 toggle function
+static void HandleScreenToggle(ScreenSettings *screen){
+    if (IsKeyPressed(KEY_F1))
+    {
+        if (screen->currentSize == SCREEN_SMALL) {
+            screen->width = 1920;
+            screen->height = 1080;
+            screen->currentSize = SCREEN_LARGE;
+        } else {
+            screen->width = 1280;
+            screen->height = 720;
+            screen->currentSize = SCREEN_SMALL;
+        }
+
+        SetWindowSize(screen->width, screen->height);
+
+        Vector2 screenCenter = {
+            (GetMonitorWidth(0) - screen->width) / 2.0f,
+            (GetMonitorHeight(0) - screen->height) / 2.0f
+        };
+        SetWindowPosition((int)screenCenter.x, (int)screenCenter.y);
+    }
+}
+
+//Profiler overlay F3 toggle
+static void HandleProfilerToggle(Context *context) {
+    if (IsKeyPressed(KEY_F3)) {
+        Profiler_Toggle();
+        RequestRedraw(context);
+    }
+}
+
+//Trace F4: the first press starts recording, every later one writes the events so far
+static void HandleTraceKey(void) {
+    if (!IsKeyPressed(KEY_F4)) return;
+    if (!Trace_Recording()) {
+        if (Trace_Start()) TraceLog(LOG_INFO, "TRACE: Recording, F4 writes %s", TRACE_FILE_PATH);
+        else TraceLog(LOG_WARNING, "TRACE: Could not allocate the event ring");
+    } else if (Trace_Dump(TRACE_FILE_PATH)) {
+        TraceLog(LOG_INFO, "TRACE: Wrote %s", TRACE_FILE_PATH);
+    } else {
+        TraceLog(LOG_WARNING, "TRACE: Could not write %s", TRACE_FILE_PATH);
+    }
+}
+
+// The core's view of this frame
+static FrameInput PollFrameInput(void) {
+    FrameInput input = {
+        .time = GetTime(),
+        .mouse = GetMousePosition(),
+        .mouseDelta = GetMouseDelta(),
+        .wheel = GetMouseWheelMove(),
+        .resized = IsWindowResized()
+    };
+
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++) {
+        if (IsMouseButtonDown(button)) input.buttonsDown |= INPUT_BUTTON(button);
+        if (IsMouseButtonPressed(button)) input.buttonsPressed |= INPUT_BUTTON(button);
+        if (IsMouseButtonReleased(button)) input.buttonsReleased |= INPUT_BUTTON(button);
+    }
+    for (int key = KEY_SPACE; key <= KEY_KB_MENU && !input.keyActivity; key++) {
+        input.keyActivity = IsKeyPressed(key) || IsKeyReleased(key);
+    }
+    return input;
+}
+
+// Carries out what the core asked the window for during the frame
+static void ApplyFrameRequests(Context *context, MouseCursor *cursor, RedrawMode *waitMode) {
+    if (context->cursor != *cursor) {
+        SetMouseCursor(context->cursor);
+        *cursor = context->cursor;
+    }
+    if (context->warpMouse) {
+        SetMousePosition((int)context->warpMouseTo.x, (int)context->warpMouseTo.y);
+        context->warpMouse = false;
+    }
+    if (context->redrawMode != *waitMode) {
+        if (context->redrawMode == REDRAW_EVENT) EnableEventWaiting();
+        else DisableEventWaiting();
+        *waitMode = context->redrawMode;
+    }
+}
+
+// Stands in for EndDrawing on frames that are not drawn: blocks on events (or naps while polling)
+static void SkipFrame(Context *context) {
+    if (context->redrawMode == REDRAW_POLL) WaitTime(1.0 / 15.0);
+    PollInputEvents();
+}
+
+
+// Appends the frame to the recording when one was asked for with --record
+static void RecordFrame(InputLog *log, const Context *context, const ScreenSettings *screen,
+                        MenuAction menuAction, int playtestInput) {
+    if (!log->file) return;
+    InputFrame frame = {
+        .input = context->input,
+        .screenWidth = screen->width,
+        .screenHeight = screen->height,
+        .menuAction = menuAction,
+        .playtestInput = playtestInput
+    };
+    if (!InputLog_Write(log, &frame)) {
+        TraceLog(LOG_WARNING, "INPUT: Recording stopped after %u frames, the file could not be written", log->frames);
+        InputLog_Close(log);
+    }
+}
+
+// nodeprose [--record session.ninput] [--trace]
+int main(int argc, char **argv)
+{
+    const char *recordPath = NULL;
+    bool traceSession = false;      // records a trace from the start, written on exit
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0) traceSession = true;
+    }
+
+
+    ScreenSettings screen = {.width = 1280, .height = 720, .currentSize = SCREEN_SMALL, .currentView = VIEW_MODE_NODE};
+
+    InitWindow(screen.width, screen.height, "Node Prose - node based videogame narrative authoring tool");
+    globalFont = LoadFont("resources/LSANSD.ttf");
+    GuiSetFont(globalFont);
+    GuiSetStyle(DEFAULT, TEXT_SIZE, 18);
+    EnableCursor();
+    SetTargetFPS(60);
+    
+    NodePool pool;
+    Context context;
+    if (!Editor_Init(&context, &pool)) {
+        TraceLog(LOG_FATAL, "Could not allocate the node pool");
+        CloseWindow();
+        return 1;
+    }
+
+    InputLog recording = {0};
+    if (recordPath && InputLog_Create(&recording, recordPath)) {
+        TraceLog(LOG_INFO, "INPUT: Recording to %s", recordPath);
+    }
+    if (traceSession && !Trace_Start()) TraceLog(LOG_WARNING, "TRACE: Could not allocate the event ring");
+
+    Autosave_Start(&context, AUTOSAVE_FILE_PATH);
+
+    MouseCursor cursor = MOUSE_CURSOR_DEFAULT;
+    RedrawMode waitMode = REDRAW_CONTINUOUS;
+
+    while (!WindowShouldClose())
+    {
+        Profiler_BeginFrame();
+        context.input = PollFrameInput();
+        HandleScreenToggle(&screen);
+        HandleProfilerToggle(&context);
+        HandleTraceKey();
+        Editor_Update(&context, &screen);
+
+        // 💤 Nothing changed on screen: wait for the next event instead of redrawing
+        bool redraw = UpdateRedrawMode(&context);
+        ApplyFrameRequests(&context, &cursor, &waitMode);
+        if (!redraw) {
+            RecordFrame(&recording, &context, &screen, MENU_ACTION_NONE, PLAYTEST_INPUT_NONE);
+            Profiler_EndFrame();
+            SkipFrame(&context);
+            continue;
+        }
+
+        BeginDrawing();
+            PROFILE_BEGIN(PROFILE_ZONE_DRAW_UI);
+            ClearBackground(ORANGE);
+            DrawBackground(&screen, context.camera);
+            PROFILE_END(PROFILE_ZONE_DRAW_UI);
+            
+            if (screen.currentView == VIEW_MODE_NODE) {
+                PROFILE_BEGIN(PROFILE_ZONE_CULLING);
+                CollectVisibleNodes(&context);
+                PROFILE_END(PROFILE_ZONE_CULLING);
+                BeginMode2D(context.camera);
+                    PROFILE_BEGIN(PROFILE_ZONE_DRAW_SCENES);
+                    DrawSceneOutlines(&context);
+                    PROFILE_END(PROFILE_ZONE_DRAW_SCENES);
+                    PROFILE_BEGIN(PROFILE_ZONE_DRAW_NODES);
+                    DrawAllNodes(&context);
+                    PROFILE_END(PROFILE_ZONE_DRAW_NODES);
+                    PROFILE_BEGIN(PROFILE_ZONE_DRAW_CURVES);
+                    DrawPermanentConnections(&context);
+                    PROFILE_END(PROFILE_ZONE_DRAW_CURVES);
+                    PROFILE_BEGIN(PROFILE_ZONE_DRAW_NODES);
+                    DrawTopNodeAndConnections(&context);
+                    PROFILE_END(PROFILE_ZONE_DRAW_NODES);
+                    PROFILE_BEGIN(PROFILE_ZONE_DRAW_CURVES);
+                    DrawLiveBezier(&context);
+                    PROFILE_END(PROFILE_ZONE_DRAW_CURVES);
+                    PROFILE_BEGIN(PROFILE_ZONE_DRAW_NODES);
+                    DrawPlaytestHighlight(&context);
+                    PROFILE_END(PROFILE_ZONE_DRAW_NODES);
+                EndMode2D();
+                PROFILE_BEGIN(PROFILE_ZONE_DRAW_UI);
+                DrawRenderStats(&context, &screen);
+                PROFILE_END(PROFILE_ZONE_DRAW_UI);
+            } else if (screen.currentView == VIEW_MODE_SCRIPT) {
+                DrawText("SCRIPT VIEW (not implemented yet)", 50, 100, 28, DARKGRAY);
+            }
+           
+           
+            PROFILE_BEGIN(PROFILE_ZONE_DRAW_UI);
+            int playtestInput = DrawPlaytestPanel(&context, &screen);
+            MenuAction menuAction = DrawMenuBar(&screen, &context.input);
+            if (profiler.enabled) DrawProfilerOverlay(&context, &screen);
+            PROFILE_END(PROFILE_ZONE_DRAW_UI);
+            Profiler_BeginIdle();
+        EndDrawing();
+        Profiler_EndIdle();
+
+        // the draw pass's buttons, still part of this frame
+        RecordFrame(&recording, &context, &screen, menuAction, playtestInput);
+        PROFILE_BEGIN(PROFILE_ZONE_PLAYTEST);
+        Playtest_Answer(&context, playtestInput);
+        PROFILE_END(PROFILE_ZONE_PLAYTEST);
+        PROFILE_BEGIN(PROFILE_ZONE_MENU);
+        HandleMenuAction(menuAction, &context);
+        PROFILE_END(PROFILE_ZONE_MENU);
+        Profiler_EndFrame();
+        ApplyFrameRequests(&context, &cursor, &waitMode);
+    }
+
+    InputLog_Close(&recording);
+    Editor_Shutdown(&context);
+    if (Trace_Recording() && !Trace_Dump(TRACE_FILE_PATH)) {    // the workers have stopped, their last events are in
+        TraceLog(LOG_WARNING, "TRACE: Could not write %s", TRACE_FILE_PATH);
+    }
+    Trace_Shutdown();
+    UnloadBackground();
+    UnloadFont(globalFont);
+    CloseWindow();
+    return 0;
+}
@@ -6,10 +6,17 @@
 
 typedef struct Node Node;
 
+// Reference to a node slot. A handle only resolves while the slot generation still matches,
+// so a deleted (or reused) node turns every old handle into NULL. A zeroed handle is empty.
+typedef struct {
+    int index;                  // slot index inside the node pool
+    unsigned int generation;    // generation of the slot when the handle was taken, 0 = empty
+} NodeHandle;
+
 // Basic building block to draw connection between two nodes
 typedef struct {
-    Node *from;
-    Node *to;
+    NodeHandle from;
+    NodeHandle to;
 } Connection;
 
 // Enum with all the node types
@@ -27,7 +34,9 @@ typedef enum {
 
 // A simple default node with no branching or logic
 typedef struct {
-    char *text;  // text of the default node
+    char *text;  // editable text of the default node, owned, NULL until materialised
+    const char *mappedText;     // text still inside the memory-mapped project file, not null terminated
+    unsigned int mappedLength;
     Connection next; // has the pointer to the next node
 } DefaultNode;
 
@@ -0,0 +1,70 @@
+#include <string.h>
+
+#include "profiler.h"
+
+Profiler profiler;
+
+// Starts from empty history, old numbers would mix with the frames since
+void Profiler_Toggle(void) {
+    bool enabled = !profiler.enabled;
+    memset(&profiler, 0, sizeof(profiler));
+    profiler.enabled = enabled;
+    profiler.frameStart = Clock_Seconds();      // toggled mid frame, after Profiler_BeginFrame
+}
+
+void Profiler_BeginFrame(void) {
+    if (Trace_Recording()) Trace_Event(TRACE_TRACK_MAIN, 'B', "frame");
+    if (!profiler.enabled) return;
+    profiler.frameStart = Clock_Seconds();
+}
+
+// Folds the frame into the averages and the histogram ring. Phases timed between here and the
+// next Profiler_BeginFrame count towards the next frame.
+void Profiler_EndFrame(void) {
+    if (Trace_Recording()) Trace_Event(TRACE_TRACK_MAIN, 'E', "frame");
+    if (!profiler.enabled) return;
+
+    double work = Clock_Seconds() - profiler.frameStart - profiler.idleTime;
+    profiler.idleTime = 0;
+    bool first = profiler.frameCount == 0;
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+        double time = profiler.zoneTime[zone];
+        profiler.zoneAverage[zone] = first ? time : profiler.zoneAverage[zone] + PROFILE_SMOOTHING * (time - profiler.zoneAverage[zone]);
+    }
+    memcpy(profiler.lastCounters, profiler.counters, sizeof(profiler.counters));
+    memset(profiler.zoneTime, 0, sizeof(profiler.zoneTime));
+    memset(profiler.counters, 0, sizeof(profiler.counters));
+
+    profiler.frameMillis[profiler.frameNext] = (float)(work * 1000.0);
+    profiler.frameNext = (profiler.frameNext + 1) % PROFILE_HISTORY;
+    if (profiler.frameCount < PROFILE_HISTORY) profiler.frameCount++;
+}
+
+void Profiler_BeginIdle(void) {
+    if (profiler.enabled) profiler.idleStart = Clock_Seconds();
+}
+
+void Profiler_EndIdle(void) {
+    if (profiler.enabled) profiler.idleTime += Clock_Seconds() - profiler.idleStart;
+}
+
+void Profiler_BeginZone(ProfileZone zone) {
+    double now = Clock_Seconds();
+    profiler.zoneStart[zone] = now;
+    if (Trace_Recording()) Trace_EventAt(TRACE_TRACK_MAIN, 'B', Profiler_ZoneName(zone), now);
+}
+
+void Profiler_EndZone(ProfileZone zone) {
+    double now = Clock_Seconds();
+    if (profiler.enabled) profiler.zoneTime[zone] += now - profiler.zoneStart[zone];
+    if (Trace_Recording()) Trace_EventAt(TRACE_TRACK_MAIN, 'E', Profiler_ZoneName(zone), now);
+}
+
+const char* Profiler_ZoneName(ProfileZone zone) {
+    static const char *names[PROFILE_ZONE_COUNT] = {
+        "pan / zoom", "scene store", "node creation", "scene outline", "node behaviours",
+        "scene behaviours", "membership", "autosave", "playtest", "menu", "culling",
+        "draw scenes", "draw nodes", "draw curves", "draw ui"
+    };
+    return zone >= 0 && zone < PROFILE_ZONE_COUNT ? names[zone] : "?";
+}
@@ -0,0 +1,75 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+#include "filemap.h"
+#include "trace.h"
+
+// Frame profiler, shown by the overlay F3 toggles (DrawProfilerOverlay)
+// PROFILE_BEGIN / PROFILE_END time one phase of the frame, PROFILE_COUNT adds to a counter of the
+// frame. While the overlay is off and no trace is recorded (trace.h, the phases are traced on the
+// main track) the macros are just that test, nothing is timed or counted. Phases may be entered
+// several times a frame, their times add up.
+// A frame ends once the menu actions of its draw pass are handled. The time between
+// Profiler_BeginIdle and Profiler_EndIdle (EndDrawing) is left out: the histogram shows the
+// editor's own work, not the buffer swap and the wait for the frame cap.
+#define PROFILE_HISTORY 240         // frames kept for the frame time histogram
+#define PROFILE_SMOOTHING 0.05      // weight of the newest frame in the phase averages
+
+typedef enum {
+    PROFILE_ZONE_PAN_ZOOM,          // Behavior_ZoomCanvas, Behavior_PanCanvas, view rectangle
+    PROFILE_ZONE_SCENE_STORE,       // SceneStore_Update
+    PROFILE_ZONE_NODE_CREATION,     // HandleNodeCreationClick
+    PROFILE_ZONE_SCENE_OUTLINE,     // Behavior_DrawSceneOutline
+    PROFILE_ZONE_NODE_BEHAVIORS,    // DispatchNodeBehaviors
+    PROFILE_ZONE_SCENE_BEHAVIORS,   // Behavior_SceneOutlines, Behavior_LiveConnection
+    PROFILE_ZONE_MEMBERSHIP,        // UpdateSceneNodeMembership
+    PROFILE_ZONE_AUTOSAVE,          // Autosave_Update
+    PROFILE_ZONE_PLAYTEST,          // Playtest_Update, Playtest_Answer
+    PROFILE_ZONE_MENU,              // HandleMenuAction
+    PROFILE_ZONE_CULLING,           // CollectVisibleNodes
+    PROFILE_ZONE_DRAW_SCENES,
+    PROFILE_ZONE_DRAW_NODES,
+    PROFILE_ZONE_DRAW_CURVES,
+    PROFILE_ZONE_DRAW_UI,           // background, stats, playtest panel, menu bar, the overlay itself
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+typedef enum {
+    PROFILE_COUNTER_HIT_TESTS,      // node bounds tested against the cursor
+    PROFILE_COUNTER_DRAW_CALLS,     // raylib draw calls issued by the canvas, a raygui icon counts once
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+typedef struct {
+    bool enabled;
+    double frameStart;
+    double idleStart;
+    double idleTime;                                // seconds of the running frame spent in EndDrawing
+    double zoneStart[PROFILE_ZONE_COUNT];
+    double zoneTime[PROFILE_ZONE_COUNT];            // seconds in the running frame
+    double zoneAverage[PROFILE_ZONE_COUNT];         // seconds per frame, exponential moving average
+    unsigned int counters[PROFILE_COUNTER_COUNT];   // running frame
+    unsigned int lastCounters[PROFILE_COUNTER_COUNT];   // last finished frame
+    float frameMillis[PROFILE_HISTORY];             // work per frame, ms, ring, oldest at frameNext once full
+    int frameNext;
+    int frameCount;
+} Profiler;
+
+extern Profiler profiler;
+
+#define PROFILE_BEGIN(zone) do { if (profiler.enabled || Trace_Recording()) Profiler_BeginZone(zone); } while (0)
+#define PROFILE_END(zone) do { if (profiler.enabled || Trace_Recording()) Profiler_EndZone(zone); } while (0)
+#define PROFILE_COUNT(counter, n) do { if (profiler.enabled) profiler.counters[counter] += (n); } while (0)
+
+void Profiler_Toggle(void);
+void Profiler_BeginFrame(void);
+void Profiler_EndFrame(void);
+void Profiler_BeginIdle(void);
+void Profiler_EndIdle(void);
+void Profiler_BeginZone(ProfileZone zone);
+void Profiler_EndZone(ProfileZone zone);
+const char* Profiler_ZoneName(ProfileZone zone);
+
+#endif
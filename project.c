@@ -0,0 +1,781 @@
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "autosave.h"
+#include "scenestore.h"
+
+// BYTE BUFFER
+unsigned char* ByteBuffer_Reserve(ByteBuffer *buffer, size_t bytes) {
+    if (buffer->failed) return NULL;
+    if (buffer->size + bytes > buffer->capacity) {
+        size_t newCapacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (newCapacity < buffer->size + bytes) newCapacity *= 2;
+        unsigned char *data = realloc(buffer->data, newCapacity);
+        if (!data) {
+            buffer->failed = true;
+            return NULL;
+        }
+        buffer->data = data;
+        buffer->capacity = newCapacity;
+    }
+    unsigned char *out = buffer->data + buffer->size;
+    buffer->size += bytes;
+    return out;
+}
+
+// NODE PAYLOAD
+int32_t NodePayloadValue(const Node *node) {
+    switch (node->type) {
+        case NODE_STACK:        return node->data.stackNode.stackindex;
+        case NODE_RANDOM:       return (int32_t)node->data.randomNode.seed;
+        case NODE_RANDOM_BAG:   return (int32_t)node->data.randomBagNode.seed;
+        case NODE_USER_CHOICE:  return node->data.userChoiceNode.choices;
+        case NODE_SKILL_GATE:   return node->data.skillGateNode.requiredSkillId;
+        case NODE_CONDITIONAL:  return node->data.conditionalNode.conditionId;
+        default:                return 0;
+    }
+}
+
+void SetNodePayloadValue(Node *node, int32_t value) {
+    switch (node->type) {
+        case NODE_STACK:        node->data.stackNode.stackindex = value; break;
+        case NODE_RANDOM:       node->data.randomNode.seed = (unsigned int)value; break;
+        case NODE_RANDOM_BAG:   node->data.randomBagNode.seed = (unsigned int)value; break;
+        case NODE_USER_CHOICE:  node->data.userChoiceNode.choices = value; break;
+        case NODE_SKILL_GATE:   node->data.skillGateNode.requiredSkillId = value; break;
+        case NODE_CONDITIONAL:  node->data.conditionalNode.conditionId = value; break;
+        default: break;
+    }
+}
+
+// SAVE
+typedef struct {
+    const ProjectSource *source;
+    uint32_t *recordOf;     // pool slot -> node record index, filled before anything references nodes
+    ByteBuffer strings;
+    ByteBuffer nodes;
+    ByteBuffer links;
+    ByteBuffer edges;
+    ByteBuffer scenes;
+    ByteBuffer members;
+    ByteBuffer view;
+    ByteBuffer journal;
+} ProjectWriter;
+
+#define WRITER_NOT_WRITTEN UINT32_MAX     // recordOf value of nodes outside the source
+
+// Node reference as stored on disk: record index + 1, 0 for empty or dead handles and for nodes
+// the source does not hold (a scene chunk only holds the nodes of its scene)
+static uint32_t Writer_NodeRef(const ProjectWriter *writer, NodeHandle handle) {
+    Node *node = NodePool_Resolve(writer->source->pool, handle);
+    if (!node || writer->recordOf[node->index] == WRITER_NOT_WRITTEN) return 0;
+    return writer->recordOf[node->index] + 1;
+}
+
+static uint32_t Writer_String(ProjectWriter *writer, const char *text, uint32_t length) {
+    uint32_t offset = (uint32_t)writer->strings.size;
+    unsigned char *out = ByteBuffer_Reserve(&writer->strings, length);
+    if (out) memcpy(out, text, length);
+    return offset;
+}
+
+static void Writer_Link(ProjectWriter *writer, uint32_t record, ProjectLinkKind kind, int slot, Connection connection) {
+    uint32_t from = Writer_NodeRef(writer, connection.from);
+    uint32_t to = Writer_NodeRef(writer, connection.to);
+    if (!from && !to) return;
+
+    unsigned char *p = ByteBuffer_Reserve(&writer->links, PROJECT_LINK_RECORD_SIZE);
+    if (!p) return;
+    Put_U32(p + 0, record);
+    Put_U16(p + 4, (uint16_t)kind);
+    Put_U16(p + 6, (uint16_t)slot);
+    Put_U32(p + 8, from);
+    Put_U32(p + 12, to);
+}
+
+static void Writer_Node(ProjectWriter *writer, const Node *node) {
+    unsigned char *p = ByteBuffer_Reserve(&writer->nodes, PROJECT_NODE_RECORD_SIZE);
+    if (!p) return;
+    memset(p, 0, PROJECT_NODE_RECORD_SIZE);
+
+    unsigned int textLength = 0;
+    uint32_t textOffset = 0;
+    const char *text = Node_TextView(node, &textLength);
+    if (text && textLength) textOffset = Writer_String(writer, text, textLength);  // empty text reads back as none
+
+    Put_F32(p + 0, node->position.x);
+    Put_F32(p + 4, node->position.y);
+    Put_U32(p + 8, (uint32_t)node->width);
+    Put_U32(p + 12, (uint32_t)node->height);
+    p[16] = (unsigned char)node->type;
+    p[17] = node->isExpanded ? 1 : 0;
+    memcpy(p + 20, node->id, 8);
+    Put_U32(p + 28, textOffset);
+    Put_U32(p + 32, textLength);
+    Put_U32(p + 36, (uint32_t)NodePayloadValue(node));
+    Put_U32(p + 40, node->saveKey);
+    // 44..47 reserved
+}
+
+static void Writer_Free(ProjectWriter *writer) {
+    free(writer->recordOf);
+    free(writer->strings.data);
+    free(writer->nodes.data);
+    free(writer->links.data);
+    free(writer->edges.data);
+    free(writer->scenes.data);
+    free(writer->members.data);
+    free(writer->view.data);
+    free(writer->journal.data);
+}
+
+// Takes every text still inside the mapped project file over and unmaps it. Needed before the
+// file is overwritten: that would pull the text out from under the nodes (and Windows refuses
+// to open or replace a mapped file).
+bool Project_DetachMap(Context *context) {
+    if (!context->projectMap.data) return true;
+
+    for (Node *node = context->zHead; node; node = node->nextZ) {
+        if (node->type != NODE_DEFAULT || !node->data.defaultNode.mappedText) continue;
+        NodePool_Touch(context->pool, node);
+        if (!Node_MaterializeText(node)) return false;
+    }
+    Autosave_Cancel(context);  // an autosave in flight may still read text from the mapping
+    FileMap_Close(&context->projectMap);
+    return true;
+}
+
+bool Project_Save(Context *context, const char *path, ProjectStats *stats) {
+    return Project_SaveAt(context, path, 0, false, stats);
+}
+
+// Full save that records how far the project journal is already contained in the file.
+// Durable saves go through a temporary file, synced and renamed over the old one.
+bool Project_SaveAt(Context *context, const char *path, uint32_t journalSeq, bool durable, ProjectStats *stats) {
+    if (context->projectMap.data && strcmp(path, context->projectMapPath) == 0 && !Project_DetachMap(context)) {
+        TraceLog(LOG_WARNING, "PROJECT: Out of memory while saving [%s]", path);
+        return false;
+    }
+
+    Node **order = malloc((context->pool->liveCount + 1) * sizeof(Node *));
+    if (!order) return false;
+
+    uint32_t nodeCount = 0;
+    for (Node *node = context->zHead; node; node = node->nextZ) order[nodeCount++] = node;
+
+    ProjectSource source = {
+        .pool = context->pool,
+        .nodes = order,
+        .nodeCount = nodeCount,
+        .edges = &context->edges,
+        .scenes = &context->sceneList,
+        .camera = context->camera,
+        .journalSeq = journalSeq,
+        .lastSaveKey = context->pool->lastSaveKey
+    };
+    bool ok;
+    if (durable) {
+        char tmpPath[268];
+        snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+        ok = Project_WriteFile(&source, tmpPath, true, stats) && File_Replace(tmpPath, path);
+    } else {
+        ok = Project_WriteFile(&source, path, false, stats);
+    }
+    free(order);
+    return ok;
+}
+
+typedef struct {
+    ProjectSectionId id;
+    ByteBuffer *buffer;
+    size_t recordSize;
+} WriterSection;
+
+static int Writer_Sections(ProjectWriter *writer, WriterSection sections[PROJECT_SECTION_COUNT]) {
+    WriterSection list[] = {
+        { PROJECT_SECTION_STRINGS,       &writer->strings, 1 },
+        { PROJECT_SECTION_NODES,         &writer->nodes,   PROJECT_NODE_RECORD_SIZE },
+        { PROJECT_SECTION_LINKS,         &writer->links,   PROJECT_LINK_RECORD_SIZE },
+        { PROJECT_SECTION_EDGES,         &writer->edges,   PROJECT_EDGE_RECORD_SIZE },
+        { PROJECT_SECTION_SCENES,        &writer->scenes,  PROJECT_SCENE_RECORD_SIZE },
+        { PROJECT_SECTION_SCENE_MEMBERS, &writer->members, 4 },
+        { PROJECT_SECTION_VIEW,          &writer->view,    PROJECT_VIEW_RECORD_SIZE },
+        { PROJECT_SECTION_JOURNAL,       &writer->journal, PROJECT_JOURNAL_RECORD_SIZE },
+    };
+    int count = (int)(sizeof(list) / sizeof(list[0]));
+    memcpy(sections, list, sizeof(list));
+    return count;
+}
+
+static int CompareEdgeRecord(const void *a, const void *b) {
+    return memcmp(a, b, PROJECT_EDGE_RECORD_SIZE);
+}
+
+// Encodes every section in memory, false when a buffer could not grow
+static bool Project_Encode(const ProjectSource *source, ProjectWriter *writer) {
+    const NodePool *pool = source->pool;
+    *writer = (ProjectWriter){ .source = source };
+
+    int slotCount = NodePool_SlotCount(pool);
+    writer->recordOf = malloc((slotCount + 1) * sizeof(uint32_t));
+    if (!writer->recordOf) return false;
+    for (int i = 0; i < slotCount; i++) writer->recordOf[i] = WRITER_NOT_WRITTEN;
+
+    // === Nodes, bottom to top so the z-order comes back as written ===
+    uint32_t nodeCount = source->nodeCount;
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        writer->recordOf[source->nodes[i]->index] = i;
+    }
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        Writer_Node(writer, source->nodes[i]);
+    }
+
+    // === Links: every Connection value a node owns ===
+    for (uint32_t record = 0; record < nodeCount; record++) {
+        const Node *node = source->nodes[record];
+        for (int c = 0; c < MAX_CONNECTORS; c++) {
+            Writer_Link(writer, record, PROJECT_LINK_CONNECTOR, c, node->connectors[c].with);
+        }
+        if (node->type == NODE_DEFAULT) {
+            Writer_Link(writer, record, PROJECT_LINK_DEFAULT_NEXT, 0, node->data.defaultNode.next);
+        } else if (node->type == NODE_STACK) {
+            for (int i = 0; i < 10; i++) {
+                Writer_Link(writer, record, PROJECT_LINK_STACK_NEXT, i, node->data.stackNode.next[i]);
+            }
+        }
+    }
+
+    // === Edges between nodes of the source ===
+    for (int i = 0; i < source->edges->count; i++) {
+        const BezierCurve *curve = EdgeStore_At(source->edges, i);
+        uint32_t from = Writer_NodeRef(writer, curve->fromNode);
+        uint32_t to = Writer_NodeRef(writer, curve->toNode);
+        if (!from || !to) continue;
+
+        unsigned char *p = ByteBuffer_Reserve(&writer->edges, PROJECT_EDGE_RECORD_SIZE);
+        if (!p) break;
+        Put_U32(p + 0, from);
+        Put_U32(p + 4, to);
+        for (int k = 0; k < 4; k++) {
+            Put_F32(p + 8 + k * 8, curve->points[k].x);
+            Put_F32(p + 12 + k * 8, curve->points[k].y);
+        }
+        for (int k = 0; k < 2; k++) {
+            Put_F32(p + 40 + k * 8, curve->relativeposition[k].x);
+            Put_F32(p + 44 + k * 8, curve->relativeposition[k].y);
+        }
+    }
+
+    if (source->sortEdges && !writer->edges.failed && writer->edges.size > PROJECT_EDGE_RECORD_SIZE) {
+        qsort(writer->edges.data, writer->edges.size / PROJECT_EDGE_RECORD_SIZE, PROJECT_EDGE_RECORD_SIZE, CompareEdgeRecord);
+    }
+
+    // === Scenes and their member slices ===
+    for (int s = 0; s < source->scenes->count; s++) {
+        const SceneOutline *scene = &source->scenes->scenes[s];
+        uint32_t firstMember = (uint32_t)(writer->members.size / 4);
+        uint32_t memberCount = 0;
+
+        for (int n = 0; n < scene->nodeCount; n++) {
+            uint32_t ref = Writer_NodeRef(writer, scene->containedNodes[n]);
+            if (!ref) continue;
+            unsigned char *m = ByteBuffer_Reserve(&writer->members, 4);
+            if (!m) break;
+            Put_U32(m, ref);
+            memberCount++;
+        }
+
+        const char *nameEnd = memchr(scene->name, '\0', sizeof(scene->name));
+        uint32_t nameLength = nameEnd ? (uint32_t)(nameEnd - scene->name) : (uint32_t)sizeof(scene->name);
+        uint32_t nameOffset = Writer_String(writer, scene->name, nameLength);
+
+        unsigned char *p = ByteBuffer_Reserve(&writer->scenes, PROJECT_SCENE_RECORD_SIZE);
+        if (!p) break;
+        Put_F32(p + 0, scene->bounds.x);
+        Put_F32(p + 4, scene->bounds.y);
+        Put_F32(p + 8, scene->bounds.width);
+        Put_F32(p + 12, scene->bounds.height);
+        Put_U32(p + 16, nameOffset);
+        Put_U32(p + 20, nameLength);
+        Put_U32(p + 24, firstMember);
+        Put_U32(p + 28, memberCount);
+    }
+
+    // === View ===
+    unsigned char *v = ByteBuffer_Reserve(&writer->view, PROJECT_VIEW_RECORD_SIZE);
+    if (v) {
+        Put_F32(v + 0, source->camera.target.x);
+        Put_F32(v + 4, source->camera.target.y);
+        Put_F32(v + 8, source->camera.zoom);
+    }
+
+    // === Journal position ===
+    unsigned char *j = ByteBuffer_Reserve(&writer->journal, PROJECT_JOURNAL_RECORD_SIZE);
+    if (j) {
+        Put_U32(j + 0, source->journalSeq);
+        Put_U32(j + 4, source->lastSaveKey);
+    }
+
+    WriterSection sections[PROJECT_SECTION_COUNT];
+    int sectionCount = Writer_Sections(writer, sections);
+    for (int i = 0; i < sectionCount; i++) {
+        if (sections[i].buffer->failed) return false;
+    }
+    return true;
+}
+
+// Header and section table, sections start 4-byte aligned. Returns the header size, *fileSize gets the total.
+static size_t Writer_Header(ProjectWriter *writer, unsigned char header[PROJECT_HEADER_SIZE + PROJECT_SECTION_COUNT * PROJECT_SECTION_ENTRY_SIZE], size_t *fileSize) {
+    WriterSection sections[PROJECT_SECTION_COUNT];
+    int sectionCount = Writer_Sections(writer, sections);
+
+    memset(header, 0, PROJECT_HEADER_SIZE + PROJECT_SECTION_COUNT * PROJECT_SECTION_ENTRY_SIZE);
+    memcpy(header, PROJECT_MAGIC, 4);
+    Put_U32(header + 4, PROJECT_VERSION);
+    Put_U32(header + 8, (uint32_t)sectionCount);
+    Put_U32(header + 12, 0);
+
+    size_t headerSize = PROJECT_HEADER_SIZE + sectionCount * PROJECT_SECTION_ENTRY_SIZE;
+    size_t offset = headerSize;
+    for (int i = 0; i < sectionCount; i++) {
+        unsigned char *entry = header + PROJECT_HEADER_SIZE + i * PROJECT_SECTION_ENTRY_SIZE;
+        size_t size = sections[i].buffer->size;
+        Put_U32(entry + 0, (uint32_t)sections[i].id);
+        Put_U32(entry + 4, (uint32_t)(size / sections[i].recordSize));
+        Put_U32(entry + 8, (uint32_t)offset);
+        Put_U32(entry + 12, (uint32_t)size);
+        offset += (size + 3) & ~(size_t)3;
+    }
+    *fileSize = offset;
+    return headerSize;
+}
+
+static void Writer_Stats(const ProjectWriter *writer, size_t fileSize, ProjectStats *stats) {
+    if (!stats) return;
+    *stats = (ProjectStats){
+        .nodes = writer->source->nodeCount,
+        .links = (uint32_t)(writer->links.size / PROJECT_LINK_RECORD_SIZE),
+        .edges = (uint32_t)(writer->edges.size / PROJECT_EDGE_RECORD_SIZE),
+        .scenes = (uint32_t)writer->source->scenes->count,
+        .bytes = (uint32_t)fileSize
+    };
+}
+
+// Encodes the source and writes it in one go. Durable writes are flushed to the disk before returning.
+bool Project_WriteFile(const ProjectSource *source, const char *path, bool durable, ProjectStats *stats) {
+    ProjectWriter writer;
+    if (!Project_Encode(source, &writer)) {
+        Writer_Free(&writer);
+        TraceLog(LOG_WARNING, "PROJECT: Out of memory while saving [%s]", path);
+        return false;
+    }
+
+    unsigned char header[PROJECT_HEADER_SIZE + PROJECT_SECTION_COUNT * PROJECT_SECTION_ENTRY_SIZE];
+    size_t fileSize;
+    size_t headerSize = Writer_Header(&writer, header, &fileSize);
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        Writer_Free(&writer);
+        TraceLog(LOG_WARNING, "PROJECT: Could not open [%s] for writing", path);
+        return false;
+    }
+
+    static const unsigned char padding[4] = {0};
+    WriterSection sections[PROJECT_SECTION_COUNT];
+    int sectionCount = Writer_Sections(&writer, sections);
+    bool ok = fwrite(header, 1, headerSize, file) == headerSize;
+    for (int i = 0; i < sectionCount && ok; i++) {
+        size_t size = sections[i].buffer->size;
+        if (size) ok = fwrite(sections[i].buffer->data, 1, size, file) == size;
+        size_t pad = ((size + 3) & ~(size_t)3) - size;
+        if (ok && pad) ok = fwrite(padding, 1, pad, file) == pad;
+    }
+    if (ok && durable) ok = fflush(file) == 0 && File_Sync(file);
+    ok = (fclose(file) == 0) && ok;
+
+    Writer_Stats(&writer, fileSize, stats);
+    Writer_Free(&writer);
+    if (!ok) TraceLog(LOG_WARNING, "PROJECT: Failed writing [%s]", path);
+    return ok;
+}
+
+// Same file image as Project_WriteFile, appended to a buffer instead (scene chunks are kept in memory)
+bool Project_WriteBuffer(const ProjectSource *source, ByteBuffer *out, ProjectStats *stats) {
+    ProjectWriter writer;
+    if (!Project_Encode(source, &writer)) {
+        Writer_Free(&writer);
+        return false;
+    }
+
+    unsigned char header[PROJECT_HEADER_SIZE + PROJECT_SECTION_COUNT * PROJECT_SECTION_ENTRY_SIZE];
+    size_t fileSize;
+    size_t headerSize = Writer_Header(&writer, header, &fileSize);
+    unsigned char *p = ByteBuffer_Reserve(out, fileSize);
+    if (p) {
+        memset(p, 0, fileSize);
+        memcpy(p, header, headerSize);
+        p += headerSize;
+
+        WriterSection sections[PROJECT_SECTION_COUNT];
+        int sectionCount = Writer_Sections(&writer, sections);
+        for (int i = 0; i < sectionCount; i++) {
+            size_t size = sections[i].buffer->size;
+            if (size) memcpy(p, sections[i].buffer->data, size);
+            p += (size + 3) & ~(size_t)3;
+        }
+    }
+
+    Writer_Stats(&writer, fileSize, stats);
+    Writer_Free(&writer);
+    return p != NULL;
+}
+
+// CLEAR
+// Drops the whole graph and every transient pointer into it, the editor stays usable (empty)
+void Project_Clear(Context *context) {
+    NodePool *pool = context->pool;
+
+    Autosave_Cancel(context);
+    SceneStore_Close(context);  // its chunks describe the graph that is going away
+
+    for (Node *node = context->zHead; node; node = node->nextZ) {
+        if (node->type == NODE_DEFAULT) free(node->data.defaultNode.text);
+    }
+    for (int s = 0; s < context->sceneList.count; s++) {
+        SceneOutline_Free(&context->sceneList.scenes[s]);
+    }
+    FileMap_Close(&context->projectMap);
+
+    SpatialGrid_Destroy(&context->grid);
+    EdgeStore_Destroy(&context->edges);
+    NodePool_Destroy(pool);
+    NodePool_Init(pool);
+    EdgeStore_Init(&context->edges);
+    SpatialGrid_Init(&context->grid);
+
+    context->sceneList.count = 0;
+    context->isDragging = false;
+    context->draggedNode = NULL;
+    context->dragCandidateNode = NULL;
+    context->bringToFront = NULL;
+    context->connecting = false;
+    context->connectingFromNode = NULL;
+    context->connectingFromConnectorIndex = -1;
+    context->hoveredInputNode = NULL;
+    context->hoveredInputConnectorIndex = -1;
+    context->isDrawingScene = false;
+    context->draggedScene = NULL;
+    context->isResizingScene = false;
+    context->isResizingSceneVertically = false;
+    context->resizingScene = NULL;
+    context->membershipQueueCount = 0;
+    context->scenesDirty = false;
+    context->visibleCount = 0;
+    context->zHead = NULL;
+    context->zTail = NULL;
+    context->zTopKey = 0;
+    context->zBottomKey = 0;
+    RequestRedraw(context);
+}
+
+// LOAD
+typedef struct {
+    const unsigned char *data;
+    uint32_t count;     // records in the section
+    uint32_t size;      // bytes
+} ProjectSection;
+
+// Checks header, section table and every cross reference before the current project is touched
+static bool Project_Parse(const unsigned char *file, size_t fileSize, ProjectSection sections[PROJECT_SECTION_COUNT]) {
+    static const uint32_t recordSizes[PROJECT_SECTION_COUNT] = {
+        [PROJECT_SECTION_STRINGS] = 1,
+        [PROJECT_SECTION_NODES] = PROJECT_NODE_RECORD_SIZE,
+        [PROJECT_SECTION_LINKS] = PROJECT_LINK_RECORD_SIZE,
+        [PROJECT_SECTION_EDGES] = PROJECT_EDGE_RECORD_SIZE,
+        [PROJECT_SECTION_SCENES] = PROJECT_SCENE_RECORD_SIZE,
+        [PROJECT_SECTION_SCENE_MEMBERS] = 4,
+        [PROJECT_SECTION_VIEW] = PROJECT_VIEW_RECORD_SIZE,
+        [PROJECT_SECTION_JOURNAL] = PROJECT_JOURNAL_RECORD_SIZE
+    };
+
+    if (fileSize < PROJECT_HEADER_SIZE || memcmp(file, PROJECT_MAGIC, 4) != 0) return false;
+    if (Get_U32(file + 4) != PROJECT_VERSION) return false;
+
+    uint32_t sectionCount = Get_U32(file + 8);
+    if (sectionCount > (fileSize - PROJECT_HEADER_SIZE) / PROJECT_SECTION_ENTRY_SIZE) return false;
+
+    memset(sections, 0, PROJECT_SECTION_COUNT * sizeof(ProjectSection));
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        const unsigned char *entry = file + PROJECT_HEADER_SIZE + i * PROJECT_SECTION_ENTRY_SIZE;
+        uint32_t id = Get_U32(entry + 0);
+        uint32_t count = Get_U32(entry + 4);
+        uint32_t offset = Get_U32(entry + 8);
+        uint32_t size = Get_U32(entry + 12);
+
+        if (offset > fileSize || size > fileSize - offset) return false;
+        if (id == 0 || id >= PROJECT_SECTION_COUNT) continue;  // newer optional section, skip it
+        if ((uint64_t)count * recordSizes[id] != size) return false;
+        sections[id] = (ProjectSection){ file + offset, count, size };
+    }
+
+    uint32_t nodeCount = sections[PROJECT_SECTION_NODES].count;
+    uint32_t stringSize = sections[PROJECT_SECTION_STRINGS].size;
+
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_NODES].data + i * PROJECT_NODE_RECORD_SIZE;
+        uint32_t textOffset = Get_U32(p + 28);
+        uint32_t textLength = Get_U32(p + 32);
+        if (p[16] >= NODE_COUNT) return false;
+        if (textOffset > stringSize || textLength > stringSize - textOffset) return false;
+        if (!Node_ValidGeometry((Vector2){ Get_F32(p + 0), Get_F32(p + 4) }, (int32_t)Get_U32(p + 8), (int32_t)Get_U32(p + 12))) return false;
+    }
+
+    for (uint32_t i = 0; i < sections[PROJECT_SECTION_LINKS].count; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_LINKS].data + i * PROJECT_LINK_RECORD_SIZE;
+        uint16_t kind = Get_U16(p + 4);
+        uint16_t slot = Get_U16(p + 6);
+        if (Get_U32(p + 0) >= nodeCount || Get_U32(p + 8) > nodeCount || Get_U32(p + 12) > nodeCount) return false;
+        if (kind == PROJECT_LINK_CONNECTOR && slot >= MAX_CONNECTORS) return false;
+        if (kind == PROJECT_LINK_STACK_NEXT && slot >= 10) return false;
+    }
+
+    for (uint32_t i = 0; i < sections[PROJECT_SECTION_EDGES].count; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_EDGES].data + i * PROJECT_EDGE_RECORD_SIZE;
+        uint32_t from = Get_U32(p + 0);
+        uint32_t to = Get_U32(p + 4);
+        if (from == 0 || from > nodeCount || to == 0 || to > nodeCount) return false;
+    }
+
+    if (sections[PROJECT_SECTION_SCENES].count > MAX_SCENES) return false;
+    uint32_t memberCount = sections[PROJECT_SECTION_SCENE_MEMBERS].count;
+    for (uint32_t i = 0; i < sections[PROJECT_SECTION_SCENES].count; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_SCENES].data + i * PROJECT_SCENE_RECORD_SIZE;
+        uint32_t nameOffset = Get_U32(p + 16);
+        uint32_t nameLength = Get_U32(p + 20);
+        uint32_t first = Get_U32(p + 24);
+        uint32_t count = Get_U32(p + 28);
+        if (nameOffset > stringSize || nameLength > stringSize - nameOffset) return false;
+        if (first > memberCount || count > memberCount - first) return false;
+        if (!Scene_ValidBounds((Rectangle){ Get_F32(p + 0), Get_F32(p + 4), Get_F32(p + 8), Get_F32(p + 12) })) return false;
+    }
+    for (uint32_t i = 0; i < memberCount; i++) {
+        uint32_t ref = Get_U32(sections[PROJECT_SECTION_SCENE_MEMBERS].data + i * 4);
+        if (ref == 0 || ref > nodeCount) return false;
+    }
+
+    if (sections[PROJECT_SECTION_VIEW].count > 0) {
+        const unsigned char *p = sections[PROJECT_SECTION_VIEW].data;
+        if (!Camera_ValidView((Vector2){ Get_F32(p + 0), Get_F32(p + 4) }, Get_F32(p + 8))) return false;
+    }
+
+    return true;
+}
+
+static NodeHandle Loader_Handle(Node **nodes, uint32_t ref) {
+    return ref ? NodePool_Handle(nodes[ref - 1]) : (NodeHandle){0};
+}
+
+// Adds the parsed records on top of what the context already holds. Mapped text stays in the
+// file unless copyText is set (the data goes away once the call returns). nodes gets one entry
+// per node record. Returns false when the pool ran out of memory, nodes built so far stay.
+static bool Project_Build(Context *context, const ProjectSection sections[PROJECT_SECTION_COUNT], bool copyText,
+                          Node **nodes, ProjectStats *stats) {
+    uint32_t nodeCount = sections[PROJECT_SECTION_NODES].count;
+    const unsigned char *strings = sections[PROJECT_SECTION_STRINGS].data;
+    unsigned int lastSaveKey = context->pool->lastSaveKey;
+    bool ok = true;
+
+    // === Nodes, pushed on top in file order ===
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_NODES].data + i * PROJECT_NODE_RECORD_SIZE;
+        Node *node = NodePool_Alloc(context->pool);
+        if (!node) {
+            nodeCount = i;
+            ok = false;
+            break;
+        }
+
+        node->position = (Vector2){ Get_F32(p + 0), Get_F32(p + 4) };
+        node->width = (int)Get_U32(p + 8);
+        node->height = (int)Get_U32(p + 12);
+        node->type = (NodeType)p[16];
+        node->isExpanded = (p[17] & 1) != 0;
+        memcpy(node->id, p + 20, 8);
+        node->id[8] = '\0';
+        SetNodePayloadValue(node, (int32_t)Get_U32(p + 36));
+
+        // files written before the journal carry no save keys, the one the pool handed out will do
+        if (Get_U32(p + 40)) node->saveKey = Get_U32(p + 40);
+        if (node->saveKey > lastSaveKey) lastSaveKey = node->saveKey;
+
+        uint32_t textLength = Get_U32(p + 32);
+        if (node->type == NODE_DEFAULT && textLength > 0) {
+            node->data.defaultNode.mappedText = (const char *)strings + Get_U32(p + 28);
+            node->data.defaultNode.mappedLength = textLength;
+            if ((copyText || node->isExpanded) && !Node_MaterializeText(node) && copyText) {
+                node->data.defaultNode.mappedText = NULL;
+                node->data.defaultNode.mappedLength = 0;
+                ok = false;
+            }
+        }
+
+        RegisterBasicConnectors(node);
+        ZList_PushTop(node, context);
+        SpatialGrid_Update(&context->grid, node);
+        nodes[i] = node;
+    }
+
+    // === Links ===
+    uint32_t linkCount = ok ? sections[PROJECT_SECTION_LINKS].count : 0;
+    for (uint32_t i = 0; i < linkCount; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_LINKS].data + i * PROJECT_LINK_RECORD_SIZE;
+        Node *node = nodes[Get_U32(p + 0)];
+        uint16_t slot = Get_U16(p + 6);
+        Connection connection = {
+            .from = Loader_Handle(nodes, Get_U32(p + 8)),
+            .to = Loader_Handle(nodes, Get_U32(p + 12))
+        };
+
+        switch (Get_U16(p + 4)) {
+            case PROJECT_LINK_CONNECTOR:
+                node->connectors[slot].with = connection;
+                break;
+            case PROJECT_LINK_DEFAULT_NEXT:
+                if (node->type == NODE_DEFAULT) node->data.defaultNode.next = connection;
+                break;
+            case PROJECT_LINK_STACK_NEXT:
+                if (node->type == NODE_STACK) node->data.stackNode.next[slot] = connection;
+                break;
+            default:
+                break;  // unknown kinds from newer files are ignored
+        }
+    }
+
+    // === Edges ===
+    uint32_t edgeCount = ok ? sections[PROJECT_SECTION_EDGES].count : 0;
+    for (uint32_t i = 0; i < edgeCount; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_EDGES].data + i * PROJECT_EDGE_RECORD_SIZE;
+        BezierCurve curve = {
+            .fromNode = Loader_Handle(nodes, Get_U32(p + 0)),
+            .toNode = Loader_Handle(nodes, Get_U32(p + 4))
+        };
+        for (int k = 0; k < 4; k++) {
+            curve.points[k] = (Vector2){ Get_F32(p + 8 + k * 8), Get_F32(p + 12 + k * 8) };
+        }
+        for (int k = 0; k < 2; k++) {
+            curve.relativeposition[k] = (Vector2){ Get_F32(p + 40 + k * 8), Get_F32(p + 44 + k * 8) };
+        }
+        if (EdgeStore_Add(&context->edges, context->pool, curve) < 0) ok = false;
+    }
+
+    // === Scenes, membership comes back exactly as saved ===
+    uint32_t sceneCount = ok ? sections[PROJECT_SECTION_SCENES].count : 0;
+    for (uint32_t i = 0; i < sceneCount && context->sceneList.count < MAX_SCENES; i++) {
+        const unsigned char *p = sections[PROJECT_SECTION_SCENES].data + i * PROJECT_SCENE_RECORD_SIZE;
+        SceneOutline *scene = &context->sceneList.scenes[context->sceneList.count++];
+        *scene = (SceneOutline){
+            .bounds = { Get_F32(p + 0), Get_F32(p + 4), Get_F32(p + 8), Get_F32(p + 12) }
+        };
+
+        uint32_t nameLength = Get_U32(p + 20);
+        if (nameLength >= sizeof(scene->name)) nameLength = sizeof(scene->name) - 1;
+        memcpy(scene->name, strings + Get_U32(p + 16), nameLength);
+        scene->name[nameLength] = '\0';
+
+        const unsigned char *members = sections[PROJECT_SECTION_SCENE_MEMBERS].data + Get_U32(p + 24) * 4;
+        for (uint32_t m = 0; m < Get_U32(p + 28); m++) {
+            SceneOutline_AddNode(scene, nodes[Get_U32(members + m * 4) - 1]);
+        }
+    }
+
+    context->pool->lastSaveKey = lastSaveKey;
+    if (stats) {
+        *stats = (ProjectStats){
+            .nodes = nodeCount,
+            .links = linkCount,
+            .edges = edgeCount,
+            .scenes = sceneCount
+        };
+    }
+    return ok;
+}
+
+// The file is mapped, not read: records are decoded straight from the mapping and dialogue text
+// stays there as offsets until a node is expanded or edited (see Node_MaterializeText)
+bool Project_Load(Context *context, const char *path, ProjectStats *stats) {
+    FileMap map;
+    if (!FileMap_Open(&map, path)) {
+        TraceLog(LOG_WARNING, "PROJECT: Could not map [%s]", path);
+        return false;
+    }
+
+    ProjectSection sections[PROJECT_SECTION_COUNT];
+    if (!Project_Parse(map.data, map.size, sections)) {
+        FileMap_Close(&map);
+        TraceLog(LOG_WARNING, "PROJECT: [%s] is not a valid version %d project", path, PROJECT_VERSION);
+        return false;
+    }
+
+    Node **nodes = malloc((sections[PROJECT_SECTION_NODES].count + 1) * sizeof(Node *));
+    if (!nodes) {
+        FileMap_Close(&map);
+        return false;
+    }
+
+    // the old mapping goes away with the old project, the new one lives until the next clear
+    Project_Clear(context);
+    context->projectMap = map;
+    strncpy(context->projectMapPath, path, sizeof(context->projectMapPath) - 1);
+    context->projectMapPath[sizeof(context->projectMapPath) - 1] = '\0';
+
+    uint32_t journalSeq = 0;
+    if (sections[PROJECT_SECTION_JOURNAL].count > 0) {
+        journalSeq = Get_U32(sections[PROJECT_SECTION_JOURNAL].data + 0);
+        context->pool->lastSaveKey = Get_U32(sections[PROJECT_SECTION_JOURNAL].data + 4);
+    }
+
+    ProjectStats built;
+    bool ok = Project_Build(context, sections, false, nodes, &built);
+
+    // === View ===
+    if (sections[PROJECT_SECTION_VIEW].count > 0) {
+        const unsigned char *p = sections[PROJECT_SECTION_VIEW].data;
+        context->camera.target = (Vector2){ Get_F32(p + 0), Get_F32(p + 4) };
+        context->camera.zoom = Get_F32(p + 8);   // Project_Parse checked the view
+    }
+
+    if (stats) {
+        *stats = built;
+        stats->edges = (uint32_t)context->edges.count;
+        stats->scenes = (uint32_t)context->sceneList.count;
+        stats->bytes = (uint32_t)map.size;
+        stats->journalSeq = journalSeq;
+    }
+
+    free(nodes);
+    if (!ok) TraceLog(LOG_WARNING, "PROJECT: [%s] was only partially loaded, out of memory", path);
+    return ok;
+}
+
+// Adds a project image (a scene chunk) to the open project instead of replacing it. Text is copied
+// out, the data is not needed afterwards. Returns the nodes in file order, NULL when the data is not
+// a valid project; on out of memory the nodes built so far are returned and *complete is false.
+Node** Project_LoadChunk(Context *context, const unsigned char *data, size_t size, uint32_t *nodeCount, bool *complete) {
+    ProjectSection sections[PROJECT_SECTION_COUNT];
+    *nodeCount = 0;
+    *complete = false;
+    if (!Project_Parse(data, size, sections)) return NULL;
+
+    Node **nodes = malloc((sections[PROJECT_SECTION_NODES].count + 1) * sizeof(Node *));
+    if (!nodes) return NULL;
+
+    ProjectStats built;
+    *complete = Project_Build(context, sections, true, nodes, &built);
+    *nodeCount = built.nodes;
+    return nodes;
+}
@@ -0,0 +1,124 @@
+#ifndef PROJECT_H
+#define PROJECT_H
+
+#include "core.h"
+#include <stdint.h>
+#include <string.h>
+
+// Binary project file (.nprose)
+// Little-endian, versioned. A fixed header is followed by a section table and flat sections of
+// fixed-size records. Records never hold pointers: nodes are referenced by their record index
+// (stored +1 so 0 means "no node") and strings by offset/length into the string table.
+#define PROJECT_MAGIC "NPRJ"
+#define PROJECT_VERSION 1
+#define PROJECT_FILE_PATH "project.nprose"
+
+typedef enum {
+    PROJECT_SECTION_STRINGS = 1,    // raw UTF-8 bytes, not null terminated
+    PROJECT_SECTION_NODES,          // ProjectNodeRecord, bottom to top in z-order
+    PROJECT_SECTION_LINKS,          // ProjectLinkRecord, every Connection held by a node
+    PROJECT_SECTION_EDGES,          // ProjectEdgeRecord, permanent bezier curves
+    PROJECT_SECTION_SCENES,         // ProjectSceneRecord
+    PROJECT_SECTION_SCENE_MEMBERS,  // uint32 node references, sliced by the scene records
+    PROJECT_SECTION_VIEW,           // camera target and zoom
+    PROJECT_SECTION_JOURNAL,        // last journal batch folded into this file, see journal.h
+    PROJECT_SECTION_COUNT
+} ProjectSectionId;
+
+// On-disk record sizes in bytes, the layout is written field by field in project.c
+#define PROJECT_HEADER_SIZE 16      // magic[4], u32 version, u32 sectionCount, u32 flags
+#define PROJECT_SECTION_ENTRY_SIZE 16   // u32 id, u32 itemCount, u32 offset, u32 size
+#define PROJECT_NODE_RECORD_SIZE 48
+#define PROJECT_LINK_RECORD_SIZE 16
+#define PROJECT_EDGE_RECORD_SIZE 56
+#define PROJECT_SCENE_RECORD_SIZE 32
+#define PROJECT_VIEW_RECORD_SIZE 12
+#define PROJECT_JOURNAL_RECORD_SIZE 8   // u32 journal sequence, u32 last save key
+
+// Which Connection of a node a link record restores
+typedef enum {
+    PROJECT_LINK_CONNECTOR,         // Node.connectors[slot].with
+    PROJECT_LINK_DEFAULT_NEXT,      // data.defaultNode.next
+    PROJECT_LINK_STACK_NEXT         // data.stackNode.next[slot]
+} ProjectLinkKind;
+
+typedef struct {
+    uint32_t nodes;
+    uint32_t links;
+    uint32_t edges;
+    uint32_t scenes;
+    uint32_t bytes;
+    uint32_t journalSeq;    // load: journal batches up to this one are already in the file
+} ProjectStats;
+
+// Everything the writer needs, either the live editor state or a frozen autosave snapshot
+typedef struct {
+    const NodePool *pool;       // resolves handles
+    Node *const *nodes;         // live nodes, bottom to top
+    uint32_t nodeCount;
+    const EdgeStore *edges;
+    const SceneList *scenes;
+    Camera2D camera;
+    uint32_t journalSeq;        // last journal batch the source already contains, 0 without a journal
+    uint32_t lastSaveKey;       // NodePool.lastSaveKey, so keys are not handed out twice after a reload
+    bool sortEdges;             // curves in a fixed order instead of edge store order, equal graphs give equal bytes
+} ProjectSource;
+
+// Growable output buffer, every section is built in one of these and written with a single fwrite
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+    bool failed;        // sticky out-of-memory flag, checked once before writing
+} ByteBuffer;
+
+unsigned char* ByteBuffer_Reserve(ByteBuffer *buffer, size_t bytes);
+
+// Little-endian stores and loads, byte by byte so the file layout never depends on the host
+static inline void Put_U16(unsigned char *p, uint16_t value) {
+    p[0] = (unsigned char)(value);
+    p[1] = (unsigned char)(value >> 8);
+}
+
+static inline void Put_U32(unsigned char *p, uint32_t value) {
+    p[0] = (unsigned char)(value);
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+static inline void Put_F32(unsigned char *p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Put_U32(p, bits);
+}
+
+static inline uint16_t Get_U16(const unsigned char *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t Get_U32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline float Get_F32(const unsigned char *p) {
+    uint32_t bits = Get_U32(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Scalar payload of the node union, one int per type is all the editor stores today
+int32_t NodePayloadValue(const Node *node);
+void SetNodePayloadValue(Node *node, int32_t value);
+
+bool Project_Save(Context *context, const char *path, ProjectStats *stats);
+bool Project_SaveAt(Context *context, const char *path, uint32_t journalSeq, bool durable, ProjectStats *stats);
+bool Project_WriteFile(const ProjectSource *source, const char *path, bool durable, ProjectStats *stats);
+bool Project_WriteBuffer(const ProjectSource *source, ByteBuffer *out, ProjectStats *stats);
+bool Project_Load(Context *context, const char *path, ProjectStats *stats);
+Node** Project_LoadChunk(Context *context, const unsigned char *data, size_t size, uint32_t *nodeCount, bool *complete);
+void Project_Clear(Context *context);
+bool Project_DetachMap(Context *context);
+
+#endif
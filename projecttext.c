@@ -0,0 +1,838 @@
+#include "raylib.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "projecttext.h"
+
+// Names used in the file, indexed by NodeType and ProjectLinkKind
+static const char *nodeTypeNames[NODE_COUNT] = {
+    "default", "stack", "random", "random-bag", "choice", "skill-gate", "goto", "conditional"
+};
+static const char *linkKindNames[] = { "connector", "next", "stack" };
+#define LINK_KIND_COUNT ((int)(sizeof(linkKindNames) / sizeof(linkKindNames[0])))
+
+static bool Text_IsIdChar(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+static bool Text_IsId(const char *id, size_t length) {
+    if (length == 0 || length > 8 || (length == 1 && id[0] == '-')) return false;
+    for (size_t i = 0; i < length; i++) {
+        if (!Text_IsIdChar(id[i])) return false;
+    }
+    return true;
+}
+
+// Fewest digits that read back to the exact same float, a load never changes what the next save prints.
+// Canvas coordinates are mostly whole or have a few decimals, those are printed as fixed point
+// without going through printf; the rest takes the shortest %g that reads back to the same bits.
+static const char* Text_Float(char buffer[32], float value) {
+    static const double scales[] = { 1.0, 10.0, 100.0, 1000.0 };
+    for (int decimals = 0; decimals < 4 && (value != 0.0f || !signbit(value)); decimals++) {
+        double scaled = (double)value * scales[decimals];
+        if (!(fabs(scaled) < 1e7)) break;  // also NaN and infinities
+        long digits = lround(scaled);
+        if ((float)(digits / scales[decimals]) != value) continue;
+
+        // digits backwards, at least one before the decimal point
+        char reversed[16];
+        int count = 0;
+        unsigned long rest = (unsigned long)labs(digits);
+        do {
+            reversed[count++] = (char)('0' + rest % 10);
+            rest /= 10;
+        } while (rest > 0 || count <= decimals);
+
+        char *out = buffer;
+        if (digits < 0) *out++ = '-';
+        while (count > 0) {
+            if (count == decimals) *out++ = '.';
+            *out++ = reversed[--count];
+        }
+        *out = '\0';
+        return buffer;
+    }
+    for (int precision = 6; precision < 9; precision++) {
+        snprintf(buffer, 32, "%.*g", precision, value);
+        float back = strtof(buffer, NULL);
+        if (memcmp(&back, &value, sizeof(float)) == 0) return buffer;
+    }
+    snprintf(buffer, 32, "%.9g", value);  // 9 significant digits always round-trip a float
+    return buffer;
+}
+
+// SAVE
+typedef struct {
+    const char *from;
+    const char *to;
+    const BezierCurve *curve;
+} TextCurve;
+
+static int CompareNodeId(const void *a, const void *b) {
+    const Node *x = *(Node *const *)a;
+    const Node *y = *(Node *const *)b;
+    int order = strcmp(x->id, y->id);
+    if (order) return order;
+    return (x->saveKey > y->saveKey) - (x->saveKey < y->saveKey);
+}
+
+static int CompareIdString(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+static int CompareCurve(const void *a, const void *b) {
+    const TextCurve *x = a;
+    const TextCurve *y = b;
+    int order = strcmp(x->from, y->from);
+    if (!order) order = strcmp(x->to, y->to);
+    if (!order) order = memcmp(x->curve->points, y->curve->points, sizeof(x->curve->points));
+    if (!order) order = memcmp(x->curve->relativeposition, y->curve->relativeposition, sizeof(x->curve->relativeposition));
+    return order;
+}
+
+// References in the file are IDs, so they have to be unique. IDs are random and only 8 characters,
+// a clash (or an ID mangled by hand) gets a fresh ID before anything is written. Leaves nodes sorted.
+static int Text_FixIds(Context *context, Node **nodes, uint32_t count) {
+    int renamed = 0;
+    bool again = true;
+    while (again) {
+        qsort(nodes, count, sizeof(Node *), CompareNodeId);
+        again = false;
+        for (uint32_t i = 0; i < count; i++) {
+            bool unique = i == 0 || strcmp(nodes[i]->id, nodes[i - 1]->id) != 0;
+            if (unique && Text_IsId(nodes[i]->id, strlen(nodes[i]->id))) continue;
+            NodePool_Touch(context->pool, nodes[i]);
+            GenerateRandomID(nodes[i]->id, 8);
+            renamed++;
+            again = true;
+        }
+    }
+    return renamed;
+}
+
+static void Text_WriteString(FILE *file, const char *text, size_t length) {
+    size_t run = 0;     // plain bytes since the last escape are written in one go
+    putc('"', file);
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c >= 0x20 && c != 0x7f && c != '"' && c != '\\') continue;
+        fwrite(text + run, 1, i - run, file);
+        run = i + 1;
+        switch (c) {
+            case '"':  fputs("\\\"", file); break;
+            case '\\': fputs("\\\\", file); break;
+            case '\n': fputs("\\n", file); break;
+            case '\r': fputs("\\r", file); break;
+            case '\t': fputs("\\t", file); break;
+            default:   fprintf(file, "\\x%02X", c); break;
+        }
+    }
+    fwrite(text + run, 1, length - run, file);
+    putc('"', file);
+}
+
+static int Text_WriteLink(FILE *file, const NodePool *pool, ProjectLinkKind kind, int slot, Connection connection) {
+    const Node *from = NodePool_Resolve(pool, connection.from);
+    const Node *to = NodePool_Resolve(pool, connection.to);
+    if (!from && !to) return 0;
+    fprintf(file, "  link %s %d %s %s\n", linkKindNames[kind], slot, from ? from->id : "-", to ? to->id : "-");
+    return 1;
+}
+
+// Streams the project straight into the file, only the sort orders are kept in memory
+bool ProjectText_Save(Context *context, const char *path, ProjectStats *stats) {
+    const NodePool *pool = context->pool;
+    uint32_t nodeCount = 0;
+    Node **nodes = malloc((pool->liveCount + 1) * sizeof(Node *));
+    const char **members = malloc((pool->liveCount + 1) * sizeof(const char *));
+    TextCurve *curves = malloc((context->edges.count + 1) * sizeof(TextCurve));
+    if (!nodes || !members || !curves) {
+        free(nodes);
+        free(members);
+        free(curves);
+        TraceLog(LOG_WARNING, "PROJECT: Out of memory while saving [%s]", path);
+        return false;
+    }
+
+    for (Node *node = context->zHead; node; node = node->nextZ) nodes[nodeCount++] = node;
+    int renamed = Text_FixIds(context, nodes, nodeCount);
+    if (renamed) TraceLog(LOG_WARNING, "PROJECT: %d nodes with a duplicate or invalid ID got a new one", renamed);
+
+    char tmpPath[268];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    FILE *file = fopen(tmpPath, "wb");  // binary: the same bytes on every platform
+    if (!file) {
+        free(nodes);
+        free(members);
+        free(curves);
+        TraceLog(LOG_WARNING, "PROJECT: Could not open [%s] for writing", tmpPath);
+        return false;
+    }
+
+    char a[32], b[32], c[32], d[32];
+    uint32_t linkCount = 0;
+    fprintf(file, "%s %d\n", PROJECT_TEXT_MAGIC, PROJECT_TEXT_VERSION);
+
+    // === Nodes, sorted by ID ===
+    fputs("\n[nodes]\n", file);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const Node *node = nodes[i];
+        if (i > 0) putc('\n', file);
+        fprintf(file, "node %s %s\n", node->id, nodeTypeNames[node->type]);
+
+        unsigned int textLength = 0;
+        const char *text = Node_TextView(node, &textLength);
+        if (textLength > 0) {
+            fputs("  text ", file);
+            Text_WriteString(file, text, textLength);
+            putc('\n', file);
+        }
+        int32_t payload = NodePayloadValue(node);
+        if (payload != 0) fprintf(file, "  payload %ld\n", (long)payload);
+
+        for (int s = 0; s < MAX_CONNECTORS; s++) {
+            linkCount += Text_WriteLink(file, pool, PROJECT_LINK_CONNECTOR, s, node->connectors[s].with);
+        }
+        if (node->type == NODE_DEFAULT) {
+            linkCount += Text_WriteLink(file, pool, PROJECT_LINK_DEFAULT_NEXT, 0, node->data.defaultNode.next);
+        } else if (node->type == NODE_STACK) {
+            for (int s = 0; s < 10; s++) {
+                linkCount += Text_WriteLink(file, pool, PROJECT_LINK_STACK_NEXT, s, node->data.stackNode.next[s]);
+            }
+        }
+    }
+
+    // === Scenes, members sorted by ID ===
+    fputs("\n[scenes]\n", file);
+    for (int s = 0; s < context->sceneList.count; s++) {
+        const SceneOutline *scene = &context->sceneList.scenes[s];
+        const char *nameEnd = memchr(scene->name, '\0', sizeof(scene->name));
+        size_t nameLength = nameEnd ? (size_t)(nameEnd - scene->name) : sizeof(scene->name);
+
+        if (s > 0) putc('\n', file);
+        fputs("scene ", file);
+        Text_WriteString(file, scene->name, nameLength);
+        fprintf(file, " %s %s %s %s\n", Text_Float(a, scene->bounds.x), Text_Float(b, scene->bounds.y),
+                Text_Float(c, scene->bounds.width), Text_Float(d, scene->bounds.height));
+
+        uint32_t memberCount = 0;
+        for (int n = 0; n < scene->nodeCount && memberCount < nodeCount; n++) {
+            const Node *node = NodePool_Resolve(pool, scene->containedNodes[n]);
+            if (node) members[memberCount++] = node->id;
+        }
+        qsort(members, memberCount, sizeof(const char *), CompareIdString);
+        for (uint32_t m = 0; m < memberCount; m++) {
+            if (m > 0 && strcmp(members[m], members[m - 1]) == 0) continue;
+            fprintf(file, "  member %s\n", members[m]);
+        }
+    }
+
+    // === Layout, sorted by ID ===
+    fputs("\n[layout]\n", file);
+    for (uint32_t i = 0; i < nodeCount; i++) {
+        const Node *node = nodes[i];
+        fprintf(file, "%s %s %s %d %d %s\n", node->id, Text_Float(a, node->position.x), Text_Float(b, node->position.y),
+                node->width, node->height, node->isExpanded ? "expanded" : "collapsed");
+    }
+
+    // === Z-order, bottom to top: bringing a node to the front moves one line ===
+    fputs("\n[order]\n", file);
+    for (const Node *node = context->zHead; node; node = node->nextZ) fprintf(file, "%s\n", node->id);
+
+    // === Curves, sorted by their end nodes ===
+    uint32_t curveCount = 0;
+    for (int i = 0; i < context->edges.count; i++) {
+        const BezierCurve *curve = EdgeStore_At(&context->edges, i);
+        const Node *from = NodePool_Resolve(pool, curve->fromNode);
+        const Node *to = NodePool_Resolve(pool, curve->toNode);
+        if (from && to) curves[curveCount++] = (TextCurve){ from->id, to->id, curve };
+    }
+    qsort(curves, curveCount, sizeof(TextCurve), CompareCurve);
+
+    fputs("\n[curves]\n", file);
+    for (uint32_t i = 0; i < curveCount; i++) {
+        const BezierCurve *curve = curves[i].curve;
+        fprintf(file, "%s %s", curves[i].from, curves[i].to);
+        for (int k = 0; k < 4; k++) {
+            fprintf(file, " %s %s", Text_Float(a, curve->points[k].x), Text_Float(b, curve->points[k].y));
+        }
+        for (int k = 0; k < 2; k++) {
+            fprintf(file, " %s %s", Text_Float(a, curve->relativeposition[k].x), Text_Float(b, curve->relativeposition[k].y));
+        }
+        putc('\n', file);
+    }
+
+    long size = ftell(file);
+    bool ok = !ferror(file) && fflush(file) == 0 && File_Sync(file);
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && File_Replace(tmpPath, path);
+
+    if (stats) {
+        *stats = (ProjectStats){
+            .nodes = nodeCount,
+            .links = linkCount,
+            .edges = curveCount,
+            .scenes = (uint32_t)context->sceneList.count,
+            .bytes = size > 0 ? (uint32_t)size : 0
+        };
+    }
+
+    free(nodes);
+    free(members);
+    free(curves);
+    if (!ok) TraceLog(LOG_WARNING, "PROJECT: Failed writing [%s]", path);
+    return ok;
+}
+
+// LOAD
+// Node by ID, open addressing over a power of two table
+typedef struct {
+    Node **slots;
+    uint32_t capacity;
+    uint32_t count;
+} IdMap;
+
+static uint32_t IdMap_Hash(const char *id, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) hash = (hash ^ (unsigned char)id[i]) * 16777619u;
+    return hash;
+}
+
+static Node** IdMap_Find(const IdMap *map, const char *id, size_t length) {
+    uint32_t mask = map->capacity - 1;
+    uint32_t i = IdMap_Hash(id, length) & mask;
+    while (map->slots[i]) {
+        const Node *node = map->slots[i];
+        if (strncmp(node->id, id, length) == 0 && node->id[length] == '\0') break;
+        i = (i + 1) & mask;
+    }
+    return &map->slots[i];
+}
+
+static Node* IdMap_Get(const IdMap *map, const char *id, size_t length) {
+    return map->capacity ? *IdMap_Find(map, id, length) : NULL;
+}
+
+static bool IdMap_Put(IdMap *map, Node *node) {
+    if ((map->count + 1) * 2 > map->capacity) {
+        uint32_t newCapacity = map->capacity ? map->capacity * 2 : 1024;
+        Node **slots = calloc(newCapacity, sizeof(Node *));
+        if (!slots) return false;
+        IdMap grown = { slots, newCapacity, map->count };
+        for (uint32_t i = 0; i < map->capacity; i++) {
+            Node *old = map->slots[i];
+            if (old) *IdMap_Find(&grown, old->id, strlen(old->id)) = old;
+        }
+        free(map->slots);
+        *map = grown;
+    }
+    *IdMap_Find(map, node->id, strlen(node->id)) = node;
+    map->count++;
+    return true;
+}
+
+typedef struct {
+    const char *start;
+    size_t length;
+} TextToken;
+
+static bool Token_Is(TextToken token, const char *word) {
+    return token.length == strlen(word) && memcmp(token.start, word, token.length) == 0;
+}
+
+// Links may point at nodes further down the file, they are resolved once every node exists
+typedef struct {
+    Node *node;
+    unsigned char kind;
+    unsigned char slot;
+    char from[9];   // empty for "-"
+    char to[9];
+} PendingLink;
+
+typedef enum {
+    TEXT_SECTION_NONE,
+    TEXT_SECTION_NODES,
+    TEXT_SECTION_SCENES,
+    TEXT_SECTION_LAYOUT,
+    TEXT_SECTION_ORDER,
+    TEXT_SECTION_CURVES
+} TextSection;
+
+typedef struct {
+    const char *path;
+    int line;
+    const char *cursor;     // rest of the current line
+    const char *end;        // end of the current line, without the line break
+    bool header;
+    TextSection section;
+    Context *staging;       // the graph is built here and swapped in once the whole file parsed
+    IdMap ids;
+    Node **nodes;           // file order
+    uint32_t nodeCount;
+    uint32_t nodeCapacity;
+    PendingLink *links;
+    uint32_t linkCount;
+    uint32_t linkCapacity;
+    Node *currentNode;      // block the field lines belong to
+    SceneOutline *currentScene;
+    ByteBuffer string;      // decoded quoted string
+    int dropped;            // references to nodes that are not in the file
+} TextParser;
+
+static bool Parser_Fail(TextParser *parser, const char *message) {
+    TraceLog(LOG_WARNING, "PROJECT: [%s] line %d: %s", parser->path, parser->line, message);
+    return false;
+}
+
+static void Parser_SkipBlanks(TextParser *parser) {
+    while (parser->cursor < parser->end && (*parser->cursor == ' ' || *parser->cursor == '\t')) parser->cursor++;
+}
+
+static bool Parser_Word(TextParser *parser, TextToken *token) {
+    Parser_SkipBlanks(parser);
+    token->start = parser->cursor;
+    while (parser->cursor < parser->end && *parser->cursor != ' ' && *parser->cursor != '\t') parser->cursor++;
+    token->length = (size_t)(parser->cursor - token->start);
+    return token->length > 0;
+}
+
+static bool Parser_End(TextParser *parser) {
+    Parser_SkipBlanks(parser);
+    return parser->cursor == parser->end || *parser->cursor == '#';
+}
+
+static bool Parser_Number(TextParser *parser, char buffer[64]) {
+    TextToken token;
+    if (!Parser_Word(parser, &token) || token.length >= 64) return false;
+    memcpy(buffer, token.start, token.length);
+    buffer[token.length] = '\0';
+    return true;
+}
+
+static bool Parser_Float(TextParser *parser, float *value) {
+    char buffer[64];
+    char *end;
+    if (!Parser_Number(parser, buffer)) return false;
+    *value = strtof(buffer, &end);
+    return *end == '\0' && isfinite(*value);
+}
+
+static bool Parser_Int(TextParser *parser, long min, long max, long *value) {
+    char buffer[64];
+    char *end;
+    if (!Parser_Number(parser, buffer)) return false;
+    *value = strtol(buffer, &end, 10);
+    return *end == '\0' && *value >= min && *value <= max;
+}
+
+// Node ID, or "-" for no node (ref->length == 0)
+static bool Parser_Ref(TextParser *parser, TextToken *ref, bool allowEmpty) {
+    if (!Parser_Word(parser, ref)) return false;
+    if (allowEmpty && ref->length == 1 && ref->start[0] == '-') {
+        ref->length = 0;
+        return true;
+    }
+    return Text_IsId(ref->start, ref->length);
+}
+
+static Node* Parser_Lookup(TextParser *parser, TextToken ref) {
+    Node *node = IdMap_Get(&parser->ids, ref.start, ref.length);
+    if (!node) parser->dropped++;
+    return node;
+}
+
+// Quoted string with \" \\ \n \r \t \xHH escapes, decoded into parser->string
+static bool Parser_String(TextParser *parser) {
+    Parser_SkipBlanks(parser);
+    parser->string.size = 0;
+    if (parser->cursor == parser->end || *parser->cursor != '"') return false;
+    parser->cursor++;
+
+    while (parser->cursor < parser->end && *parser->cursor != '"') {
+        const char *run = parser->cursor;
+        while (parser->cursor < parser->end && *parser->cursor != '"' && *parser->cursor != '\\') parser->cursor++;
+        size_t length = (size_t)(parser->cursor - run);
+        unsigned char *out = ByteBuffer_Reserve(&parser->string, length + 1);
+        if (!out) return false;
+        memcpy(out, run, length);
+        parser->string.size--;  // the extra byte is kept for the escape below
+
+        if (parser->cursor == parser->end || *parser->cursor == '"') break;
+        if (parser->end - parser->cursor < 2) return false;
+        char escape = parser->cursor[1];
+        unsigned char c;
+        parser->cursor += 2;
+        switch (escape) {
+            case '"':  c = '"'; break;
+            case '\\': c = '\\'; break;
+            case 'n':  c = '\n'; break;
+            case 'r':  c = '\r'; break;
+            case 't':  c = '\t'; break;
+            case 'x': {
+                char hex[3] = {0};
+                char *end;
+                if (parser->end - parser->cursor < 2) return false;
+                memcpy(hex, parser->cursor, 2);
+                c = (unsigned char)strtoul(hex, &end, 16);
+                if (end != hex + 2) return false;
+                parser->cursor += 2;
+                break;
+            }
+            default:
+                return false;
+        }
+        parser->string.data[parser->string.size++] = c;
+    }
+    if (parser->cursor == parser->end) return false;
+    parser->cursor++;  // closing quote
+    return true;
+}
+
+static bool Parser_NodeLine(TextParser *parser, TextToken word) {
+    Context *staging = parser->staging;
+
+    if (Token_Is(word, "node")) {
+        TextToken id, typeName;
+        if (!Parser_Ref(parser, &id, false)) return Parser_Fail(parser, "expected a node ID");
+        if (!Parser_Word(parser, &typeName) || !Parser_End(parser)) return Parser_Fail(parser, "expected a node type");
+        int type = 0;
+        while (type < NODE_COUNT && !Token_Is(typeName, nodeTypeNames[type])) type++;
+        if (type == NODE_COUNT) return Parser_Fail(parser, "unknown node type");
+        if (IdMap_Get(&parser->ids, id.start, id.length)) return Parser_Fail(parser, "duplicate node ID");
+
+        if (parser->nodeCount == parser->nodeCapacity) {
+            uint32_t newCapacity = parser->nodeCapacity ? parser->nodeCapacity * 2 : 1024;
+            Node **nodes = realloc(parser->nodes, newCapacity * sizeof(Node *));
+            if (!nodes) return Parser_Fail(parser, "out of memory");
+            parser->nodes = nodes;
+            parser->nodeCapacity = newCapacity;
+        }
+        Node *node = NodePool_Alloc(staging->pool);
+        if (!node) return Parser_Fail(parser, "out of memory");
+        parser->nodes[parser->nodeCount++] = node;
+
+        node->width = 200;
+        node->height = 60;
+        node->type = (NodeType)type;
+        memcpy(node->id, id.start, id.length);
+        node->id[id.length] = '\0';
+        RegisterBasicConnectors(node);
+        if (!IdMap_Put(&parser->ids, node)) return Parser_Fail(parser, "out of memory");
+        parser->currentNode = node;
+        return true;
+    }
+
+    Node *node = parser->currentNode;
+    if (!node) return Parser_Fail(parser, "field outside of a node block");
+
+    if (Token_Is(word, "text")) {
+        if (!Parser_String(parser) || !Parser_End(parser)) return Parser_Fail(parser, "expected a quoted string");
+        if (node->type != NODE_DEFAULT) return Parser_Fail(parser, "only dialogue nodes have text");
+        char *text = malloc(parser->string.size + 1);
+        if (!text) return Parser_Fail(parser, "out of memory");
+        memcpy(text, parser->string.data, parser->string.size);
+        text[parser->string.size] = '\0';
+        free(node->data.defaultNode.text);
+        node->data.defaultNode.text = text;
+        return true;
+    }
+
+    if (Token_Is(word, "payload")) {
+        long value;
+        if (!Parser_Int(parser, INT32_MIN, INT32_MAX, &value) || !Parser_End(parser)) return Parser_Fail(parser, "expected a number");
+        SetNodePayloadValue(node, (int32_t)value);
+        return true;
+    }
+
+    if (Token_Is(word, "link")) {
+        TextToken kindName, from, to;
+        long slot;
+        int kind = 0;
+        if (!Parser_Word(parser, &kindName)) return Parser_Fail(parser, "expected a link kind");
+        while (kind < LINK_KIND_COUNT && !Token_Is(kindName, linkKindNames[kind])) kind++;
+        if (kind == LINK_KIND_COUNT) return Parser_Fail(parser, "unknown link kind");
+        if (!Parser_Int(parser, 0, MAX_CONNECTORS - 1, &slot)) return Parser_Fail(parser, "expected a slot");
+        if (!Parser_Ref(parser, &from, true) || !Parser_Ref(parser, &to, true) || !Parser_End(parser)) {
+            return Parser_Fail(parser, "expected two node IDs or '-'");
+        }
+        if ((kind == PROJECT_LINK_DEFAULT_NEXT && (node->type != NODE_DEFAULT || slot != 0)) ||
+            (kind == PROJECT_LINK_STACK_NEXT && (node->type != NODE_STACK || slot >= 10))) {
+            return Parser_Fail(parser, "link does not fit the node type");
+        }
+
+        if (parser->linkCount == parser->linkCapacity) {
+            uint32_t newCapacity = parser->linkCapacity ? parser->linkCapacity * 2 : 1024;
+            PendingLink *links = realloc(parser->links, newCapacity * sizeof(PendingLink));
+            if (!links) return Parser_Fail(parser, "out of memory");
+            parser->links = links;
+            parser->linkCapacity = newCapacity;
+        }
+        PendingLink *link = &parser->links[parser->linkCount++];
+        *link = (PendingLink){ .node = node, .kind = (unsigned char)kind, .slot = (unsigned char)slot };
+        memcpy(link->from, from.start, from.length);
+        memcpy(link->to, to.start, to.length);
+        return true;
+    }
+
+    return Parser_Fail(parser, "unknown node field");
+}
+
+static bool Parser_SceneLine(TextParser *parser, TextToken word) {
+    SceneList *list = &parser->staging->sceneList;
+
+    if (Token_Is(word, "scene")) {
+        Rectangle bounds;
+        if (!Parser_String(parser)) return Parser_Fail(parser, "expected a quoted scene name");
+        if (!Parser_Float(parser, &bounds.x) || !Parser_Float(parser, &bounds.y) ||
+            !Parser_Float(parser, &bounds.width) || !Parser_Float(parser, &bounds.height) || !Parser_End(parser)) {
+            return Parser_Fail(parser, "expected scene bounds");
+        }
+        if (!Scene_ValidBounds(bounds)) return Parser_Fail(parser, "scene bounds out of range");
+        if (list->count == MAX_SCENES) return Parser_Fail(parser, "too many scenes");
+
+        SceneOutline *scene = &list->scenes[list->count++];
+        *scene = (SceneOutline){ .bounds = bounds };
+        size_t nameLength = parser->string.size;
+        if (nameLength >= sizeof(scene->name)) nameLength = sizeof(scene->name) - 1;
+        memcpy(scene->name, parser->string.data, nameLength);
+        scene->name[nameLength] = '\0';
+        parser->currentScene = scene;
+        return true;
+    }
+
+    if (Token_Is(word, "member")) {
+        TextToken id;
+        if (!parser->currentScene) return Parser_Fail(parser, "member outside of a scene block");
+        if (!Parser_Ref(parser, &id, false) || !Parser_End(parser)) return Parser_Fail(parser, "expected a node ID");
+        Node *node = Parser_Lookup(parser, id);
+        if (node && !SceneOutline_HasNode(parser->currentScene, node)) SceneOutline_AddNode(parser->currentScene, node);
+        return true;
+    }
+
+    return Parser_Fail(parser, "unknown scene field");
+}
+
+static bool Parser_LayoutLine(TextParser *parser, TextToken id) {
+    Vector2 position;
+    long width, height;
+    TextToken state;
+    if (!Text_IsId(id.start, id.length)) return Parser_Fail(parser, "expected a node ID");
+    if (!Parser_Float(parser, &position.x) || !Parser_Float(parser, &position.y) ||
+        !Parser_Int(parser, INT32_MIN, INT32_MAX, &width) || !Parser_Int(parser, INT32_MIN, INT32_MAX, &height) ||
+        !Parser_Word(parser, &state) || !Parser_End(parser)) {
+        return Parser_Fail(parser, "expected position, size and state");
+    }
+    bool expanded = Token_Is(state, "expanded");
+    if (!expanded && !Token_Is(state, "collapsed")) return Parser_Fail(parser, "expected expanded or collapsed");
+    if (!Node_ValidGeometry(position, width, height)) return Parser_Fail(parser, "node position or size out of range");
+
+    Node *node = Parser_Lookup(parser, id);
+    if (!node) return true;
+    node->position = position;
+    node->width = (int)width;
+    node->height = (int)height;
+    node->isExpanded = expanded;
+    return true;
+}
+
+static bool Parser_OrderLine(TextParser *parser, TextToken id) {
+    if (!Text_IsId(id.start, id.length) || !Parser_End(parser)) return Parser_Fail(parser, "expected a node ID");
+    Node *node = Parser_Lookup(parser, id);
+    Context *staging = parser->staging;
+    if (node && !node->prevZ && staging->zHead != node) ZList_PushTop(node, staging);
+    return true;
+}
+
+static bool Parser_CurveLine(TextParser *parser, TextToken fromId) {
+    TextToken toId;
+    BezierCurve curve = {0};
+    bool ok = Text_IsId(fromId.start, fromId.length) && Parser_Ref(parser, &toId, false);
+    for (int k = 0; k < 4 && ok; k++) {
+        ok = Parser_Float(parser, &curve.points[k].x) && Parser_Float(parser, &curve.points[k].y);
+    }
+    for (int k = 0; k < 2 && ok; k++) {
+        ok = Parser_Float(parser, &curve.relativeposition[k].x) && Parser_Float(parser, &curve.relativeposition[k].y);
+    }
+    if (!ok || !Parser_End(parser)) return Parser_Fail(parser, "expected two node IDs and 12 coordinates");
+
+    Node *from = Parser_Lookup(parser, fromId);
+    Node *to = Parser_Lookup(parser, toId);
+    if (!from || !to) return true;
+    curve.fromNode = NodePool_Handle(from);
+    curve.toNode = NodePool_Handle(to);
+    if (EdgeStore_Add(&parser->staging->edges, parser->staging->pool, curve) < 0) return Parser_Fail(parser, "out of memory");
+    return true;
+}
+
+static bool Parser_Line(TextParser *parser) {
+    TextToken word;
+    if (!Parser_Word(parser, &word) || word.start[0] == '#') return true;  // blank line or comment
+
+    if (!parser->header) {
+        long version;
+        if (!Token_Is(word, PROJECT_TEXT_MAGIC)) return Parser_Fail(parser, "not a text project");
+        if (!Parser_Int(parser, 0, INT32_MAX, &version) || version != PROJECT_TEXT_VERSION || !Parser_End(parser)) {
+            return Parser_Fail(parser, "unsupported version");
+        }
+        parser->header = true;
+        return true;
+    }
+
+    if (word.start[0] == '[') {
+        static const struct { const char *name; TextSection section; } sections[] = {
+            { "[nodes]", TEXT_SECTION_NODES },
+            { "[scenes]", TEXT_SECTION_SCENES },
+            { "[layout]", TEXT_SECTION_LAYOUT },
+            { "[order]", TEXT_SECTION_ORDER },
+            { "[curves]", TEXT_SECTION_CURVES },
+        };
+        for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+            if (!Token_Is(word, sections[i].name)) continue;
+            parser->section = sections[i].section;
+            parser->currentNode = NULL;
+            parser->currentScene = NULL;
+            return Parser_End(parser) ? true : Parser_Fail(parser, "unexpected text after the section name");
+        }
+        return Parser_Fail(parser, "unknown section");
+    }
+
+    switch (parser->section) {
+        case TEXT_SECTION_NODES:  return Parser_NodeLine(parser, word);
+        case TEXT_SECTION_SCENES: return Parser_SceneLine(parser, word);
+        case TEXT_SECTION_LAYOUT: return Parser_LayoutLine(parser, word);
+        case TEXT_SECTION_ORDER:  return Parser_OrderLine(parser, word);
+        case TEXT_SECTION_CURVES: return Parser_CurveLine(parser, word);
+        default:                  return Parser_Fail(parser, "expected a section");
+    }
+}
+
+static Node* Parser_LinkEnd(TextParser *parser, const char *id) {
+    if (!id[0]) return NULL;
+    return Parser_Lookup(parser, (TextToken){ id, strlen(id) });
+}
+
+// Links, nodes missing from [order] and everything that depends on the final layout
+static void Parser_Finish(TextParser *parser) {
+    Context *staging = parser->staging;
+
+    for (uint32_t i = 0; i < parser->linkCount; i++) {
+        const PendingLink *link = &parser->links[i];
+        Node *from = Parser_LinkEnd(parser, link->from);
+        Node *to = Parser_LinkEnd(parser, link->to);
+        if (!from && !to) continue;
+
+        Connection connection = {
+            .from = from ? NodePool_Handle(from) : (NodeHandle){0},
+            .to = to ? NodePool_Handle(to) : (NodeHandle){0}
+        };
+        switch (link->kind) {
+            case PROJECT_LINK_CONNECTOR:    link->node->connectors[link->slot].with = connection; break;
+            case PROJECT_LINK_DEFAULT_NEXT: link->node->data.defaultNode.next = connection; break;
+            case PROJECT_LINK_STACK_NEXT:   link->node->data.stackNode.next[link->slot] = connection; break;
+            default: break;
+        }
+    }
+
+    for (uint32_t i = 0; i < parser->nodeCount; i++) {
+        Node *node = parser->nodes[i];
+        if (!node->prevZ && staging->zHead != node) ZList_PushTop(node, staging);
+        UpdateConnectorPositions(node);
+        SpatialGrid_Update(&staging->grid, node);
+    }
+}
+
+static void Parser_FreeStaging(TextParser *parser) {
+    Context *staging = parser->staging;
+    for (uint32_t i = 0; i < parser->nodeCount; i++) {
+        if (parser->nodes[i]->type == NODE_DEFAULT) free(parser->nodes[i]->data.defaultNode.text);
+    }
+    for (int s = 0; s < staging->sceneList.count; s++) {
+        SceneOutline_Free(&staging->sceneList.scenes[s]);
+    }
+    SpatialGrid_Destroy(&staging->grid);
+    EdgeStore_Destroy(&staging->edges);
+    NodePool_Destroy(staging->pool);
+}
+
+// Parses the whole file into a staging graph in one pass over the lines. The open project is
+// only replaced once that succeeded, a file with a syntax error leaves the editor untouched.
+bool ProjectText_Load(Context *context, const char *path, ProjectStats *stats) {
+    FileMap map;
+    if (!FileMap_Open(&map, path)) {
+        TraceLog(LOG_WARNING, "PROJECT: Could not map [%s]", path);
+        return false;
+    }
+
+    NodePool pool;
+    if (!NodePool_Init(&pool)) {
+        FileMap_Close(&map);
+        return false;
+    }
+    Context staging = { .pool = &pool };
+    TextParser parser = { .path = path, .staging = &staging };
+
+    const char *p = (const char *)map.data;
+    const char *fileEnd = p + map.size;
+    bool ok = true;
+    while (ok && p < fileEnd) {
+        const char *lineEnd = memchr(p, '\n', (size_t)(fileEnd - p));
+        const char *next = lineEnd ? lineEnd + 1 : fileEnd;
+        if (!lineEnd) lineEnd = fileEnd;
+        if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+
+        parser.line++;
+        parser.cursor = p;
+        parser.end = lineEnd;
+        ok = Parser_Line(&parser);
+        p = next;
+    }
+    if (ok && !parser.header) ok = Parser_Fail(&parser, "not a text project");
+    if (ok) Parser_Finish(&parser);
+
+    uint32_t bytes = (uint32_t)map.size;
+    FileMap_Close(&map);
+    free(parser.ids.slots);
+    free(parser.links);
+    free(parser.string.data);
+
+    if (!ok) {
+        Parser_FreeStaging(&parser);
+        free(parser.nodes);
+        return false;
+    }
+    if (parser.dropped) {
+        TraceLog(LOG_WARNING, "PROJECT: [%s] dropped %d references to nodes that are not in the file", path, parser.dropped);
+    }
+
+    // === Swap the staging graph in ===
+    Project_Clear(context);
+    NodePool_Destroy(context->pool);
+    *context->pool = pool;
+    EdgeStore_Destroy(&context->edges);
+    context->edges = staging.edges;
+    SpatialGrid_Destroy(&context->grid);
+    context->grid = staging.grid;
+    context->sceneList = staging.sceneList;
+    context->zHead = staging.zHead;
+    context->zTail = staging.zTail;
+    context->zTopKey = staging.zTopKey;
+    context->zBottomKey = staging.zBottomKey;
+    // the binary project file no longer matches, the next journal save has to rewrite it
+    context->pool->changesLost = true;
+
+    if (stats) {
+        *stats = (ProjectStats){
+            .nodes = parser.nodeCount,
+            .links = parser.linkCount,
+            .edges = (uint32_t)context->edges.count,
+            .scenes = (uint32_t)context->sceneList.count,
+            .bytes = bytes
+        };
+    }
+    free(parser.nodes);
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef PROJECTTEXT_H
+#define PROJECTTEXT_H
+
+#include "core.h"
+#include "project.h"
+
+// Text project file (.nprose.txt)
+// Canonical, line-oriented form of a project meant to live in version control. The same graph
+// always produces the same bytes: nodes are sorted by ID and everything that changes while
+// arranging the canvas (position, size, z-order, curve shapes) sits in sections of its own, so
+// moving or focusing a node touches a single line and content edits never conflict with layout.
+//
+//   nodeprose-text 1
+//
+//   [nodes]                        one block per node, sorted by ID, blocks separated by a blank line
+//   node <id> <type>
+//     text "<escaped UTF-8>"       dialogue nodes with text only
+//     payload <int>                when not 0
+//     link <connector|next|stack> <slot> <from id|-> <to id|->
+//
+//   [scenes]                       in scene list order
+//   scene "<name>" <x> <y> <w> <h>
+//     member <id>                  sorted by ID
+//
+//   [layout]                       sorted by ID
+//   <id> <x> <y> <w> <h> <expanded|collapsed>
+//
+//   [order]                        z-order, bottom to top
+//   <id>
+//
+//   [curves]                       sorted by end IDs, then by shape
+//   <from id> <to id> <x0> <y0> <x1> <y1> <x2> <y2> <x3> <y3> <ax0> <ay0> <ax1> <ay1>
+//
+// Floats are printed with the fewest digits that read back to the same bits. The parser skips
+// blank lines and '#' comments, accepts CRLF, and drops references to nodes that are not in the
+// file (a merge may leave some behind). The camera is editor state and is not stored.
+#define PROJECT_TEXT_MAGIC "nodeprose-text"
+#define PROJECT_TEXT_VERSION 1
+#define PROJECT_TEXT_FILE_PATH "project.nprose.txt"
+
+bool ProjectText_Save(Context *context, const char *path, ProjectStats *stats);
+bool ProjectText_Load(Context *context, const char *path, ProjectStats *stats);
+
+#endif
@@ -0,0 +1,616 @@
+#include <string.h>
+
+#include "narrative.h"
+
+#define NARRATIVE_NONE UINT32_MAX
+#define NARRATIVE_RNG_WORDS 5       // tag, PCG state low, high, numbers drawn low, high
+#define NARRATIVE_BAG_WORDS 4       // tag, targets left, numbers drawn at the round's start low, high; then the order
+#define NARRATIVE_STACK_WORDS 2     // tag, next strand
+
+// === Story ===
+
+static uint32_t Narrative_U32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Header checks only, nothing is copied or decoded
+bool Narrative_Open(Narrative *story, const void *data, size_t size) {
+    const unsigned char *p = data;
+    const uint32_t one = 1;
+    memset(story, 0, sizeof(*story));
+    if (!p || size < NARRATIVE_HEADER_SIZE || ((uintptr_t)p & 3) != 0) return false;
+    if (*(const unsigned char *)&one != 1) return false;    // code is read as host words
+    if (memcmp(p, NARRATIVE_MAGIC, 4) != 0 || Narrative_U32(p + 4) != NARRATIVE_VERSION) return false;
+
+    story->checksum = Narrative_U32(p + 8);
+    story->entry = Narrative_U32(p + 12);
+    story->codeWords = Narrative_U32(p + 16);
+    story->rngSlots = Narrative_U32(p + 20);
+    story->bagWords = Narrative_U32(p + 24);
+    story->stackSlots = Narrative_U32(p + 28);
+    story->stringBytes = Narrative_U32(p + 32);
+
+    uint64_t needed = NARRATIVE_HEADER_SIZE + 4 * ((uint64_t)story->codeWords + story->rngSlots) + story->stringBytes;
+    if (needed > size || story->codeWords == 0 || story->entry >= story->codeWords) return false;
+
+    story->code = (const uint32_t *)(p + NARRATIVE_HEADER_SIZE);
+    story->seeds = story->code + story->codeWords;
+    story->strings = (const char *)(story->seeds + story->rngSlots);
+    if (story->stringBytes && story->strings[story->stringBytes - 1] != '\0') return false;
+    return true;
+}
+
+// Checksum of everything after the header, linear in the size of the story
+bool Narrative_Verify(const Narrative *story) {
+    const unsigned char *p = (const unsigned char *)story->code;
+    if (!p) return false;
+    size_t size = 4 * ((size_t)story->codeWords + story->rngSlots) + story->stringBytes;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ p[i]) * 16777619u;
+    return hash == story->checksum;
+}
+
+// Bytes of memory a playthrough needs, 4-byte aligned
+size_t Narrative_MemorySize(const Narrative *story) {
+    return ((size_t)NARRATIVE_RNG_WORDS * story->rngSlots + story->bagWords +
+            (size_t)NARRATIVE_STACK_WORDS * story->stackSlots) * sizeof(uint32_t);
+}
+
+// === Random numbers ===
+
+#define NARRATIVE_PCG_MULTIPLIER 6364136223846793005ull
+
+void NarrativeRandom_Seed(NarrativeRandom *random, uint64_t seed, uint64_t stream) {
+    random->state = 0;
+    random->increment = (stream << 1) | 1u;
+    NarrativeRandom_Next(random);
+    random->state += seed;
+    NarrativeRandom_Next(random);
+}
+
+uint32_t NarrativeRandom_Next(NarrativeRandom *random) {
+    uint64_t old = random->state;
+    random->state = old * NARRATIVE_PCG_MULTIPLIER + random->increment;
+    uint32_t shifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rotation = (uint32_t)(old >> 59);
+    return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+}
+
+// Uniform in [0, bound), without the bias of a plain modulo (Lemire); *drawn counts the numbers used
+static uint32_t Narrative_Below(NarrativeRandom *random, uint32_t bound, uint64_t *drawn) {
+    uint64_t product = (uint64_t)NarrativeRandom_Next(random) * bound;
+    uint32_t low = (uint32_t)product;
+    (*drawn)++;
+    if (low < bound) {
+        uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = (uint64_t)NarrativeRandom_Next(random) * bound;
+            low = (uint32_t)product;
+            (*drawn)++;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+uint32_t NarrativeRandom_Below(NarrativeRandom *random, uint32_t bound) {
+    uint64_t drawn = 0;
+    return Narrative_Below(random, bound, &drawn);
+}
+
+// Skips delta numbers in O(log delta) (Brown, "Random number generation with arbitrary strides")
+void NarrativeRandom_Advance(NarrativeRandom *random, uint64_t delta) {
+    uint64_t multiplier = NARRATIVE_PCG_MULTIPLIER, increment = random->increment;
+    uint64_t totalMultiplier = 1, totalIncrement = 0;
+    while (delta) {
+        if (delta & 1) {
+            totalMultiplier *= multiplier;
+            totalIncrement = totalIncrement * multiplier + increment;
+        }
+        increment = (multiplier + 1) * increment;
+        multiplier *= multiplier;
+        delta >>= 1;
+    }
+    random->state = totalMultiplier * random->state + totalIncrement;
+}
+
+// === Playthrough ===
+
+static uint32_t Narrative_Mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// The node's own stream, RandomNode.seed picks it, the slot keeps equal seeds apart
+static uint64_t Narrative_Stream(const Narrative *story, uint32_t slot) {
+    return ((uint64_t)slot << 32) | story->seeds[slot];
+}
+
+static void Narrative_FreshRandom(const NarrativeState *state, uint32_t slot, NarrativeRandom *random) {
+    uint64_t seed = ((uint64_t)state->seed << 32) | Narrative_Mix(state->seed ^ Narrative_Mix(slot + 1));
+    NarrativeRandom_Seed(random, seed, Narrative_Stream(state->story, slot));
+}
+
+static void Narrative_StoreRandom(uint32_t *words, const NarrativeRandom *random, uint64_t drawn) {
+    words[1] = (uint32_t)random->state;
+    words[2] = (uint32_t)(random->state >> 32);
+    words[3] = (uint32_t)drawn;
+    words[4] = (uint32_t)(drawn >> 32);
+}
+
+static uint64_t Narrative_Drawn(const uint32_t *words) {
+    return (uint64_t)words[3] | ((uint64_t)words[4] << 32);
+}
+
+// Random number of an rng slot, seeded on first use in this playthrough
+static uint32_t Narrative_Draw(NarrativeState *state, uint32_t slot, uint32_t bound) {
+    uint32_t *words = state->rng + NARRATIVE_RNG_WORDS * (size_t)slot;
+    NarrativeRandom random;
+    uint64_t drawn = 0;
+    if (words[0] != state->generation) {
+        Narrative_FreshRandom(state, slot, &random);
+        words[0] = state->generation;
+    } else {
+        random.state = (uint64_t)words[1] | ((uint64_t)words[2] << 32);
+        random.increment = (Narrative_Stream(state->story, slot) << 1) | 1u;
+        drawn = Narrative_Drawn(words);
+    }
+    uint32_t value = Narrative_Below(&random, bound, &drawn);
+    Narrative_StoreRandom(words, &random, drawn);
+    return value;
+}
+
+// Clears every tag once, later playthroughs on the same memory only bump the generation
+bool Narrative_Start(NarrativeState *state, const Narrative *story, void *memory, size_t memorySize, uint32_t seed) {
+    memset(state, 0, sizeof(*state));
+    state->story = story;
+    state->status = NARRATIVE_ERROR;
+    size_t size = Narrative_MemorySize(story);
+    if (memorySize < size || ((uintptr_t)memory & 3) != 0) return false;
+
+    state->rng = memory;
+    state->bags = state->rng + NARRATIVE_RNG_WORDS * (size_t)story->rngSlots;
+    state->stacks = state->bags + story->bagWords;
+    if (size) memset(memory, 0, size);
+    state->generation = 0;
+    Narrative_Restart(state, seed);
+    return true;
+}
+
+// A new playthrough on the memory of the last one, O(1)
+void Narrative_Restart(NarrativeState *state, uint32_t seed) {
+    if (++state->generation == 0) {
+        size_t size = Narrative_MemorySize(state->story);
+        if (size) memset(state->rng, 0, size);
+        state->generation = 1;
+    }
+    state->seed = seed;
+    state->pc = state->story->entry;
+    state->depth = 0;
+    state->steps = 0;
+    state->status = NARRATIVE_RUNNING;
+}
+
+// Target index of a bag pick: swap-remove from the targets left, a new round once all were used.
+// Every round starts from the same order, so the round's draws alone rebuild it (Narrative_Load).
+static uint32_t Narrative_BagPick(NarrativeState *state, uint32_t *bag, uint32_t count, uint32_t slot) {
+    uint32_t *order = bag + NARRATIVE_BAG_WORDS;
+    if (bag[0] != state->generation || bag[1] == 0 || bag[1] > count) {
+        const uint32_t *words = state->rng + NARRATIVE_RNG_WORDS * (size_t)slot;
+        uint64_t drawn = words[0] == state->generation ? Narrative_Drawn(words) : 0;
+        bag[0] = state->generation;
+        bag[1] = count;
+        bag[2] = (uint32_t)drawn;
+        bag[3] = (uint32_t)(drawn >> 32);
+        for (uint32_t i = 0; i < count; i++) order[i] = i;
+    }
+    uint32_t left = bag[1];
+    uint32_t at = Narrative_Draw(state, slot, left);
+    uint32_t pick = order[at];
+    order[at] = order[left - 1];
+    order[left - 1] = pick;
+    bag[1] = left - 1;
+    return pick;
+}
+
+// Next strand of a stack slot, NARRATIVE_NONE until the node is reached
+static uint32_t* Narrative_Cursor(NarrativeState *state, uint32_t slot) {
+    uint32_t *words = state->stacks + NARRATIVE_STACK_WORDS * (size_t)slot;
+    if (words[0] != state->generation) {
+        words[0] = state->generation;
+        words[1] = NARRATIVE_NONE;
+    }
+    return &words[1];
+}
+
+// Runs until the story needs an answer, ends, or maxSteps instructions were executed
+NarrativeStatus Narrative_Run(NarrativeState *state, uint32_t maxSteps) {
+    if (state->status != NARRATIVE_RUNNING) return state->status;
+    const Narrative *story = state->story;
+    const uint32_t *code = story->code;
+    uint64_t size = story->codeWords;
+    uint32_t pc = state->pc;
+    uint32_t steps = 0;
+    NarrativeStatus status = NARRATIVE_RUNNING;
+
+    while (steps < maxSteps) {
+        if (pc >= size) {
+            status = NARRATIVE_ERROR;
+            break;
+        }
+        uint32_t word = code[pc];
+        uint32_t a = word >> NARRATIVE_OP_BITS;
+        uint64_t left = size - pc;  // words from pc to the end, operands must fit
+        steps++;
+
+        switch ((NarrativeOp)(word & ((1u << NARRATIVE_OP_BITS) - 1))) {
+            case NARRATIVE_OP_END:
+                if (state->depth == 0) {
+                    status = NARRATIVE_DONE;
+                    goto stop;
+                }
+                pc = state->returns[--state->depth];   // the stack node picks its next strand
+                break;
+            case NARRATIVE_OP_LINE:
+                status = left >= 2 && code[pc + 1] < story->stringBytes ? NARRATIVE_LINE : NARRATIVE_ERROR;
+                goto stop;
+            case NARRATIVE_OP_JUMP:
+                if (left < 2) {
+                    status = NARRATIVE_ERROR;
+                    goto stop;
+                }
+                pc = code[pc + 1];
+                break;
+            case NARRATIVE_OP_CHOICE:
+                status = NARRATIVE_CHOICE;
+                if (a == 0 || left < 1 + 2 * (uint64_t)a) status = NARRATIVE_ERROR;
+                for (uint32_t i = 0; i < a && status == NARRATIVE_CHOICE; i++) {
+                    if (code[pc + 1 + 2 * i] >= story->stringBytes) status = NARRATIVE_ERROR;
+                }
+                goto stop;
+            case NARRATIVE_OP_CHECK:
+                status = left >= 4 && a <= NARRATIVE_CHECK_CONDITION ? NARRATIVE_CHECK : NARRATIVE_ERROR;
+                goto stop;
+            case NARRATIVE_OP_RANDOM: {
+                uint32_t slot = left >= 2 ? code[pc + 1] : NARRATIVE_NONE;
+                if (a == 0 || left < 2 + (uint64_t)a || slot >= story->rngSlots) {
+                    status = NARRATIVE_ERROR;
+                    goto stop;
+                }
+                pc = code[pc + 2 + Narrative_Draw(state, slot, a)];
+                break;
+            }
+            case NARRATIVE_OP_BAG: {
+                uint32_t slot = left >= 3 ? code[pc + 1] : NARRATIVE_NONE;
+                uint32_t first = left >= 3 ? code[pc + 2] : NARRATIVE_NONE;
+                if (a == 0 || left < 3 + (uint64_t)a || slot >= story->rngSlots ||
+                    first > story->bagWords || NARRATIVE_BAG_WORDS + (uint64_t)a > story->bagWords - first) {
+                    status = NARRATIVE_ERROR;
+                    goto stop;
+                }
+                uint32_t pick = Narrative_BagPick(state, &state->bags[first], a, slot);
+                if (pick >= a) {    // only a damaged save gets here
+                    status = NARRATIVE_ERROR;
+                    goto stop;
+                }
+                pc = code[pc + 3 + pick];
+                break;
+            }
+            case NARRATIVE_OP_STACK: {
+                uint32_t slot = left >= 4 ? code[pc + 1] : NARRATIVE_NONE;
+                if (left < 4 + (uint64_t)a || slot >= story->stackSlots) {
+                    status = NARRATIVE_ERROR;
+                    goto stop;
+                }
+                uint32_t *cursor = Narrative_Cursor(state, slot);
+                if (*cursor == NARRATIVE_NONE) *cursor = code[pc + 2];
+                if (*cursor < a) {
+                    if (state->depth == NARRATIVE_MAX_DEPTH) {
+                        status = NARRATIVE_ERROR;
+                        goto stop;
+                    }
+                    state->returns[state->depth++] = pc;
+                    pc = code[pc + 4 + (*cursor)++];
+                } else {
+                    *cursor = NARRATIVE_NONE;  // played out, a later visit starts over
+                    pc = code[pc + 3];
+                }
+                break;
+            }
+            default:
+                status = NARRATIVE_ERROR;
+                goto stop;
+        }
+    }
+stop:
+    state->pc = pc;
+    state->status = status;
+    state->steps += steps;
+    return status;
+}
+
+const char* Narrative_Line(const NarrativeState *state) {
+    if (state->status != NARRATIVE_LINE) return NULL;
+    return state->story->strings + state->story->code[state->pc + 1];
+}
+
+int Narrative_OptionCount(const NarrativeState *state) {
+    if (state->status == NARRATIVE_CHECK) return 2;
+    if (state->status != NARRATIVE_CHOICE) return 0;
+    return (int)(state->story->code[state->pc] >> NARRATIVE_OP_BITS);
+}
+
+const char* Narrative_Option(const NarrativeState *state, int option) {
+    if (option < 0 || option >= Narrative_OptionCount(state)) return NULL;
+    if (state->status == NARRATIVE_CHECK) return option == 0 ? "Pass" : "Fail";
+    return state->story->strings + state->story->code[state->pc + 1 + 2 * (uint32_t)option];
+}
+
+NarrativeCheckKind Narrative_Check(const NarrativeState *state, int32_t *id) {
+    bool check = state->status == NARRATIVE_CHECK;
+    const uint32_t *code = state->story->code + state->pc;
+    if (id) *id = check ? (int32_t)code[1] : 0;
+    return check ? (NarrativeCheckKind)(code[0] >> NARRATIVE_OP_BITS) : NARRATIVE_CHECK_SKILL;
+}
+
+void Narrative_Continue(NarrativeState *state) {
+    if (state->status != NARRATIVE_LINE) return;
+    state->pc += 2;
+    state->status = NARRATIVE_RUNNING;
+}
+
+void Narrative_Choose(NarrativeState *state, int option) {
+    if (option < 0 || option >= Narrative_OptionCount(state)) return;
+    const uint32_t *code = state->story->code + state->pc;
+    state->pc = state->status == NARRATIVE_CHECK ? code[2 + (uint32_t)option] : code[2 + 2 * (uint32_t)option];
+    state->status = NARRATIVE_RUNNING;
+}
+
+// === Save games ===
+
+typedef struct {
+    unsigned char *out;
+    size_t size;
+    size_t capacity;
+} SaveWriter;
+
+static void Save_Varint(SaveWriter *writer, uint64_t value) {
+    do {
+        unsigned char byte = (unsigned char)(value & 0x7F);
+        value >>= 7;
+        if (value) byte |= 0x80;
+        if (writer->size < writer->capacity) writer->out[writer->size] = byte;
+        writer->size++;
+    } while (value);
+}
+
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    size_t at;
+    bool failed;
+} SaveReader;
+
+static uint64_t Save_ReadVarint64(SaveReader *reader) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 70; shift += 7) {
+        if (reader->at >= reader->size) break;
+        unsigned char byte = reader->data[reader->at++];
+        if (shift == 63 && byte > 1) break;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    reader->failed = true;
+    return 0;
+}
+
+static uint32_t Save_ReadVarint(SaveReader *reader) {
+    uint64_t value = Save_ReadVarint64(reader);
+    if (value <= UINT32_MAX) return (uint32_t)value;
+    reader->failed = true;
+    return 0;
+}
+
+// Slot or instruction written as the gap after the last one, below limit
+static uint32_t Save_ReadIndex(SaveReader *reader, uint64_t *next, uint32_t limit) {
+    uint64_t index = *next + Save_ReadVarint(reader);
+    if (index >= limit) {
+        reader->failed = true;
+        return 0;
+    }
+    *next = index + 1;
+    return (uint32_t)index;
+}
+
+// Largest save a playthrough of story can produce
+size_t Narrative_SaveBound(const Narrative *story) {
+    // 5 bytes per 32-bit varint, 10 per 64-bit one; a bag takes at least 5 words
+    return 4 + 5 * (9 + (size_t)NARRATIVE_MAX_DEPTH) + 15 * (size_t)story->rngSlots +
+           4 * (size_t)story->bagWords + 10 * (size_t)story->stackSlots;
+}
+
+// Words of the instruction at pc, 0 when it is unknown or runs past the end
+static uint64_t Narrative_Length(const Narrative *story, uint32_t pc) {
+    uint32_t word = story->code[pc];
+    uint64_t a = word >> NARRATIVE_OP_BITS, length;
+    switch ((NarrativeOp)(word & ((1u << NARRATIVE_OP_BITS) - 1))) {
+        case NARRATIVE_OP_END: length = 1; break;
+        case NARRATIVE_OP_LINE:
+        case NARRATIVE_OP_JUMP: length = 2; break;
+        case NARRATIVE_OP_CHOICE: length = 1 + 2 * a; break;
+        case NARRATIVE_OP_RANDOM: length = 2 + a; break;
+        case NARRATIVE_OP_BAG: length = 3 + a; break;
+        case NARRATIVE_OP_STACK: length = 4 + a; break;
+        case NARRATIVE_OP_CHECK: length = 4; break;
+        default: return 0;
+    }
+    return length <= story->codeWords - pc ? length : 0;
+}
+
+// Bag of the BAG instruction at pc, NULL when pc holds none or its operands are out of range
+static uint32_t* Narrative_Bag(const NarrativeState *state, uint32_t pc, uint32_t *count, uint32_t *slot) {
+    const Narrative *story = state->story;
+    if (pc >= story->codeWords || Narrative_Length(story, pc) == 0) return NULL;
+    const uint32_t *code = story->code + pc;
+    if ((code[0] & ((1u << NARRATIVE_OP_BITS) - 1)) != NARRATIVE_OP_BAG) return NULL;
+    *count = code[0] >> NARRATIVE_OP_BITS;
+    *slot = code[1];
+    uint32_t first = code[2];
+    if (*count == 0 || *slot >= story->rngSlots) return NULL;
+    if (first > story->bagWords || NARRATIVE_BAG_WORDS + (uint64_t)*count > story->bagWords - first) return NULL;
+    return state->bags + first;
+}
+
+// Bytes written, 0 when the save does not fit into capacity
+size_t Narrative_Save(const NarrativeState *state, unsigned char *out, size_t capacity) {
+    const Narrative *story = state->story;
+    if (capacity < 4) return 0;
+    memcpy(out, NARRATIVE_SAVE_MAGIC, 4);
+    SaveWriter writer = { out, 4, capacity };
+
+    Save_Varint(&writer, NARRATIVE_SAVE_VERSION);
+    Save_Varint(&writer, story->checksum);
+    Save_Varint(&writer, state->seed);
+    Save_Varint(&writer, state->pc);
+    Save_Varint(&writer, (uint32_t)state->status);
+    Save_Varint(&writer, state->depth);
+    for (uint32_t i = 0; i < state->depth; i++) Save_Varint(&writer, state->returns[i]);
+
+    // only the live entries, everything else starts fresh on load; a generator is its draw count.
+    // Slots and instructions ascend, each is written as the gap to the one after the last.
+    uint32_t count = 0, next = 0;
+    for (uint32_t i = 0; i < story->rngSlots; i++) count += state->rng[NARRATIVE_RNG_WORDS * i] == state->generation;
+    Save_Varint(&writer, count);
+    for (uint32_t i = 0; i < story->rngSlots; i++) {
+        const uint32_t *words = state->rng + NARRATIVE_RNG_WORDS * i;
+        if (words[0] != state->generation) continue;
+        Save_Varint(&writer, i - next);
+        Save_Varint(&writer, Narrative_Drawn(words));
+        next = i + 1;
+    }
+
+    // bags have no directory of their own, their BAG instructions are it
+    uint32_t targets, slot;
+    uint64_t length;
+    count = 0;
+    for (uint32_t pc = 0; pc < story->codeWords && (length = Narrative_Length(story, pc)); pc += (uint32_t)length) {
+        const uint32_t *bag = Narrative_Bag(state, pc, &targets, &slot);
+        count += bag && bag[0] == state->generation;
+    }
+    Save_Varint(&writer, count);
+    next = 0;
+    for (uint32_t pc = 0; pc < story->codeWords && (length = Narrative_Length(story, pc)); pc += (uint32_t)length) {
+        const uint32_t *bag = Narrative_Bag(state, pc, &targets, &slot);
+        if (!bag || bag[0] != state->generation) continue;
+        uint64_t start = (uint64_t)bag[2] | ((uint64_t)bag[3] << 32);
+        Save_Varint(&writer, pc - next);
+        Save_Varint(&writer, bag[1]);
+        Save_Varint(&writer, Narrative_Drawn(state->rng + NARRATIVE_RNG_WORDS * (size_t)slot) - start);
+        next = pc + 1;
+    }
+
+    count = 0;
+    for (uint32_t i = 0; i < story->stackSlots; i++) {
+        const uint32_t *words = state->stacks + NARRATIVE_STACK_WORDS * i;
+        count += words[0] == state->generation && words[1] != NARRATIVE_NONE;
+    }
+    Save_Varint(&writer, count);
+    next = 0;
+    for (uint32_t i = 0; i < story->stackSlots; i++) {
+        const uint32_t *words = state->stacks + NARRATIVE_STACK_WORDS * i;
+        if (words[0] != state->generation || words[1] == NARRATIVE_NONE) continue;
+        Save_Varint(&writer, i - next);
+        Save_Varint(&writer, words[1]);
+        next = i + 1;
+    }
+    return writer.size <= capacity ? writer.size : 0;
+}
+
+// Restores a save of the same story build, memory as for Narrative_Start
+bool Narrative_Load(NarrativeState *state, const Narrative *story, void *memory, size_t memorySize,
+                    const unsigned char *data, size_t size) {
+    if (!data || size < 4 || memcmp(data, NARRATIVE_SAVE_MAGIC, 4) != 0) return false;
+    SaveReader reader = { data, size, 4, false };
+    if (Save_ReadVarint(&reader) != NARRATIVE_SAVE_VERSION) return false;
+    if (Save_ReadVarint(&reader) != story->checksum) return false;
+    uint32_t seed = Save_ReadVarint(&reader);
+    if (reader.failed || !Narrative_Start(state, story, memory, memorySize, seed)) return false;
+
+    uint32_t pc = Save_ReadVarint(&reader);
+    uint32_t status = Save_ReadVarint(&reader);
+    uint32_t depth = Save_ReadVarint(&reader);
+    if (depth > NARRATIVE_MAX_DEPTH || status > NARRATIVE_DONE) reader.failed = true;
+    for (uint32_t i = 0; i < depth && !reader.failed; i++) state->returns[i] = Save_ReadVarint(&reader);
+    state->depth = depth;
+
+    // a generator is its seed advanced by the numbers it drew, O(log n)
+    uint32_t count = Save_ReadVarint(&reader);
+    uint64_t next = 0;
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+        uint32_t slot = Save_ReadIndex(&reader, &next, story->rngSlots);
+        uint64_t drawn = Save_ReadVarint64(&reader);
+        if (reader.failed) break;
+        NarrativeRandom random;
+        Narrative_FreshRandom(state, slot, &random);
+        NarrativeRandom_Advance(&random, drawn);
+        uint32_t *words = state->rng + NARRATIVE_RNG_WORDS * (size_t)slot;
+        words[0] = state->generation;
+        Narrative_StoreRandom(words, &random, drawn);
+    }
+
+    // a bag replays its round from the draw count at the round's start, at most n picks;
+    // the bag's own rng slot has to end where the save left it
+    count = reader.failed ? 0 : Save_ReadVarint(&reader);
+    next = 0;
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+        uint32_t bagPc = Save_ReadIndex(&reader, &next, story->codeWords);
+        uint32_t left = Save_ReadVarint(&reader);
+        uint64_t round = Save_ReadVarint64(&reader);    // numbers drawn in this round
+        uint32_t targets, slot;
+        uint32_t *bag = reader.failed ? NULL : Narrative_Bag(state, bagPc, &targets, &slot);
+        uint32_t *words = bag ? state->rng + NARRATIVE_RNG_WORDS * (size_t)slot : NULL;
+        if (!bag || left >= targets || words[0] != state->generation || round > Narrative_Drawn(words)) {
+            reader.failed = true;
+            break;
+        }
+        uint64_t drawn = Narrative_Drawn(words), start = drawn - round;
+        NarrativeRandom random;
+        Narrative_FreshRandom(state, slot, &random);
+        NarrativeRandom_Advance(&random, start);
+        Narrative_StoreRandom(words, &random, start);
+        bag[0] = state->generation;
+        bag[1] = 0;     // the next pick starts the round
+        for (uint32_t pick = left; pick < targets; pick++) Narrative_BagPick(state, bag, targets, slot);
+        if (Narrative_Drawn(words) != drawn) reader.failed = true;
+    }
+    count = reader.failed ? 0 : Save_ReadVarint(&reader);
+    next = 0;
+    for (uint32_t i = 0; i < count && !reader.failed; i++) {
+        uint32_t slot = Save_ReadIndex(&reader, &next, story->stackSlots);
+        uint32_t strand = Save_ReadVarint(&reader);
+        if (reader.failed) break;
+        uint32_t *words = state->stacks + NARRATIVE_STACK_WORDS * (size_t)slot;
+        words[0] = state->generation;
+        words[1] = strand;
+    }
+    if (reader.failed || reader.at != size) {
+        state->status = NARRATIVE_ERROR;
+        return false;
+    }
+
+    // a waiting instruction stops again without changing anything, running it checks it
+    state->pc = pc;
+    state->status = status == NARRATIVE_DONE ? NARRATIVE_DONE : NARRATIVE_RUNNING;
+    if (status != NARRATIVE_RUNNING && status != NARRATIVE_DONE) {
+        Narrative_Run(state, 1);
+        if (state->status != (NarrativeStatus)status) {
+            state->status = NARRATIVE_ERROR;
+            return false;
+        }
+        state->steps = 0;
+    }
+    return true;
+}
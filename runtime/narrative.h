@@ -0,0 +1,148 @@
+#ifndef NARRATIVE_H
+#define NARRATIVE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Narrative runtime
+// Plays a story built by the editor (Build, see story.h) inside a game. Plain C99 without raylib
+// or editor code, and it never allocates: the story is read in place from the buffer the game
+// loaded or mapped, and the little mutable state there is lives in memory the game hands in.
+// Opening checks the header only, every jump and operand is bounds checked as it executes;
+// Narrative_Verify additionally checksums the blob, once per load where that is affordable.
+//
+// Story blob, little-endian, read in place so it has to be 4-byte aligned on a little-endian host:
+//   header   magic "NPST", u32 version, u32 checksum (FNV-1a of everything after the header),
+//            u32 entry, u32 code words, u32 rng slots, u32 bag words, u32 stack slots,
+//            u32 string bytes, u32 0
+//   code     u32 words, see below
+//   seeds    u32 per rng slot, RandomNode / RandomBagNode.seed, selects the node's PCG stream
+//   strings  null-terminated UTF-8
+// Bag words are 4 + n per bag of n targets.
+//
+// Instruction word: op in the low 8 bits, a count or kind in the upper 24, followed by operand words.
+// Targets are word addresses, texts are byte offsets into the strings. Word 0 holds an END.
+//   END                        strand finished: return into the stack node that started it, or stop
+//   LINE                       text; show a line of dialogue and wait for Continue
+//   JUMP                       target
+//   CHOICE    a = n            n pairs (text of the option, target), wait for the pick
+//   RANDOM    a = n            rng slot, n targets
+//   BAG       a = n            rng slot, first bag word, n targets; each target once until all are used
+//   STACK     a = n            stack slot, first strand, continuation, n strand targets
+//   CHECK     a = kind         id, pass target, fail target; wait for the result
+//
+// Playthrough memory: rng slots (tag, PCG state, numbers drawn), bags (tag, targets left, numbers
+// its slot had drawn when the round started, target order) and stack slots (tag, next strand).
+// Only entries tagged with the playthrough's generation are live, anything else reads as a fresh
+// start, so Narrative_Restart is O(1) however large the story. A bag draws with swap-remove from
+// the front of its order, O(1), and every round starts from the same order, O(n) once per n picks.
+//
+// Save game: magic "NPSV", then unsigned LEB128 varints: version, story checksum, seed, pc, status,
+// depth and the return stack, then the live entries, each list led by its length: rng slots
+// (slot, numbers drawn), bags (BAG instruction, left, numbers its slot drew this round) and stack
+// slots (slot, strand), slots and instructions as the gap after the previous entry's. Loading
+// advances each generator from its seed in O(log n) and replays the picks of each bag's current
+// round from its own rng slot, so no generator state or bag order is stored.
+// A few bytes for most saves.
+//
+// In a game:
+//   Narrative_Open(&story, blob, size);                 blob stays loaded while the story plays
+//   Narrative_Start(&state, &story, memory, Narrative_MemorySize(&story), seed);
+//   once a frame: Narrative_Run(&state, budget), show Narrative_Line or the options,
+//   then Narrative_Continue / Narrative_Choose with the player's answer.
+#define NARRATIVE_MAGIC "NPST"
+#define NARRATIVE_VERSION 3
+#define NARRATIVE_HEADER_SIZE 40
+#define NARRATIVE_SAVE_MAGIC "NPSV"
+#define NARRATIVE_SAVE_VERSION 3
+#define NARRATIVE_OP_BITS 8
+#define NARRATIVE_MAX_DEPTH 64      // nested stack strands
+
+typedef enum {
+    NARRATIVE_OP_END,
+    NARRATIVE_OP_LINE,
+    NARRATIVE_OP_JUMP,
+    NARRATIVE_OP_CHOICE,
+    NARRATIVE_OP_RANDOM,
+    NARRATIVE_OP_BAG,
+    NARRATIVE_OP_STACK,
+    NARRATIVE_OP_CHECK,
+    NARRATIVE_OP_COUNT
+} NarrativeOp;
+
+typedef enum {
+    NARRATIVE_CHECK_SKILL,          // SkillGateNode.requiredSkillId
+    NARRATIVE_CHECK_CONDITION       // ConditionalNode.conditionId
+} NarrativeCheckKind;
+
+typedef enum {
+    NARRATIVE_RUNNING,
+    NARRATIVE_LINE,                 // a line is shown, Narrative_Continue
+    NARRATIVE_CHOICE,               // options are offered, Narrative_Choose
+    NARRATIVE_CHECK,                // the game decides, Narrative_Choose 0 = pass, 1 = fail
+    NARRATIVE_DONE,
+    NARRATIVE_ERROR                 // the story is broken or strands nest deeper than NARRATIVE_MAX_DEPTH
+} NarrativeStatus;
+
+// PCG32 (XSH RR): 64-bit state, one of 2^63 streams, jumps ahead in O(log n) so parallel
+// simulations can split one stream instead of hoping that hashed seeds do not overlap
+typedef struct {
+    uint64_t state;
+    uint64_t increment;             // odd, selects the stream
+} NarrativeRandom;
+
+void NarrativeRandom_Seed(NarrativeRandom *random, uint64_t seed, uint64_t stream);
+uint32_t NarrativeRandom_Next(NarrativeRandom *random);
+uint32_t NarrativeRandom_Below(NarrativeRandom *random, uint32_t bound);
+void NarrativeRandom_Advance(NarrativeRandom *random, uint64_t delta);
+
+// An opened story, pointers into the game's buffer
+typedef struct {
+    const uint32_t *code;
+    const uint32_t *seeds;
+    const char *strings;
+    uint32_t codeWords;
+    uint32_t rngSlots;
+    uint32_t bagWords;
+    uint32_t stackSlots;
+    uint32_t stringBytes;
+    uint32_t entry;
+    uint32_t checksum;
+} Narrative;
+
+// One playthrough. rng, bags and stacks point into the memory given to Narrative_Start.
+typedef struct {
+    const Narrative *story;
+    NarrativeStatus status;
+    uint32_t seed;
+    uint32_t generation;            // tag of the live memory entries
+    uint32_t pc;                    // next instruction, or the one waiting for an answer
+    uint32_t depth;
+    uint32_t returns[NARRATIVE_MAX_DEPTH];
+    uint32_t *rng;                  // 5 words per rng slot
+    uint32_t *bags;
+    uint32_t *stacks;               // 2 words per stack slot
+    uint64_t steps;                 // instructions executed
+} NarrativeState;
+
+bool Narrative_Open(Narrative *story, const void *data, size_t size);
+bool Narrative_Verify(const Narrative *story);
+size_t Narrative_MemorySize(const Narrative *story);
+bool Narrative_Start(NarrativeState *state, const Narrative *story, void *memory, size_t memorySize, uint32_t seed);
+void Narrative_Restart(NarrativeState *state, uint32_t seed);
+NarrativeStatus Narrative_Run(NarrativeState *state, uint32_t maxSteps);
+
+const char* Narrative_Line(const NarrativeState *state);
+int Narrative_OptionCount(const NarrativeState *state);
+const char* Narrative_Option(const NarrativeState *state, int option);
+NarrativeCheckKind Narrative_Check(const NarrativeState *state, int32_t *id);
+void Narrative_Continue(NarrativeState *state);
+void Narrative_Choose(NarrativeState *state, int option);
+
+size_t Narrative_SaveBound(const Narrative *story);
+size_t Narrative_Save(const NarrativeState *state, unsigned char *out, size_t capacity);
+bool Narrative_Load(NarrativeState *state, const Narrative *story, void *memory, size_t memorySize,
+                    const unsigned char *data, size_t size);
+
+#endif
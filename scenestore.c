@@ -0,0 +1,1117 @@
+#include "raylib.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "filemap.h"
+#include "scenestore.h"
+
+typedef struct {
+    uint32_t id;
+    uint32_t nodes;
+    uint32_t bytes;             // encoded size, what a loaded chunk counts against the budget
+    uint64_t hash;              // of the chunk file on disk, 0 until it is written
+    unsigned char *pending;     // unloaded with unsaved edits, written by the next save
+    size_t pendingSize;
+    bool broken;                // could not be read, left alone until the store is opened again
+} StoreChunk;
+
+// Connection value whose owner and ends are not all in the same chunk
+typedef struct {
+    uint32_t ownerKey;
+    uint32_t ownerChunk;
+    uint16_t kind;
+    uint16_t slot;
+    uint32_t fromKey;
+    uint32_t fromChunk;
+    uint32_t toKey;
+    uint32_t toChunk;
+    NodeHandle fromHandle;      // field values when captured, not stored: an end that holds
+    NodeHandle toHandle;        // anything else since then was rewired by the author
+} StoreLink;
+
+// Permanent curve with an end in an unloaded chunk
+typedef struct {
+    uint32_t fromKey;
+    uint32_t fromChunk;
+    uint32_t toKey;
+    uint32_t toChunk;
+    Vector2 points[4];
+    Vector2 anchors[2];         // BezierCurve.relativeposition
+} StoreCurve;
+
+struct SceneStore {
+    char dir[260];
+    uint32_t nextChunkId;
+    unsigned int frame;         // bumped by every SceneStore_Update, orders scenes for eviction
+    StoreChunk *chunks;         // one per chunk the manifest knows, the loose chunk included
+    int chunkCount;
+    int chunkCapacity;
+    StoreLink *links;
+    int linkCount;
+    int linkCapacity;
+    StoreCurve *curves;
+    int curveCount;
+    int curveCapacity;
+    uint32_t residentBytes;     // bytes of the loaded chunks, kept by load, unload and save
+};
+
+static const SceneList noScenes;    // chunks never carry scenes, the manifest does
+
+// saveKey -> loaded node, open addressing
+typedef struct {
+    uint32_t key;
+    Node *node;
+} KeySlot;
+
+typedef struct {
+    KeySlot *slots;
+    uint32_t capacity;  // power of two
+    uint32_t count;
+} KeyMap;
+
+static KeySlot* KeyMap_Find(const KeyMap *map, uint32_t key) {
+    uint32_t mask = map->capacity - 1;
+    for (uint32_t i = (key * 2654435761u) & mask; ; i = (i + 1) & mask) {
+        if (map->slots[i].key == key || map->slots[i].key == 0) return &map->slots[i];
+    }
+}
+
+static Node* KeyMap_Get(const KeyMap *map, uint32_t key) {
+    if (key == 0 || map->capacity == 0) return NULL;
+    return KeyMap_Find(map, key)->node;
+}
+
+// Where every loaded node lives, rebuilt by each store operation
+typedef struct {
+    int *home;              // pool slot -> index + 1 of the first loaded scene holding it, 0 for loose
+    KeyMap keys;
+    uint32_t *unloaded;     // chunk ids of the unloaded scenes, sorted
+    int unloadedCount;
+} StoreIndex;
+
+static int CompareU32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void StoreIndex_Free(StoreIndex *index) {
+    free(index->home);
+    free(index->keys.slots);
+    free(index->unloaded);
+    *index = (StoreIndex){0};
+}
+
+static bool StoreIndex_Build(Context *context, StoreIndex *index) {
+    NodePool *pool = context->pool;
+    SceneList *list = &context->sceneList;
+    *index = (StoreIndex){0};
+
+    uint32_t capacity = 1024;
+    while (capacity < (uint32_t)pool->liveCount * 2) capacity *= 2;
+    index->keys = (KeyMap){ .capacity = capacity };
+    index->keys.slots = calloc(capacity, sizeof(KeySlot));
+    index->home = calloc(NodePool_SlotCount(pool) + 1, sizeof(int));
+    index->unloaded = malloc((list->count + 1) * sizeof(uint32_t));
+    if (!index->keys.slots || !index->home || !index->unloaded) {
+        StoreIndex_Free(index);
+        return false;
+    }
+
+    for (Node *node = context->zHead; node; node = node->nextZ) {
+        *KeyMap_Find(&index->keys, node->saveKey) = (KeySlot){ node->saveKey, node };
+        index->keys.count++;
+    }
+
+    // walking the list backwards leaves every node with the first scene that holds it
+    for (int s = list->count - 1; s >= 0; s--) {
+        SceneOutline *scene = &list->scenes[s];
+        if (scene->unloaded) {
+            index->unloaded[index->unloadedCount++] = scene->chunkId;
+            continue;
+        }
+        for (int n = 0; n < scene->nodeCount; n++) {
+            Node *node = NodePool_Resolve(pool, scene->containedNodes[n]);
+            if (node) index->home[node->index] = s + 1;
+        }
+    }
+    qsort(index->unloaded, index->unloadedCount, sizeof(uint32_t), CompareU32);
+    return true;
+}
+
+// The loose chunk and the chunks of deleted scenes (their nodes stayed) count as loaded
+static bool StoreIndex_Loaded(const StoreIndex *index, uint32_t chunkId) {
+    return chunkId == 0 || !bsearch(&chunkId, index->unloaded, index->unloadedCount, sizeof(uint32_t), CompareU32);
+}
+
+static uint32_t StoreIndex_Chunk(const Context *context, const StoreIndex *index, const Node *node) {
+    int home = index->home[node->index];
+    return home ? context->sceneList.scenes[home - 1].chunkId : 0;
+}
+
+// === Chunks ===
+static uint64_t Store_Hash(const unsigned char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 1099511628211ull;
+    return hash;
+}
+
+static void Put_U64(unsigned char *p, uint64_t value) {
+    Put_U32(p, (uint32_t)value);
+    Put_U32(p + 4, (uint32_t)(value >> 32));
+}
+
+static uint64_t Get_U64(const unsigned char *p) {
+    return (uint64_t)Get_U32(p) | ((uint64_t)Get_U32(p + 4) << 32);
+}
+
+static void Store_ChunkPath(const SceneStore *store, uint32_t id, char *path, size_t size) {
+    if (id == 0) snprintf(path, size, "%s/loose.nprose", store->dir);
+    else snprintf(path, size, "%s/scene_%u.nprose", store->dir, id);
+}
+
+static StoreChunk* Store_FindChunk(SceneStore *store, uint32_t id) {
+    for (int i = 0; i < store->chunkCount; i++) {
+        if (store->chunks[i].id == id) return &store->chunks[i];
+    }
+    return NULL;
+}
+
+// Pointers from earlier calls do not survive, the table may move
+static StoreChunk* Store_AddChunk(SceneStore *store, uint32_t id) {
+    StoreChunk *chunk = Store_FindChunk(store, id);
+    if (chunk) return chunk;
+
+    if (store->chunkCount == store->chunkCapacity) {
+        int newCapacity = store->chunkCapacity ? store->chunkCapacity * 2 : 64;
+        StoreChunk *chunks = realloc(store->chunks, newCapacity * sizeof(StoreChunk));
+        if (!chunks) return NULL;
+        store->chunks = chunks;
+        store->chunkCapacity = newCapacity;
+    }
+    chunk = &store->chunks[store->chunkCount++];
+    *chunk = (StoreChunk){ .id = id };
+    return chunk;
+}
+
+// Scenes drawn since the last save get their chunk here
+static void Store_AssignChunks(Context *context, SceneStore *store) {
+    for (int s = 0; s < context->sceneList.count; s++) {
+        SceneOutline *scene = &context->sceneList.scenes[s];
+        if (scene->chunkId == 0) scene->chunkId = store->nextChunkId++;
+    }
+}
+
+// Written next to the target, synced and renamed over it like the project file
+static bool Store_WriteFile(const char *path, const unsigned char *data, size_t size) {
+    char tmpPath[340];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *file = fopen(tmpPath, "wb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "SCENES: Could not open [%s] for writing", tmpPath);
+        return false;
+    }
+    bool ok = fwrite(data, 1, size, file) == size && fflush(file) == 0 && File_Sync(file);
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && File_Replace(tmpPath, path);
+    if (!ok) TraceLog(LOG_WARNING, "SCENES: Failed writing [%s]", path);
+    return ok;
+}
+
+static bool Store_PushCurve(SceneStore *store, StoreCurve curve) {
+    if (store->curveCount == store->curveCapacity) {
+        int newCapacity = store->curveCapacity ? store->curveCapacity * 2 : 64;
+        StoreCurve *curves = realloc(store->curves, newCapacity * sizeof(StoreCurve));
+        if (!curves) return false;
+        store->curves = curves;
+        store->curveCapacity = newCapacity;
+    }
+    store->curves[store->curveCount++] = curve;
+    return true;
+}
+
+// === Cross-chunk connections ===
+// The Connection a link record restores, NULL when the node type has no such field
+static Connection* Store_LinkField(Node *node, uint16_t kind, uint16_t slot) {
+    switch (kind) {
+        case PROJECT_LINK_CONNECTOR:
+            return slot < MAX_CONNECTORS ? &node->connectors[slot].with : NULL;
+        case PROJECT_LINK_DEFAULT_NEXT:
+            return node->type == NODE_DEFAULT && slot == 0 ? &node->data.defaultNode.next : NULL;
+        case PROJECT_LINK_STACK_NEXT:
+            return node->type == NODE_STACK && slot < 10 ? &node->data.stackNode.next[slot] : NULL;
+        default:
+            return NULL;
+    }
+}
+
+static int CompareLink(const void *a, const void *b) {
+    const StoreLink *x = a;
+    const StoreLink *y = b;
+    if (x->ownerKey != y->ownerKey) return x->ownerKey < y->ownerKey ? -1 : 1;
+    if (x->kind != y->kind) return x->kind < y->kind ? -1 : 1;
+    return (x->slot > y->slot) - (x->slot < y->slot);
+}
+
+// Moves an end that is loaded to the chunk its node lives in now, clears it if the node is gone
+static void Store_RefreshEnd(const Context *context, const StoreIndex *index, uint32_t *key, uint32_t *chunk) {
+    if (!*key || !StoreIndex_Loaded(index, *chunk)) return;
+    Node *node = KeyMap_Get(&index->keys, *key);
+    if (node) {
+        *chunk = StoreIndex_Chunk(context, index, node);
+    } else {
+        *key = 0;
+        *chunk = 0;
+    }
+}
+
+// A dangling end still means the entry's node when it holds the captured handle, or nothing at
+// all (the chunk file leaves ends in other chunks empty)
+static bool Store_EndUntouched(NodeHandle live, NodeHandle captured) {
+    return live.generation == 0 || (live.index == captured.index && live.generation == captured.generation);
+}
+
+// An end as the live graph has it. A handle into an unloaded chunk resolves to nothing, the
+// previous entry still knows where it pointed.
+static void Store_CaptureEnd(const Context *context, const StoreIndex *index, NodeHandle handle,
+                             uint32_t previousKey, uint32_t previousChunk, NodeHandle previousHandle,
+                             uint32_t *key, uint32_t *chunk) {
+    Node *node = NodePool_Resolve(context->pool, handle);
+    if (node) {
+        *key = node->saveKey;
+        *chunk = StoreIndex_Chunk(context, index, node);
+    } else if (previousKey && !StoreIndex_Loaded(index, previousChunk) && Store_EndUntouched(handle, previousHandle)) {
+        *key = previousKey;
+        *chunk = previousChunk;
+    } else {
+        *key = 0;
+        *chunk = 0;
+    }
+}
+
+// Brings the link table up to date: entries of loaded owners are rebuilt from the live graph,
+// entries of unloaded owners only get their loaded ends re-homed
+static bool Store_CaptureLinks(Context *context, SceneStore *store, const StoreIndex *index) {
+    int kept = 0;
+    for (int i = 0; i < store->linkCount; i++) {
+        StoreLink *link = &store->links[i];
+        if (StoreIndex_Loaded(index, link->ownerChunk)) continue;
+        Store_RefreshEnd(context, index, &link->fromKey, &link->fromChunk);
+        Store_RefreshEnd(context, index, &link->toKey, &link->toChunk);
+
+        StoreLink swap = store->links[kept];
+        store->links[kept++] = *link;
+        *link = swap;
+    }
+    StoreLink *previous = store->links + kept;
+    int previousCount = store->linkCount - kept;
+    if (previousCount > 1) qsort(previous, previousCount, sizeof(StoreLink), CompareLink);
+
+    int capacity = store->linkCapacity ? store->linkCapacity : 64;
+    StoreLink *links = malloc(capacity * sizeof(StoreLink));
+    if (!links) return false;
+    if (kept) memcpy(links, store->links, kept * sizeof(StoreLink));
+    int count = kept;
+
+    static const struct { uint16_t kind; uint16_t slots; } fields[] = {
+        { PROJECT_LINK_CONNECTOR, MAX_CONNECTORS },
+        { PROJECT_LINK_DEFAULT_NEXT, 1 },
+        { PROJECT_LINK_STACK_NEXT, 10 }
+    };
+    for (Node *node = context->zHead; node; node = node->nextZ) {
+        uint32_t ownerChunk = StoreIndex_Chunk(context, index, node);
+        for (int f = 0; f < 3; f++) {
+            for (uint16_t slot = 0; slot < fields[f].slots; slot++) {
+                Connection *field = Store_LinkField(node, fields[f].kind, slot);
+                if (!field) break;
+
+                StoreLink link = {
+                    .ownerKey = node->saveKey, .ownerChunk = ownerChunk, .kind = fields[f].kind, .slot = slot,
+                    .fromHandle = field->from, .toHandle = field->to
+                };
+                const StoreLink *old = previousCount ? bsearch(&link, previous, previousCount, sizeof(StoreLink), CompareLink) : NULL;
+                const StoreLink none = {0};
+                if (!old) old = &none;
+                Store_CaptureEnd(context, index, field->from, old->fromKey, old->fromChunk, old->fromHandle,
+                                 &link.fromKey, &link.fromChunk);
+                Store_CaptureEnd(context, index, field->to, old->toKey, old->toChunk, old->toHandle,
+                                 &link.toKey, &link.toChunk);
+
+                // links inside one chunk are in the chunk file
+                bool cross = (link.fromKey && link.fromChunk != ownerChunk) || (link.toKey && link.toChunk != ownerChunk);
+                if (!cross) continue;
+
+                if (count == capacity) {
+                    StoreLink *grown = realloc(links, capacity * 2 * sizeof(StoreLink));
+                    if (!grown) {
+                        free(links);
+                        return false;
+                    }
+                    links = grown;
+                    capacity *= 2;
+                }
+                links[count++] = link;
+            }
+        }
+    }
+
+    free(store->links);
+    store->links = links;
+    store->linkCount = count;
+    store->linkCapacity = capacity;
+    return true;
+}
+
+// Curves in the table have an end in an unloaded chunk, the loaded end may have moved or gone
+static void Store_RefreshCurves(Context *context, SceneStore *store, const StoreIndex *index) {
+    int kept = 0;
+    for (int i = 0; i < store->curveCount; i++) {
+        StoreCurve *curve = &store->curves[i];
+        Store_RefreshEnd(context, index, &curve->fromKey, &curve->fromChunk);
+        Store_RefreshEnd(context, index, &curve->toKey, &curve->toChunk);
+        if (curve->fromKey && curve->toKey) store->curves[kept++] = *curve;
+    }
+    store->curveCount = kept;
+}
+
+// Puts back the connections and curves whose ends are loaded again
+static void Store_Reconnect(Context *context, SceneStore *store) {
+    StoreIndex index;
+    if (!StoreIndex_Build(context, &index)) return;
+
+    int kept = 0;
+    for (int i = 0; i < store->linkCount; i++) {
+        StoreLink *link = &store->links[i];
+        bool ownerLoaded = StoreIndex_Loaded(&index, link->ownerChunk);
+        bool fromLoaded = !link->fromKey || StoreIndex_Loaded(&index, link->fromChunk);
+        bool toLoaded = !link->toKey || StoreIndex_Loaded(&index, link->toChunk);
+
+        Node *owner = ownerLoaded ? KeyMap_Get(&index.keys, link->ownerKey) : NULL;
+        Connection *field = owner ? Store_LinkField(owner, link->kind, link->slot) : NULL;
+        if (field) {
+            Node *from = fromLoaded ? KeyMap_Get(&index.keys, link->fromKey) : NULL;
+            Node *to = toLoaded ? KeyMap_Get(&index.keys, link->toKey) : NULL;
+            // ends the author rewired while the entry waited keep the new value
+            NodePool_Touch(context->pool, owner);
+            if (from && !NodePool_Resolve(context->pool, field->from) && Store_EndUntouched(field->from, link->fromHandle)) {
+                field->from = NodePool_Handle(from);
+            }
+            if (to && !NodePool_Resolve(context->pool, field->to) && Store_EndUntouched(field->to, link->toHandle)) {
+                field->to = NodePool_Handle(to);
+            }
+        }
+
+        // complete links live in the graph from now on, the next capture takes them back if needed
+        if (!(ownerLoaded && fromLoaded && toLoaded)) store->links[kept++] = *link;
+    }
+    store->linkCount = kept;
+
+    kept = 0;
+    for (int i = 0; i < store->curveCount; i++) {
+        StoreCurve *entry = &store->curves[i];
+        if (!StoreIndex_Loaded(&index, entry->fromChunk) || !StoreIndex_Loaded(&index, entry->toChunk)) {
+            store->curves[kept++] = *entry;
+            continue;
+        }
+
+        Node *from = KeyMap_Get(&index.keys, entry->fromKey);
+        Node *to = KeyMap_Get(&index.keys, entry->toKey);
+        if (!from || !to) continue;     // an end was deleted while the other chunk was away
+
+        BezierCurve curve = { .fromNode = NodePool_Handle(from), .toNode = NodePool_Handle(to) };
+        memcpy(curve.points, entry->points, sizeof(curve.points));
+        memcpy(curve.relativeposition, entry->anchors, sizeof(curve.relativeposition));
+
+        // an end that moved meanwhile drags its side of the curve along, like Behavior_Drag does
+        Vector2 start = { from->position.x + entry->anchors[0].x, from->position.y + entry->anchors[0].y };
+        Vector2 end = { to->position.x + entry->anchors[1].x, to->position.y + entry->anchors[1].y };
+        if (start.x != curve.points[0].x || start.y != curve.points[0].y) {
+            curve.points[0] = start;
+            curve.points[1] = (Vector2){ start.x + 50, start.y };
+        }
+        if (end.x != curve.points[3].x || end.y != curve.points[3].y) {
+            curve.points[2] = (Vector2){ end.x - 50, end.y };
+            curve.points[3] = end;
+        }
+        EdgeStore_Add(&context->edges, context->pool, curve);
+    }
+    store->curveCount = kept;
+
+    StoreIndex_Free(&index);
+}
+
+// === Load / unload ===
+// scene is NULL for the loose chunk
+static bool Store_LoadChunk(Context *context, SceneStore *store, SceneOutline *scene) {
+    uint32_t id = scene ? scene->chunkId : 0;
+    StoreChunk *chunk = Store_FindChunk(store, id);
+    if (!chunk || chunk->broken) return false;
+
+    FileMap map = {0};
+    const unsigned char *data = chunk->pending;
+    size_t size = chunk->pendingSize;
+    uint32_t count = 0;
+    Node **nodes = NULL;
+
+    // empty scenes are only a manifest entry
+    if (data || chunk->nodes > 0) {
+        char path[320];
+        if (!data) {
+            Store_ChunkPath(store, id, path, sizeof(path));
+            if (!FileMap_Open(&map, path)) {
+                TraceLog(LOG_WARNING, "SCENES: Could not map [%s]", path);
+                chunk->broken = true;
+                return false;
+            }
+            data = map.data;
+            size = map.size;
+        }
+
+        bool complete;
+        nodes = Project_LoadChunk(context, data, size, &count, &complete);
+        FileMap_Close(&map);
+        if (!nodes) {
+            TraceLog(LOG_WARNING, "SCENES: Chunk %u of [%s] is not a valid project", id, store->dir);
+            chunk->broken = true;
+            return false;
+        }
+        if (!complete) {
+            // half a scene would be saved as the whole one, take it back out
+            for (uint32_t i = 0; i < count; i++) DeleteNodeFromList(nodes[i], context);
+            free(nodes);
+            TraceLog(LOG_WARNING, "SCENES: Out of memory while loading chunk %u", id);
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (scene) SceneOutline_AddNode(scene, nodes[i]);
+        MarkNodeMembershipDirty(nodes[i], context);  // overlapping scenes take their members back
+    }
+    free(nodes);
+
+    chunk->nodes = count;
+    if (size) chunk->bytes = (uint32_t)size;
+    store->residentBytes += chunk->bytes;
+    free(chunk->pending);   // the nodes hold the edits now, the next save encodes them again
+    chunk->pending = NULL;
+    chunk->pendingSize = 0;
+    if (scene) {
+        scene->unloaded = false;
+        scene->lastVisible = store->frame;
+    }
+
+    Store_Reconnect(context, store);
+    RequestRedraw(context);
+    return true;
+}
+
+static bool Store_UnloadScene(Context *context, SceneStore *store, int sceneIndex) {
+    SceneOutline *scene = &context->sceneList.scenes[sceneIndex];
+    int home = sceneIndex + 1;
+    Store_AssignChunks(context, store);
+
+    StoreIndex index;
+    if (!StoreIndex_Build(context, &index)) return false;
+    Node **nodes = malloc((context->pool->liveCount + 1) * sizeof(Node *));
+    if (!nodes || !Store_CaptureLinks(context, store, &index)) {
+        free(nodes);
+        StoreIndex_Free(&index);
+        return false;
+    }
+    Store_RefreshCurves(context, store, &index);
+
+    // === The scene's own nodes, bottom to top ===
+    uint32_t count = 0;
+    for (Node *node = context->zHead; node; node = node->nextZ) {
+        if (index.home[node->index] == home) nodes[count++] = node;
+    }
+
+    // === Curves leaving the scene go away with its nodes, the table keeps them ===
+    int curvesBefore = store->curveCount;
+    bool ok = true;
+    for (uint32_t i = 0; i < count && ok; i++) {
+        for (int ref = nodes[i]->firstEdge; ref != -1 && ok; ) {
+            BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+            int side = EDGE_REF_SIDE(ref);
+            Node *other = NodePool_Resolve(context->pool, side == 0 ? curve->toNode : curve->fromNode);
+            if (other && index.home[other->index] != home) {
+                Node *from = side == 0 ? nodes[i] : other;
+                Node *to = side == 0 ? other : nodes[i];
+                StoreCurve entry = {
+                    .fromKey = from->saveKey, .fromChunk = StoreIndex_Chunk(context, &index, from),
+                    .toKey = to->saveKey, .toChunk = StoreIndex_Chunk(context, &index, to)
+                };
+                memcpy(entry.points, curve->points, sizeof(entry.points));
+                memcpy(entry.anchors, curve->relativeposition, sizeof(entry.anchors));
+                ok = Store_PushCurve(store, entry);
+            }
+            ref = curve->nextEdge[side];
+        }
+    }
+
+    // === Encode, keep the bytes only when they differ from the file ===
+    ProjectSource source = {
+        .pool = context->pool,
+        .nodes = nodes,
+        .nodeCount = count,
+        .edges = &context->edges,
+        .scenes = &noScenes,
+        .camera = { .zoom = 1.0f },
+        .sortEdges = true       // a chunk reloaded unchanged has to encode to the same bytes
+    };
+    ByteBuffer buffer = {0};
+    ok = ok && Project_WriteBuffer(&source, &buffer, NULL);
+    StoreChunk *known = Store_FindChunk(store, scene->chunkId);
+    uint32_t residentBefore = known ? known->bytes : 0;     // a scene drawn since the last save counts nothing yet
+    StoreChunk *chunk = ok ? Store_AddChunk(store, scene->chunkId) : NULL;
+    if (!chunk) {
+        store->curveCount = curvesBefore;
+        free(buffer.data);
+        free(nodes);
+        StoreIndex_Free(&index);
+        TraceLog(LOG_WARNING, "SCENES: Out of memory while unloading scene \"%s\"", scene->name);
+        return false;
+    }
+
+    free(chunk->pending);
+    chunk->pending = NULL;
+    chunk->pendingSize = 0;
+    if (Store_Hash(buffer.data, buffer.size) != chunk->hash) {
+        chunk->pending = buffer.data;
+        chunk->pendingSize = buffer.size;
+    } else {
+        free(buffer.data);
+    }
+    chunk->nodes = count;
+    chunk->bytes = (uint32_t)buffer.size;
+    store->residentBytes -= residentBefore;
+
+    // === Members from other chunks stay, the scene's own leave in one pass ===
+    int kept = 0;
+    for (int n = 0; n < scene->nodeCount; n++) {
+        Node *node = NodePool_Resolve(context->pool, scene->containedNodes[n]);
+        if (node && index.home[node->index] == home) {
+            scene->memberBits[node->index / 32] &= ~(1u << (node->index % 32));
+        } else {
+            scene->containedNodes[kept++] = scene->containedNodes[n];
+        }
+    }
+    scene->nodeCount = kept;
+
+    for (uint32_t i = 0; i < count; i++) DeleteNodeFromList(nodes[i], context);
+    scene->unloaded = true;
+
+    free(nodes);
+    StoreIndex_Free(&index);
+    return true;
+}
+
+// Full recount, only the save needs it: load and unload keep SceneStore.residentBytes up to date
+static uint32_t Store_ResidentBytes(const Context *context, SceneStore *store) {
+    StoreChunk *loose = Store_FindChunk(store, 0);
+    uint32_t bytes = loose ? loose->bytes : 0;
+    for (int s = 0; s < context->sceneList.count; s++) {
+        const SceneOutline *scene = &context->sceneList.scenes[s];
+        StoreChunk *chunk = scene->unloaded || !scene->chunkId ? NULL : Store_FindChunk(store, scene->chunkId);
+        if (chunk) bytes += chunk->bytes;
+    }
+    return bytes;
+}
+
+// A replay gets one scene per frame: the wall clock would spread the work differently every run
+static bool Store_BudgetSpent(const Context *context, double start) {
+    return context->deterministic || Clock_Seconds() - start > SCENE_STORE_LOAD_BUDGET;
+}
+
+// Loads what comes near the view, unloads what has been away longest while over the budget
+void SceneStore_Update(Context *context) {
+    SceneStore *store = context->sceneStore;
+    if (!store) return;
+    store->frame++;
+
+    // half a screen of margin, panning reaches a scene before it shows up
+    Rectangle view = context->viewWorld;
+    float margin = fmaxf(view.width, view.height) * 0.5f;
+    Rectangle near = { view.x - margin, view.y - margin, view.width + 2 * margin, view.height + 2 * margin };
+
+    double start = Clock_Seconds();
+    bool worked = false;
+    for (int s = 0; s < context->sceneList.count; s++) {
+        SceneOutline *scene = &context->sceneList.scenes[s];
+        if (!CheckCollisionRecs(scene->bounds, near)) continue;
+        scene->lastVisible = store->frame;
+        if (!scene->unloaded) continue;
+
+        // at least one scene per frame, the rest once the frame budget allows
+        if (worked && Store_BudgetSpent(context, start)) {
+            RequestRedraw(context);
+            return;
+        }
+        Store_LoadChunk(context, store, scene);
+        worked = true;
+    }
+
+    // nothing is unloaded under the cursor's feet
+    if (context->isDragging || context->draggedScene || context->resizingScene ||
+        context->connecting || context->isDrawingScene) return;
+
+    while (store->residentBytes > SCENE_STORE_BUDGET) {
+        if (worked && Store_BudgetSpent(context, start)) {
+            RequestRedraw(context);
+            return;
+        }
+
+        int oldest = -1;
+        for (int s = 0; s < context->sceneList.count; s++) {
+            const SceneOutline *scene = &context->sceneList.scenes[s];
+            if (scene->unloaded || scene->lastVisible == store->frame) continue;
+            if (oldest < 0 || scene->lastVisible < context->sceneList.scenes[oldest].lastVisible) oldest = s;
+        }
+        if (oldest < 0 || !Store_UnloadScene(context, store, oldest)) return;
+        worked = true;
+    }
+}
+
+bool SceneStore_Require(Context *context, SceneOutline *scene) {
+    SceneStore *store = context->sceneStore;
+    if (!store || !scene->unloaded) return true;
+    return Store_LoadChunk(context, store, scene);
+}
+
+// Analysis and export need the whole graph, the next update unloads again
+bool SceneStore_LoadAll(Context *context) {
+    bool ok = true;
+    for (int s = 0; s < context->sceneList.count; s++) {
+        ok = SceneStore_Require(context, &context->sceneList.scenes[s]) && ok;
+    }
+    return ok;
+}
+
+// === Manifest ===
+static bool Store_WriteManifest(Context *context, SceneStore *store, const StoreIndex *index, uint32_t *bytes) {
+    const SceneList *list = &context->sceneList;
+    ByteBuffer out = {0};
+    unsigned char *p = ByteBuffer_Reserve(&out, SCENE_STORE_HEADER_SIZE);
+    if (p) memset(p, 0, SCENE_STORE_HEADER_SIZE);
+
+    for (int s = 0; s < list->count; s++) {
+        const SceneOutline *scene = &list->scenes[s];
+        StoreChunk *chunk = Store_FindChunk(store, scene->chunkId);
+        p = ByteBuffer_Reserve(&out, SCENE_STORE_SCENE_SIZE);
+        if (!p) break;
+        Put_F32(p + 0, scene->bounds.x);
+        Put_F32(p + 4, scene->bounds.y);
+        Put_F32(p + 8, scene->bounds.width);
+        Put_F32(p + 12, scene->bounds.height);
+        Put_U32(p + 16, scene->chunkId);
+        Put_U32(p + 20, chunk ? chunk->nodes : 0);
+        Put_U32(p + 24, chunk ? chunk->bytes : 0);
+        Put_U64(p + 28, chunk ? chunk->hash : 0);
+        memcpy(p + 36, scene->name, 32);
+    }
+
+    for (int i = 0; i < store->linkCount; i++) {
+        const StoreLink *link = &store->links[i];
+        p = ByteBuffer_Reserve(&out, SCENE_STORE_LINK_SIZE);
+        if (!p) break;
+        Put_U32(p + 0, link->ownerKey);
+        Put_U32(p + 4, link->ownerChunk);
+        Put_U16(p + 8, link->kind);
+        Put_U16(p + 10, link->slot);
+        Put_U32(p + 12, link->fromKey);
+        Put_U32(p + 16, link->fromChunk);
+        Put_U32(p + 20, link->toKey);
+        Put_U32(p + 24, link->toChunk);
+    }
+
+    // the table holds curves into unloaded chunks, curves between loaded chunks come from the graph
+    uint32_t curveCount = 0;
+    for (int i = 0; i < store->curveCount + context->edges.count; i++) {
+        StoreCurve entry;
+        if (i < store->curveCount) {
+            entry = store->curves[i];
+        } else {
+            const BezierCurve *curve = EdgeStore_At(&context->edges, i - store->curveCount);
+            Node *from = NodePool_Resolve(context->pool, curve->fromNode);
+            Node *to = NodePool_Resolve(context->pool, curve->toNode);
+            if (!from || !to || index->home[from->index] == index->home[to->index]) continue;
+            entry = (StoreCurve){
+                .fromKey = from->saveKey, .fromChunk = StoreIndex_Chunk(context, index, from),
+                .toKey = to->saveKey, .toChunk = StoreIndex_Chunk(context, index, to)
+            };
+            memcpy(entry.points, curve->points, sizeof(entry.points));
+            memcpy(entry.anchors, curve->relativeposition, sizeof(entry.anchors));
+        }
+
+        p = ByteBuffer_Reserve(&out, SCENE_STORE_CURVE_SIZE);
+        if (!p) break;
+        Put_U32(p + 0, entry.fromKey);
+        Put_U32(p + 4, entry.fromChunk);
+        Put_U32(p + 8, entry.toKey);
+        Put_U32(p + 12, entry.toChunk);
+        for (int k = 0; k < 4; k++) {
+            Put_F32(p + 16 + k * 8, entry.points[k].x);
+            Put_F32(p + 20 + k * 8, entry.points[k].y);
+        }
+        for (int k = 0; k < 2; k++) {
+            Put_F32(p + 48 + k * 8, entry.anchors[k].x);
+            Put_F32(p + 52 + k * 8, entry.anchors[k].y);
+        }
+        curveCount++;
+    }
+
+    if (out.failed) {
+        free(out.data);
+        return false;
+    }
+
+    StoreChunk *loose = Store_FindChunk(store, 0);
+    p = out.data;
+    memcpy(p, SCENE_STORE_MAGIC, 4);
+    Put_U32(p + 4, SCENE_STORE_VERSION);
+    Put_U32(p + 8, store->nextChunkId);
+    Put_U32(p + 12, context->pool->lastSaveKey);
+    Put_F32(p + 16, context->camera.target.x);
+    Put_F32(p + 20, context->camera.target.y);
+    Put_F32(p + 24, context->camera.zoom);
+    Put_U32(p + 28, (uint32_t)list->count);
+    Put_U32(p + 32, (uint32_t)store->linkCount);
+    Put_U32(p + 36, curveCount);
+    Put_U32(p + 40, loose ? loose->nodes : 0);
+    Put_U32(p + 44, loose ? loose->bytes : 0);
+    Put_U64(p + 48, loose ? loose->hash : 0);
+
+    char path[320];
+    snprintf(path, sizeof(path), "%s/%s", store->dir, SCENE_STORE_MANIFEST);
+    bool ok = Store_WriteFile(path, out.data, out.size);
+    *bytes += (uint32_t)out.size;
+    free(out.data);
+    return ok;
+}
+
+// === Save ===
+// Writes the chunks whose bytes changed, the chunks edited before they were unloaded and the manifest
+bool SceneStore_Save(Context *context, SceneStoreStats *stats) {
+    SceneStore *store = context->sceneStore;
+    if (!store) return false;
+    SceneStoreStats result = {0};
+
+    UpdateSceneNodeMembership(context);     // every node is saved with the scene it ends up in
+    Store_AssignChunks(context, store);
+
+    int groupCount = context->sceneList.count + 1;
+    StoreIndex index;
+    if (!StoreIndex_Build(context, &index)) return false;
+    Node **order = malloc((context->pool->liveCount + 1) * sizeof(Node *));
+    int *groupStart = calloc(groupCount + 1, sizeof(int));
+    if (!order || !groupStart || !Store_CaptureLinks(context, store, &index)) {
+        free(order);
+        free(groupStart);
+        StoreIndex_Free(&index);
+        TraceLog(LOG_WARNING, "SCENES: Out of memory while saving [%s]", store->dir);
+        return false;
+    }
+    Store_RefreshCurves(context, store, &index);
+
+    // === Loaded nodes grouped by chunk, bottom to top inside each ===
+    for (Node *node = context->zHead; node; node = node->nextZ) groupStart[index.home[node->index] + 1]++;
+    for (int g = 0; g < groupCount; g++) groupStart[g + 1] += groupStart[g];
+    for (Node *node = context->zHead; node; node = node->nextZ) order[groupStart[index.home[node->index]]++] = node;
+    for (int g = groupCount; g > 0; g--) groupStart[g] = groupStart[g - 1];
+    groupStart[0] = 0;
+
+    // === Loaded chunks, rewritten only when their bytes changed ===
+    bool ok = true;
+    for (int g = 0; g < groupCount && ok; g++) {
+        SceneOutline *scene = g ? &context->sceneList.scenes[g - 1] : NULL;
+        if (scene && scene->unloaded) continue;
+
+        uint32_t id = scene ? scene->chunkId : 0;
+        ProjectSource source = {
+            .pool = context->pool,
+            .nodes = order + groupStart[g],
+            .nodeCount = (uint32_t)(groupStart[g + 1] - groupStart[g]),
+            .edges = &context->edges,
+            .scenes = &noScenes,
+            .camera = { .zoom = 1.0f },
+            .sortEdges = true
+        };
+        ByteBuffer buffer = {0};
+        StoreChunk *chunk = NULL;
+        ok = Project_WriteBuffer(&source, &buffer, NULL) && (chunk = Store_AddChunk(store, id)) != NULL;
+        if (ok) {
+            uint64_t hash = Store_Hash(buffer.data, buffer.size);
+            if (hash != chunk->hash) {
+                char path[320];
+                Store_ChunkPath(store, id, path, sizeof(path));
+                ok = Store_WriteFile(path, buffer.data, buffer.size);
+                if (ok) {
+                    chunk->hash = hash;
+                    result.chunksWritten++;
+                    result.bytes += (uint32_t)buffer.size;
+                }
+            }
+            chunk->nodes = source.nodeCount;
+            chunk->bytes = (uint32_t)buffer.size;
+            chunk->broken = false;
+            result.nodes += source.nodeCount;
+        }
+        free(buffer.data);
+    }
+
+    // === Chunks unloaded with unsaved edits ===
+    for (int i = 0; i < store->chunkCount && ok; i++) {
+        StoreChunk *chunk = &store->chunks[i];
+        if (!chunk->pending) continue;
+
+        char path[320];
+        Store_ChunkPath(store, chunk->id, path, sizeof(path));
+        ok = Store_WriteFile(path, chunk->pending, chunk->pendingSize);
+        if (!ok) break;
+        chunk->hash = Store_Hash(chunk->pending, chunk->pendingSize);
+        result.chunksWritten++;
+        result.bytes += (uint32_t)chunk->pendingSize;
+        result.nodes += chunk->nodes;
+        free(chunk->pending);
+        chunk->pending = NULL;
+        chunk->pendingSize = 0;
+    }
+
+    // === Manifest last, then the files of deleted scenes ===
+    ok = ok && Store_WriteManifest(context, store, &index, &result.bytes);
+    for (int i = 0; i < store->chunkCount && ok; i++) {
+        StoreChunk *chunk = &store->chunks[i];
+        bool used = chunk->id == 0;
+        for (int s = 0; s < context->sceneList.count && !used; s++) {
+            used = context->sceneList.scenes[s].chunkId == chunk->id;
+        }
+        if (used) continue;
+
+        char path[320];
+        Store_ChunkPath(store, chunk->id, path, sizeof(path));
+        remove(path);
+        free(chunk->pending);
+        store->chunks[i--] = store->chunks[--store->chunkCount];
+    }
+    if (ok) NodePool_ClearChanges(context->pool);
+    // Recounted from the new sizes: a deleted scene's nodes stayed loaded and counted until now
+    store->residentBytes = Store_ResidentBytes(context, store);
+
+    free(order);
+    free(groupStart);
+    StoreIndex_Free(&index);
+
+    if (stats) {
+        SceneStore_GetStats(context, stats);
+        stats->nodes = result.nodes;
+        stats->chunksWritten = result.chunksWritten;
+        stats->bytes = result.bytes;
+    }
+    return ok;
+}
+
+// === Open / create / close ===
+bool SceneStore_Exists(const char *dir) {
+    char path[320];
+    snprintf(path, sizeof(path), "%s/%s", dir, SCENE_STORE_MANIFEST);
+    FILE *file = fopen(path, "rb");
+    if (file) fclose(file);
+    return file != NULL;
+}
+
+static bool Store_ValidPoint(Vector2 point) {
+    return isfinite(point.x) && isfinite(point.y) && fabsf(point.x) <= 2 * WORLD_LIMIT && fabsf(point.y) <= 2 * WORLD_LIMIT;
+}
+
+// The camera, the scene bounds and the curves of a manifest whose size was checked, before the open
+// project is cleared: the same limits as a project file, the curves go to EdgeStore_Add as they are
+static bool Store_ValidGeometry(const unsigned char *manifest, uint32_t sceneCount, uint32_t linkCount, uint32_t curveCount) {
+    const unsigned char *p = manifest;
+    if (!Camera_ValidView((Vector2){ Get_F32(p + 16), Get_F32(p + 20) }, Get_F32(p + 24))) return false;
+    p += SCENE_STORE_HEADER_SIZE;
+    for (uint32_t i = 0; i < sceneCount; i++, p += SCENE_STORE_SCENE_SIZE) {
+        if (!Scene_ValidBounds((Rectangle){ Get_F32(p + 0), Get_F32(p + 4), Get_F32(p + 8), Get_F32(p + 12) })) return false;
+    }
+    p += linkCount * SCENE_STORE_LINK_SIZE;
+    for (uint32_t i = 0; i < curveCount; i++, p += SCENE_STORE_CURVE_SIZE) {
+        for (int k = 0; k < 6; k++) {   // 4 points, 2 anchors
+            if (!Store_ValidPoint((Vector2){ Get_F32(p + 16 + k * 8), Get_F32(p + 20 + k * 8) })) return false;
+        }
+    }
+    return true;
+}
+
+// Reads the manifest and the loose chunk, scenes follow as they come into view
+bool SceneStore_Open(Context *context, const char *dir, SceneStoreStats *stats) {
+    char path[320];
+    snprintf(path, sizeof(path), "%s/%s", dir, SCENE_STORE_MANIFEST);
+    FileMap map;
+    if (!FileMap_Open(&map, path)) {
+        TraceLog(LOG_WARNING, "SCENES: Could not map [%s]", path);
+        return false;
+    }
+
+    const unsigned char *p = map.data;
+    bool valid = map.size >= SCENE_STORE_HEADER_SIZE && memcmp(p, SCENE_STORE_MAGIC, 4) == 0 &&
+                 Get_U32(p + 4) == SCENE_STORE_VERSION;
+    uint32_t sceneCount = valid ? Get_U32(p + 28) : 0;
+    uint32_t linkCount = valid ? Get_U32(p + 32) : 0;
+    uint32_t curveCount = valid ? Get_U32(p + 36) : 0;
+    uint64_t needed = SCENE_STORE_HEADER_SIZE + (uint64_t)sceneCount * SCENE_STORE_SCENE_SIZE +
+                      (uint64_t)linkCount * SCENE_STORE_LINK_SIZE + (uint64_t)curveCount * SCENE_STORE_CURVE_SIZE;
+    if (!valid || sceneCount > MAX_SCENES || needed > map.size) {
+        FileMap_Close(&map);
+        TraceLog(LOG_WARNING, "SCENES: [%s] is not a valid version %d manifest", path, SCENE_STORE_VERSION);
+        return false;
+    }
+    if (!Store_ValidGeometry(p, sceneCount, linkCount, curveCount)) {
+        FileMap_Close(&map);
+        TraceLog(LOG_WARNING, "SCENES: [%s] has a view, scene or curve out of range", path);
+        return false;
+    }
+
+    SceneStore *store = calloc(1, sizeof(SceneStore));
+    if (store) {
+        store->chunkCapacity = (int)sceneCount + 1;
+        store->chunks = calloc(store->chunkCapacity, sizeof(StoreChunk));
+        store->linkCapacity = (int)linkCount;
+        store->links = malloc((linkCount + 1) * sizeof(StoreLink));
+        store->curveCapacity = (int)curveCount;
+        store->curves = malloc((curveCount + 1) * sizeof(StoreCurve));
+    }
+    if (!store || !store->chunks || !store->links || !store->curves) {
+        if (store) {
+            free(store->chunks);
+            free(store->links);
+            free(store->curves);
+        }
+        free(store);
+        FileMap_Close(&map);
+        return false;
+    }
+
+    Project_Clear(context);
+    snprintf(store->dir, sizeof(store->dir), "%s", dir);
+    store->nextChunkId = Get_U32(p + 8);
+    context->pool->lastSaveKey = Get_U32(p + 12);
+    context->camera.target = (Vector2){ Get_F32(p + 16), Get_F32(p + 20) };
+    context->camera.zoom = Get_F32(p + 24);
+    store->chunks[store->chunkCount++] = (StoreChunk){
+        .id = 0, .nodes = Get_U32(p + 40), .bytes = Get_U32(p + 44), .hash = Get_U64(p + 48)
+    };
+    p += SCENE_STORE_HEADER_SIZE;
+
+    // === Scenes, all unloaded for now ===
+    for (uint32_t i = 0; i < sceneCount; i++, p += SCENE_STORE_SCENE_SIZE) {
+        SceneOutline *scene = &context->sceneList.scenes[context->sceneList.count++];
+        *scene = (SceneOutline){
+            .bounds = { Get_F32(p + 0), Get_F32(p + 4), Get_F32(p + 8), Get_F32(p + 12) },
+            .chunkId = Get_U32(p + 16),
+            .unloaded = true
+        };
+        memcpy(scene->name, p + 36, sizeof(scene->name));
+        scene->name[sizeof(scene->name) - 1] = '\0';
+        if (scene->chunkId >= store->nextChunkId) store->nextChunkId = scene->chunkId + 1;
+        store->chunks[store->chunkCount++] = (StoreChunk){
+            .id = scene->chunkId, .nodes = Get_U32(p + 20), .bytes = Get_U32(p + 24), .hash = Get_U64(p + 28)
+        };
+    }
+
+    // === Connections and curves between chunks ===
+    for (uint32_t i = 0; i < linkCount; i++, p += SCENE_STORE_LINK_SIZE) {
+        store->links[store->linkCount++] = (StoreLink){
+            .ownerKey = Get_U32(p + 0), .ownerChunk = Get_U32(p + 4),
+            .kind = Get_U16(p + 8), .slot = Get_U16(p + 10),
+            .fromKey = Get_U32(p + 12), .fromChunk = Get_U32(p + 16),
+            .toKey = Get_U32(p + 20), .toChunk = Get_U32(p + 24)
+        };
+    }
+    for (uint32_t i = 0; i < curveCount; i++, p += SCENE_STORE_CURVE_SIZE) {
+        StoreCurve *curve = &store->curves[store->curveCount++];
+        *curve = (StoreCurve){
+            .fromKey = Get_U32(p + 0), .fromChunk = Get_U32(p + 4),
+            .toKey = Get_U32(p + 8), .toChunk = Get_U32(p + 12)
+        };
+        for (int k = 0; k < 4; k++) curve->points[k] = (Vector2){ Get_F32(p + 16 + k * 8), Get_F32(p + 20 + k * 8) };
+        for (int k = 0; k < 2; k++) curve->anchors[k] = (Vector2){ Get_F32(p + 48 + k * 8), Get_F32(p + 52 + k * 8) };
+    }
+    if (store->nextChunkId == 0) store->nextChunkId = 1;
+    uint32_t manifestBytes = (uint32_t)map.size;
+    FileMap_Close(&map);
+
+    context->sceneStore = store;
+    bool ok = Store_LoadChunk(context, store, NULL);
+    NodePool_ClearChanges(context->pool);
+
+    if (stats) {
+        SceneStore_GetStats(context, stats);
+        stats->nodes = (uint32_t)context->pool->liveCount;
+        stats->bytes = manifestBytes + Store_FindChunk(store, 0)->bytes;
+    }
+    return ok;
+}
+
+// Splits the open project into a new store, every scene stays loaded until the budget says otherwise
+bool SceneStore_Create(Context *context, const char *dir, SceneStoreStats *stats) {
+    if (context->sceneStore) {
+        if (!SceneStore_LoadAll(context)) return false;
+        SceneStore_Close(context);
+    }
+    if (!File_MakeDir(dir)) {
+        TraceLog(LOG_WARNING, "SCENES: Could not create [%s]", dir);
+        return false;
+    }
+
+    SceneStore *store = calloc(1, sizeof(SceneStore));
+    if (!store || !Store_AddChunk(store, 0)) {
+        free(store);
+        return false;
+    }
+    snprintf(store->dir, sizeof(store->dir), "%s", dir);
+    store->nextChunkId = 1;
+    for (int s = 0; s < context->sceneList.count; s++) {
+        context->sceneList.scenes[s].chunkId = 0;
+        context->sceneList.scenes[s].unloaded = false;
+    }
+    context->sceneStore = store;
+
+    if (!SceneStore_Save(context, stats)) {
+        SceneStore_Close(context);
+        return false;
+    }
+    return true;
+}
+
+bool SceneStore_GetStats(const Context *context, SceneStoreStats *stats) {
+    SceneStore *store = context->sceneStore;
+    if (!store) return false;
+
+    *stats = (SceneStoreStats){
+        .scenes = (uint32_t)context->sceneList.count,
+        .residentBytes = store->residentBytes,
+        .crossLinks = (uint32_t)(store->linkCount + store->curveCount)
+    };
+    for (int s = 0; s < context->sceneList.count; s++) {
+        if (!context->sceneList.scenes[s].unloaded) stats->loadedScenes++;
+    }
+    return true;
+}
+
+// Unsaved edits of unloaded scenes are dropped with the store
+void SceneStore_Close(Context *context) {
+    SceneStore *store = context->sceneStore;
+    if (!store) return;
+
+    for (int i = 0; i < store->chunkCount; i++) free(store->chunks[i].pending);
+    free(store->chunks);
+    free(store->links);
+    free(store->curves);
+    free(store);
+    context->sceneStore = NULL;
+}
@@ -0,0 +1,64 @@
+#ifndef SCENESTORE_H
+#define SCENESTORE_H
+
+#include "core.h"
+#include "project.h"
+#include <stdint.h>
+
+// Scene store (<name>.scenes/)
+// A project kept as one chunk per scene plus a small manifest, so opening it only reads what is
+// on screen. A chunk is an ordinary project file (see project.h) holding the nodes whose home is
+// the scene: the first loaded scene in list order that contains them. Nodes outside every scene
+// go to the loose chunk, which is always loaded. The manifest lists every scene with its bounds
+// and chunk, plus the connections and curves between nodes of different chunks. Those are kept
+// by Node.saveKey and put back once both ends are loaded again.
+//
+// Scenes load when they come near the view and are unloaded, least recently seen first, while the
+// loaded chunks are bigger than SCENE_STORE_BUDGET. A scene unloaded with unsaved edits stays in
+// memory as an encoded chunk until the next save. A save only rewrites chunks whose bytes changed.
+//
+// Manifest, little-endian like the project file:
+//   header  magic[4], u32 version, u32 next chunk id, u32 last save key, f32 camera x, y, zoom,
+//           u32 scene count, u32 link count, u32 curve count, loose chunk (u32 nodes, u32 bytes, u64 hash)
+//   scene   f32 x, y, w, h, u32 chunk id, u32 nodes, u32 bytes, u64 hash, name[32]
+//   link    u32 owner key, u32 owner chunk, u16 kind, u16 slot, u32 from key, u32 from chunk, u32 to key, u32 to chunk
+//   curve   u32 from key, u32 from chunk, u32 to key, u32 to chunk, 4 points, 2 anchors
+// Chunk files are <dir>/loose.nprose (chunk 0) and <dir>/scene_<chunk id>.nprose.
+#define SCENE_STORE_MAGIC "NPSM"
+#define SCENE_STORE_VERSION 1
+#define SCENE_STORE_DIR "project.scenes"
+#define SCENE_STORE_MANIFEST "manifest"
+#define SCENE_STORE_HEADER_SIZE 56
+#define SCENE_STORE_SCENE_SIZE 68
+#define SCENE_STORE_LINK_SIZE 28
+#define SCENE_STORE_CURVE_SIZE 64
+#ifndef SCENE_STORE_BUDGET
+#define SCENE_STORE_BUDGET (32 * 1024 * 1024)  // encoded bytes of loaded scenes kept once off screen
+#endif
+#ifndef SCENE_STORE_LOAD_BUDGET
+#define SCENE_STORE_LOAD_BUDGET 0.004           // seconds per frame spent loading or unloading scenes
+#endif                                          // (one scene per frame when context->deterministic)
+
+typedef struct SceneStore SceneStore;   // private to scenestore.c
+
+typedef struct {
+    uint32_t scenes;
+    uint32_t loadedScenes;
+    uint32_t nodes;         // open: nodes loaded, save: nodes in the written chunks
+    uint32_t chunksWritten; // save: chunk files rewritten
+    uint32_t bytes;         // open: bytes read, save: bytes written
+    uint32_t residentBytes; // encoded size of the loaded chunks
+    uint32_t crossLinks;    // connections and curves between chunks
+} SceneStoreStats;
+
+bool SceneStore_Exists(const char *dir);
+bool SceneStore_Create(Context *context, const char *dir, SceneStoreStats *stats);
+bool SceneStore_Open(Context *context, const char *dir, SceneStoreStats *stats);
+bool SceneStore_Save(Context *context, SceneStoreStats *stats);
+void SceneStore_Update(Context *context);
+bool SceneStore_Require(Context *context, SceneOutline *scene);
+bool SceneStore_LoadAll(Context *context);
+bool SceneStore_GetStats(const Context *context, SceneStoreStats *stats);
+void SceneStore_Close(Context *context);
+
+#endif
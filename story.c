@@ -0,0 +1,525 @@
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "filemap.h"
+#include "project.h"
+#include "scenestore.h"
+#include "story.h"
+
+#define STORY_NONE UINT32_MAX
+
+// === Successors ===
+
+static bool Story_Contains(Node *const *list, int count, const Node *node) {
+    for (int i = 0; i < count; i++) {
+        if (list[i] == node) return true;
+    }
+    return false;
+}
+
+static int Story_Append(const Context *context, NodeHandle handle, Node **out, int count, int capacity) {
+    Node *target = NodePool_Resolve(context->pool, handle);
+    if (!target || count >= capacity || Story_Contains(out, count, target)) return count;
+    out[count] = target;
+    return count + 1;
+}
+
+// The node's own links, in slot order
+static int Story_OwnLinks(const Context *context, const Node *node, Node **out, int capacity) {
+    int count = 0;
+    if (node->type == NODE_DEFAULT) {
+        count = Story_Append(context, node->data.defaultNode.next.to, out, count, capacity);
+    } else if (node->type == NODE_STACK) {
+        for (int i = 0; i < 10; i++) {
+            count = Story_Append(context, node->data.stackNode.next[i].to, out, count, capacity);
+        }
+    }
+    return count;
+}
+
+// Top to bottom, then left to right: the order the author sees the branches in
+static int CompareTargets(const void *a, const void *b) {
+    const Node *na = *(Node *const *)a, *nb = *(Node *const *)b;
+    if (na->position.y != nb->position.y) return na->position.y < nb->position.y ? -1 : 1;
+    if (na->position.x != nb->position.x) return na->position.x < nb->position.x ? -1 : 1;
+    return (na->saveKey > nb->saveKey) - (na->saveKey < nb->saveKey);
+}
+
+// Every node the graph leads to from node, each once, numbered as described in story.h
+int Story_Successors(const Context *context, const Node *node, Node **out, int capacity) {
+    int own = Story_OwnLinks(context, node, out, capacity);
+    int count = own;
+
+    for (int c = 0; c < MAX_CONNECTORS; c++) {
+        count = Story_Append(context, node->connectors[c].with.to, out, count, capacity);
+    }
+    for (int ref = node->firstEdge; ref != -1; ) {
+        const BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+        if (EDGE_REF_SIDE(ref) == 0) count = Story_Append(context, curve->toNode, out, count, capacity);
+        ref = curve->nextEdge[EDGE_REF_SIDE(ref)];
+    }
+
+    if (count - own > 1) qsort(out + own, count - own, sizeof(Node *), CompareTargets);
+    return count;
+}
+
+// === Compiler ===
+
+typedef struct {
+    uint32_t word;              // operand to fill in
+    const Node *target;         // resolved node, NULL for the END at address 0
+} StoryPatch;
+
+typedef struct {
+    Context *context;
+    ByteBuffer code;
+    ByteBuffer strings;
+    ByteBuffer seeds;
+    ByteBuffer blocks;
+    ByteBuffer patches;
+    uint32_t bagWords;
+    uint32_t stackSlots;
+    uint32_t *address;          // per pool slot, STORY_NONE until emitted
+    uint32_t *text;             // per pool slot, string offset of the node's text
+    const Node **through;       // per pool slot, where a pass-through node leads (NULL: END)
+    unsigned char *state;       // per pool slot, pass-through resolution: 0 open, 1 on the path, 2 done
+    bool *queued;               // per pool slot, waiting in work
+    const Node **work;          // nodes referenced but not emitted yet
+    int workCount;
+    Node **successors;          // scratch for Story_Successors, resolving a target overwrites it
+    const Node **targets;       // branch targets of the node being emitted
+    int successorCapacity;
+} StoryCompiler;
+
+static uint32_t Compiler_Emit(StoryCompiler *compiler, uint32_t word) {
+    uint32_t at = (uint32_t)(compiler->code.size / sizeof(uint32_t));
+    unsigned char *p = ByteBuffer_Reserve(&compiler->code, sizeof(uint32_t));
+    if (p) memcpy(p, &word, sizeof(word));
+    return at;
+}
+
+static uint32_t Compiler_Op(StoryCompiler *compiler, NarrativeOp op, uint32_t a) {
+    return Compiler_Emit(compiler, (uint32_t)op | (a << NARRATIVE_OP_BITS));
+}
+
+static uint32_t Compiler_String(StoryCompiler *compiler, const char *text, uint32_t length) {
+    uint32_t offset = (uint32_t)compiler->strings.size;
+    unsigned char *p = ByteBuffer_Reserve(&compiler->strings, length + 1);
+    if (p) {
+        memcpy(p, text, length);
+        p[length] = '\0';
+    }
+    return offset;
+}
+
+// Text of a dialogue node, copied once, STORY_NONE when it has none
+static uint32_t Compiler_Text(StoryCompiler *compiler, const Node *node) {
+    if (compiler->text[node->index] != STORY_NONE) return compiler->text[node->index];
+    unsigned int length = 0;
+    const char *text = Node_TextView(node, &length);
+    if (!text || length == 0) return STORY_NONE;
+    return compiler->text[node->index] = Compiler_String(compiler, text, length);
+}
+
+static bool Compiler_PassesThrough(StoryCompiler *compiler, const Node *node) {
+    return node->type == NODE_GO_TO || (node->type == NODE_DEFAULT && Compiler_Text(compiler, node) == STORY_NONE);
+}
+
+static const Node* Compiler_First(StoryCompiler *compiler, const Node *node) {
+    int count = Story_Successors(compiler->context, node, compiler->successors, compiler->successorCapacity);
+    return count > 0 ? compiler->successors[0] : NULL;
+}
+
+// The node that really plays when the story reaches node: pass-through chains are followed to
+// their end, a chain that loops on itself ends the strand
+static const Node* Compiler_Resolve(StoryCompiler *compiler, const Node *node) {
+    const Node *walk = node;
+    while (walk && Compiler_PassesThrough(compiler, walk) && compiler->state[walk->index] == 0) {
+        compiler->state[walk->index] = 1;
+        walk = Compiler_First(compiler, walk);
+    }
+    const Node *end = NULL;
+    if (walk && !Compiler_PassesThrough(compiler, walk)) end = walk;
+    else if (walk && compiler->state[walk->index] == 2) end = compiler->through[walk->index];
+
+    for (const Node *n = node; n && compiler->state[n->index] == 1; n = Compiler_First(compiler, n)) {
+        compiler->state[n->index] = 2;
+        compiler->through[n->index] = end;
+    }
+    return end;
+}
+
+// Operand word that will hold the address of target once everything is emitted
+static void Compiler_Target(StoryCompiler *compiler, const Node *target) {
+    const Node *resolved = target ? Compiler_Resolve(compiler, target) : NULL;
+    uint32_t word = Compiler_Emit(compiler, 0);
+    StoryPatch *patch = (StoryPatch *)ByteBuffer_Reserve(&compiler->patches, sizeof(StoryPatch));
+    if (patch) *patch = (StoryPatch){ word, resolved };
+    if (resolved && compiler->address[resolved->index] == STORY_NONE && !compiler->queued[resolved->index]) {
+        compiler->queued[resolved->index] = true;
+        compiler->work[compiler->workCount++] = resolved;
+    }
+}
+
+static uint32_t Compiler_RngSlot(StoryCompiler *compiler, uint32_t seed) {
+    uint32_t slot = (uint32_t)(compiler->seeds.size / sizeof(uint32_t));
+    unsigned char *p = ByteBuffer_Reserve(&compiler->seeds, sizeof(uint32_t));
+    if (p) memcpy(p, &seed, sizeof(seed));
+    return slot;
+}
+
+// Label of a choice: the text the option leads to, or the ID of the node
+static uint32_t Compiler_Label(StoryCompiler *compiler, const Node *target) {
+    uint32_t text = Compiler_Text(compiler, target);
+    if (text != STORY_NONE) return text;
+    const Node *resolved = Compiler_Resolve(compiler, target);
+    if (resolved && (text = Compiler_Text(compiler, resolved)) != STORY_NONE) return text;
+    return Compiler_String(compiler, target->id, (uint32_t)strlen(target->id));
+}
+
+// Emits node and, while it simply continues, the nodes it falls through to
+static void Compiler_Node(StoryCompiler *compiler, const Node *node) {
+    while (node && compiler->address[node->index] == STORY_NONE) {
+        uint32_t at = (uint32_t)(compiler->code.size / sizeof(uint32_t));
+        compiler->address[node->index] = at;
+        StoryBlock *block = (StoryBlock *)ByteBuffer_Reserve(&compiler->blocks, sizeof(StoryBlock));
+        if (block) *block = (StoryBlock){ at, NodePool_Handle(node) };
+
+        Node **next = compiler->successors;
+        const Node **targets = compiler->targets;
+        int count = Story_Successors(compiler->context, node, next, compiler->successorCapacity);
+        for (int i = 0; i < count; i++) targets[i] = next[i];
+        switch (node->type) {
+            case NODE_DEFAULT: {
+                Compiler_Op(compiler, NARRATIVE_OP_LINE, 0);
+                Compiler_Emit(compiler, Compiler_Text(compiler, node));
+                const Node *following = count > 0 ? Compiler_Resolve(compiler, targets[0]) : NULL;
+                if (!following) {
+                    Compiler_Op(compiler, NARRATIVE_OP_END, 0);
+                    return;
+                }
+                if (compiler->address[following->index] == STORY_NONE) {
+                    node = following;   // falls through, no jump
+                    continue;
+                }
+                Compiler_Op(compiler, NARRATIVE_OP_JUMP, 0);
+                Compiler_Emit(compiler, compiler->address[following->index]);
+                return;
+            }
+            case NODE_USER_CHOICE: {
+                int choices = node->data.userChoiceNode.choices;
+                if (choices > 0 && choices < count) count = choices;
+                if (count == 0) break;
+                Compiler_Op(compiler, NARRATIVE_OP_CHOICE, (uint32_t)count);
+                for (int i = 0; i < count; i++) {
+                    Compiler_Emit(compiler, Compiler_Label(compiler, targets[i]));
+                    Compiler_Target(compiler, targets[i]);
+                }
+                return;
+            }
+            case NODE_RANDOM:
+            case NODE_RANDOM_BAG: {
+                if (count == 0) break;
+                bool bag = node->type == NODE_RANDOM_BAG;
+                uint32_t seed = bag ? node->data.randomBagNode.seed : node->data.randomNode.seed;
+                Compiler_Op(compiler, bag ? NARRATIVE_OP_BAG : NARRATIVE_OP_RANDOM, (uint32_t)count);
+                Compiler_Emit(compiler, Compiler_RngSlot(compiler, seed));
+                if (bag) {
+                    Compiler_Emit(compiler, compiler->bagWords);
+                    compiler->bagWords += 4 + (uint32_t)count;    // tag, targets left, round start (2), target order
+                }
+                for (int i = 0; i < count; i++) Compiler_Target(compiler, targets[i]);
+                return;
+            }
+            case NODE_STACK: {
+                int strands = Story_OwnLinks(compiler->context, node, next, compiler->successorCapacity);
+                const Node *continuation = NULL;
+                if (strands == 0) strands = count;
+                else if (count > strands) continuation = targets[strands];
+                if (strands == 0) break;
+                int first = CLAMP(node->data.stackNode.stackindex, 0, strands);
+                Compiler_Op(compiler, NARRATIVE_OP_STACK, (uint32_t)strands);
+                Compiler_Emit(compiler, compiler->stackSlots++);
+                Compiler_Emit(compiler, (uint32_t)first);
+                Compiler_Target(compiler, continuation);
+                for (int i = 0; i < strands; i++) Compiler_Target(compiler, targets[i]);
+                return;
+            }
+            case NODE_SKILL_GATE:
+            case NODE_CONDITIONAL: {
+                bool skill = node->type == NODE_SKILL_GATE;
+                const Node *pass = count > 0 ? targets[0] : NULL;
+                const Node *fail = count > 1 ? targets[1] : NULL;
+                Compiler_Op(compiler, NARRATIVE_OP_CHECK, skill ? NARRATIVE_CHECK_SKILL : NARRATIVE_CHECK_CONDITION);
+                Compiler_Emit(compiler, (uint32_t)(skill ? node->data.skillGateNode.requiredSkillId
+                                                         : node->data.conditionalNode.conditionId));
+                Compiler_Target(compiler, pass);
+                Compiler_Target(compiler, fail);
+                return;
+            }
+            default:
+                break;
+        }
+        // nothing to branch to (a Go To only lands here when started from)
+        Compiler_Op(compiler, NARRATIVE_OP_END, 0);
+        return;
+    }
+}
+
+void Story_Free(StoryProgram *program) {
+    free(program->blob);
+    free(program->blocks);
+    *program = (StoryProgram){0};
+}
+
+static void Story_PutU32(unsigned char *p, uint32_t value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+// Header, code, seeds and texts in one block, the layout the runtime reads in place
+static unsigned char* Story_Assemble(const StoryCompiler *compiler, uint32_t entry, uint32_t *size) {
+    size_t codeSize = compiler->code.size, seedSize = compiler->seeds.size, stringSize = compiler->strings.size;
+    size_t total = NARRATIVE_HEADER_SIZE + codeSize + seedSize + stringSize;
+    if (total > UINT32_MAX) return NULL;
+    unsigned char *blob = malloc(total);
+    if (!blob) return NULL;
+
+    unsigned char *body = blob + NARRATIVE_HEADER_SIZE;
+    memcpy(body, compiler->code.data, codeSize);
+    if (seedSize) memcpy(body + codeSize, compiler->seeds.data, seedSize);
+    if (stringSize) memcpy(body + codeSize + seedSize, compiler->strings.data, stringSize);
+
+    uint32_t checksum = 2166136261u;
+    for (size_t i = NARRATIVE_HEADER_SIZE; i < total; i++) checksum = (checksum ^ blob[i]) * 16777619u;
+    const uint32_t header[] = {
+        NARRATIVE_VERSION, checksum, entry, (uint32_t)(codeSize / sizeof(uint32_t)),
+        (uint32_t)(seedSize / sizeof(uint32_t)), compiler->bagWords, compiler->stackSlots, (uint32_t)stringSize, 0
+    };
+    memcpy(blob, NARRATIVE_MAGIC, 4);
+    for (size_t i = 0; i < sizeof(header) / sizeof(header[0]); i++) Story_PutU32(blob + 4 + 4 * i, header[i]);
+    *size = (uint32_t)total;
+    return blob;
+}
+
+// Compiles every loaded node, start first so the opening lines sit together
+bool Story_Compile(Context *context, const Node *start, StoryProgram *program) {
+    *program = (StoryProgram){0};
+    int slots = NodePool_SlotCount(context->pool);
+    StoryCompiler compiler = { .context = context };
+    uint32_t entry = 0;
+    compiler.address = malloc((slots + 1) * sizeof(uint32_t));
+    compiler.text = malloc((slots + 1) * sizeof(uint32_t));
+    compiler.through = calloc(slots + 1, sizeof(Node *));
+    compiler.state = calloc(slots + 1, 1);
+    compiler.queued = calloc(slots + 1, sizeof(bool));
+    compiler.work = malloc((slots + 1) * sizeof(Node *));
+
+    // every target of a node is one of its links or one of its curves
+    int maxDegree = 0;
+    for (const Node *node = context->zHead; node; node = node->nextZ) {
+        if (node->degree > maxDegree) maxDegree = node->degree;
+    }
+    compiler.successorCapacity = maxDegree + MAX_CONNECTORS + 11;
+    compiler.successors = malloc(compiler.successorCapacity * sizeof(Node *));
+    compiler.targets = malloc(compiler.successorCapacity * sizeof(Node *));
+
+    bool ok = compiler.address && compiler.text && compiler.through && compiler.state &&
+              compiler.queued && compiler.work && compiler.successors && compiler.targets;
+    if (ok) {
+        for (int i = 0; i <= slots; i++) compiler.address[i] = compiler.text[i] = STORY_NONE;
+        Compiler_Op(&compiler, NARRATIVE_OP_END, 0);
+
+        // depth first from every root, what a node leads to is emitted right after it
+        const Node *root = start ? start : context->zHead;
+        const Node *resolvedStart = root ? Compiler_Resolve(&compiler, root) : NULL;
+        if (resolvedStart) {
+            compiler.queued[resolvedStart->index] = true;
+            compiler.work[compiler.workCount++] = resolvedStart;
+        }
+        for (const Node *node = context->zHead; ; node = node->nextZ) {
+            while (compiler.workCount > 0) Compiler_Node(&compiler, compiler.work[--compiler.workCount]);
+            if (!node) break;
+            if (!Compiler_PassesThrough(&compiler, node)) Compiler_Node(&compiler, node);
+        }
+        entry = resolvedStart ? compiler.address[resolvedStart->index] : 0;
+
+        ok = !compiler.code.failed && !compiler.strings.failed && !compiler.seeds.failed &&
+             !compiler.blocks.failed && !compiler.patches.failed;
+    }
+
+    if (ok) {
+        uint32_t *code = (uint32_t *)compiler.code.data;
+        const StoryPatch *patches = (const StoryPatch *)compiler.patches.data;
+        size_t patchCount = compiler.patches.size / sizeof(StoryPatch);
+        for (size_t i = 0; i < patchCount; i++) {
+            code[patches[i].word] = patches[i].target ? compiler.address[patches[i].target->index] : 0;
+        }
+
+        program->blob = Story_Assemble(&compiler, entry, &program->blobSize);
+        ok = program->blob && Narrative_Open(&program->story, program->blob, program->blobSize);
+    }
+    if (ok) {
+        program->blocks = (StoryBlock *)compiler.blocks.data;
+        program->blockCount = (uint32_t)(compiler.blocks.size / sizeof(StoryBlock));
+    } else {
+        free(program->blob);
+        free(compiler.blocks.data);
+        *program = (StoryProgram){0};
+    }
+
+    free(compiler.code.data);
+    free(compiler.strings.data);
+    free(compiler.seeds.data);
+    free(compiler.patches.data);
+    free(compiler.address);
+    free(compiler.text);
+    free(compiler.through);
+    free(compiler.state);
+    free(compiler.queued);
+    free(compiler.work);
+    free(compiler.successors);
+    free(compiler.targets);
+    return ok;
+}
+
+// Node whose code holds address, NULL when it is gone
+const Node* Story_NodeAt(const Context *context, const StoryProgram *program, uint32_t address) {
+    uint32_t low = 0, high = program->blockCount;
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+        if (program->blocks[middle].address <= address) low = middle + 1;
+        else high = middle;
+    }
+    return low ? NodePool_Resolve(context->pool, program->blocks[low - 1].node) : NULL;
+}
+
+// Compiles the whole project from the node in front and writes the blob for the game
+bool Story_Build(Context *context, const char *path) {
+    SceneStore_LoadAll(context);
+    StoryProgram program;
+    if (!Story_Compile(context, context->zTail, &program)) {
+        TraceLog(LOG_WARNING, "STORY: Could not compile the project");
+        return false;
+    }
+
+    char tmpPath[268];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+    FILE *file = fopen(tmpPath, "wb");
+    bool ok = file && fwrite(program.blob, 1, program.blobSize, file) == program.blobSize;
+    ok = ok && fflush(file) == 0 && File_Sync(file);
+    if (file) ok = (fclose(file) == 0) && ok;
+    ok = ok && File_Replace(tmpPath, path);
+    if (ok) {
+        TraceLog(LOG_INFO, "STORY: Built %s, %u words of code, %u bytes of text, %u bytes in all",
+                 path, program.story.codeWords, program.story.stringBytes, program.blobSize);
+    } else {
+        TraceLog(LOG_WARNING, "STORY: Could not write %s", path);
+    }
+    Story_Free(&program);
+    return ok;
+}
+
+// === Playtest ===
+
+static void Playtest_Record(Playtest *playtest, const char *text, bool choice) {
+    if (playtest->historyCount == STORY_PLAYTEST_HISTORY) {
+        memmove(playtest->history, playtest->history + 1, (STORY_PLAYTEST_HISTORY - 1) * sizeof(uint32_t));
+        memmove(playtest->historyIsChoice, playtest->historyIsChoice + 1, (STORY_PLAYTEST_HISTORY - 1) * sizeof(bool));
+        playtest->historyCount--;
+    }
+    playtest->history[playtest->historyCount] = (uint32_t)(text - playtest->program.story.strings);
+    playtest->historyIsChoice[playtest->historyCount++] = choice;
+}
+
+// From the frame time instead of a global generator, a replayed session plays the same branches
+static bool Playtest_Restart(Playtest *playtest, const Context *context) {
+    uint64_t bits;
+    memcpy(&bits, &context->input.time, sizeof(bits));
+    NarrativeRandom random;
+    NarrativeRandom_Seed(&random, bits, 0);
+    uint32_t seed = NarrativeRandom_Next(&random);
+    playtest->historyCount = 0;
+    if (playtest->state.story) {
+        Narrative_Restart(&playtest->state, seed);
+        return true;
+    }
+    return Narrative_Start(&playtest->state, &playtest->program.story, playtest->memory,
+                           Narrative_MemorySize(&playtest->program.story), seed);
+}
+
+// Compiles the whole project and plays it from the node in front
+bool Playtest_Start(Context *context) {
+    Playtest_Stop(context);
+    SceneStore_LoadAll(context);    // branches may lead into any scene
+
+    double start = Clock_Seconds();
+    Playtest *playtest = calloc(1, sizeof(Playtest));
+    if (!playtest || !Story_Compile(context, context->zTail, &playtest->program)) {
+        TraceLog(LOG_WARNING, "STORY: Could not compile the project");
+        free(playtest);
+        return false;
+    }
+    TraceLog(LOG_INFO, "STORY: Compiled %d nodes into %u words, %u bytes of text in %.2f ms",
+             context->pool->liveCount, playtest->program.story.codeWords, playtest->program.story.stringBytes,
+             (Clock_Seconds() - start) * 1000.0);
+
+    // the runtime keeps its state in memory it is handed, uint32_t aligned
+    playtest->memory = malloc(Narrative_MemorySize(&playtest->program.story) + sizeof(uint32_t));
+    if (!playtest->memory || !Playtest_Restart(playtest, context)) {
+        free(playtest->memory);
+        Story_Free(&playtest->program);
+        free(playtest);
+        return false;
+    }
+    context->playtest = playtest;
+    Playtest_Update(context);
+    return true;
+}
+
+// Runs the story up to its next line, choice or check, a frame's worth of steps at a time
+void Playtest_Update(Context *context) {
+    Playtest *playtest = context->playtest;
+    if (!playtest || playtest->state.status != NARRATIVE_RUNNING) return;
+    if (Narrative_Run(&playtest->state, STORY_PLAYTEST_STEPS) == NARRATIVE_LINE) {
+        Playtest_Record(playtest, Narrative_Line(&playtest->state), false);
+    }
+    RequestRedraw(context);
+}
+
+// Input from DrawPlaytestPanel: an option, Continue (0 on a line), Restart or Close
+void Playtest_Answer(Context *context, int input) {
+    Playtest *playtest = context->playtest;
+    if (!playtest || input == PLAYTEST_INPUT_NONE) return;
+
+    if (input == PLAYTEST_INPUT_CLOSE) {
+        Playtest_Stop(context);
+    } else if (input == PLAYTEST_INPUT_RESTART) {
+        if (!Playtest_Restart(playtest, context)) Playtest_Stop(context);
+    } else if (playtest->state.status == NARRATIVE_LINE) {
+        Narrative_Continue(&playtest->state);
+    } else if (playtest->state.status == NARRATIVE_CHOICE) {
+        const char *option = Narrative_Option(&playtest->state, input);
+        if (option) Playtest_Record(playtest, option, true);
+        Narrative_Choose(&playtest->state, input);
+    } else if (playtest->state.status == NARRATIVE_CHECK) {
+        Narrative_Choose(&playtest->state, input);
+    }
+    Playtest_Update(context);
+    RequestRedraw(context);
+}
+
+void Playtest_Stop(Context *context) {
+    Playtest *playtest = context->playtest;
+    if (!playtest) return;
+    free(playtest->memory);
+    Story_Free(&playtest->program);
+    free(playtest);
+    context->playtest = NULL;
+    RequestRedraw(context);
+}
@@ -0,0 +1,69 @@
+#ifndef STORY_H
+#define STORY_H
+
+#include "core.h"
+#include <stdint.h>
+
+#include "runtime/narrative.h"
+
+// Story bytecode
+// Run and Build compile the graph into a narrative blob (runtime/narrative.h): one flat array of
+// 32-bit words plus the texts, so a playthrough never resolves handles, walks connectors or looks
+// at curves. Run plays it in the editor on the same runtime a game links, Build writes it to
+// STORY_FILE_PATH for the game to load.
+//
+// Successors of a node, in the order branches are numbered:
+//   the node's own links (DefaultNode.next, StackNode.next[]) first,
+//   then connectors and curves leaving the node, top to bottom by the position of their target.
+// Dialogue without text and Go To nodes emit nothing, jumps to them go straight to where they lead.
+// A default node plays its first successor, a user choice offers the first `choices` (all when 0),
+// skill gates and conditionals take the first successor on pass and the second on fail. A stack
+// node plays its strands (StackNode.next[], or its successors when it has none) one after the
+// other from `stackindex`, then goes on to its first other successor.
+#define STORY_FILE_PATH "project.nstory"
+#ifndef STORY_PLAYTEST_STEPS
+#define STORY_PLAYTEST_STEPS 200000 // instructions per frame while the playtest runs without a line
+#endif
+#define STORY_PLAYTEST_HISTORY 24   // transcript lines kept on the panel
+
+// Code address -> node, for highlighting what plays. Sorted by address.
+typedef struct {
+    uint32_t address;
+    NodeHandle node;
+} StoryBlock;
+
+typedef struct {
+    unsigned char *blob;        // header, code, seeds and texts as written by Build
+    uint32_t blobSize;
+    Narrative story;            // opened on blob
+    StoryBlock *blocks;         // editor only, not part of the blob
+    uint32_t blockCount;
+} StoryProgram;
+
+// Compiler, start is the node the playthrough begins at (NULL: the first node in z-order)
+bool Story_Compile(Context *context, const Node *start, StoryProgram *program);
+void Story_Free(StoryProgram *program);
+int Story_Successors(const Context *context, const Node *node, Node **out, int capacity);
+const Node* Story_NodeAt(const Context *context, const StoryProgram *program, uint32_t address);
+bool Story_Build(Context *context, const char *path);
+
+// Editor playtest behind the Run button, drawn by DrawPlaytestPanel
+typedef struct Playtest {
+    StoryProgram program;
+    NarrativeState state;
+    void *memory;                               // Narrative_MemorySize bytes
+    uint32_t history[STORY_PLAYTEST_HISTORY];   // string offsets, oldest first
+    bool historyIsChoice[STORY_PLAYTEST_HISTORY];
+    int historyCount;
+} Playtest;
+
+#define PLAYTEST_INPUT_NONE -1
+#define PLAYTEST_INPUT_CLOSE -2
+#define PLAYTEST_INPUT_RESTART -3
+
+bool Playtest_Start(Context *context);
+void Playtest_Update(Context *context);
+void Playtest_Answer(Context *context, int input);
+void Playtest_Stop(Context *context);
+
+#endif
@@ -0,0 +1,76 @@
+// Synthetic project generator: writes a story graph of any size for stress testing the editor,
+// instead of double-clicking a few hundred nodes by hand.
+//
+// Build from the repository root against the core library npp_script builds (libnodeprose.a):
+//   gcc -O2 -std=c99 -I. -o gen_project tools/gen_project.c -L. -lnodeprose -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
+// Run:
+//   gen_project out.nprose [nodes] [branching] [scenes] [textBytes] [seed] [mix]
+//   defaults: 10000 nodes, 3 targets per branching node, one scene per 500 nodes, 48 bytes of
+//   text per dialogue node, seed 1, and mix 55,5,8,5,15,5,4,3: the weights of dialogue, stack,
+//   random, bag, choice, skill gate, go to and if/else nodes.
+//   A path ending in .txt is written in the text format (projecttext.h).
+// See graphgen.h for the layout and the links.
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "project.h"
+#include "projecttext.h"
+#include "graphgen.h"
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: gen_project out.nprose [nodes] [branching] [scenes] [textBytes] [seed] [mix]\n");
+        return 1;
+    }
+    GraphSpec spec = GraphGen_DefaultSpec(argc > 2 ? atoi(argv[2]) : 10000);
+    spec.origin = (Vector2){ 0, 0 };
+    if (argc > 3) spec.branching = atoi(argv[3]);
+    if (argc > 4) spec.sceneCount = atoi(argv[4]);
+    if (argc > 5) spec.textBytes = atoi(argv[5]);
+    if (argc > 6) spec.seed = (uint32_t)strtoul(argv[6], NULL, 10);
+    if (argc > 7 && !GraphGen_ParseWeights(&spec, argv[7])) {
+        printf("mix: up to %d comma separated weights, at least one above 0\n", NODE_COUNT);
+        return 1;
+    }
+    if (spec.nodeCount < 1) spec.nodeCount = 1;
+    if (spec.textBytes < 0) spec.textBytes = 0;
+    SetTraceLogLevel(LOG_WARNING);
+
+    NodePool pool;
+    if (!NodePool_Init(&pool)) return 1;
+    Context context = { .pool = &pool, .camera = { .zoom = 1.0f } };
+    EdgeStore_Init(&context.edges);
+    SpatialGrid_Init(&context.grid);
+
+    double start = Clock_Seconds();
+    int created = GraphGen_Build(&context, &spec);
+    UpdateSceneNodeMembership(&context);
+    double buildTime = Clock_Seconds() - start;
+    if (created < spec.nodeCount) printf("out of memory after %d of %d nodes\n", created, spec.nodeCount);
+
+    const char *path = argv[1];
+    size_t length = strlen(path);
+    bool text = length > 4 && strcmp(path + length - 4, ".txt") == 0;
+    ProjectStats stats = {0};
+    start = Clock_Seconds();
+    bool ok = text ? ProjectText_Save(&context, path, &stats) : Project_Save(&context, path, &stats);
+    double saveTime = Clock_Seconds() - start;
+
+    if (ok) {
+        printf("%s: %u nodes, %u edges, %u scenes, %u bytes  (built in %.1f ms, saved in %.1f ms)\n",
+               path, stats.nodes, stats.edges, stats.scenes, stats.bytes, buildTime * 1000.0, saveTime * 1000.0);
+    } else {
+        printf("could not write %s\n", path);
+    }
+
+    Project_Clear(&context);
+    SpatialGrid_Destroy(&context.grid);
+    EdgeStore_Destroy(&context.edges);
+    NodePool_Destroy(&pool);
+    free(context.visibleNodes);
+    free(context.membershipQueue);
+    return ok ? 0 : 1;
+}
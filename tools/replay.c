@@ -0,0 +1,174 @@
+// Input replay: plays a session recorded with `nodeprose --record session.ninput` back through the
+// editor core without a window, frame by frame, and reports the frame time of the update and draw
+// phases. A corpus of real sessions becomes a frame-time regression benchmark.
+//
+// Build from the repository root against the core library npp_script builds (libnodeprose.a):
+//   gcc -O2 -std=c99 -I. -o replay tools/replay.c -L. -lnodeprose -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
+// Run:
+//   replay session.ninput [csv] [trace.json]
+//   A CSV gets one row per frame: frame, time, update and draw microseconds (-1 when not drawn).
+//   A trace gets the last TRACE_CAPACITY events as Chrome trace JSON (trace.h); "" skips the CSV.
+// Run it in a copy of the directory the session was recorded in: Load opens the same project
+// files, Save and autosave write there like they did during the session.
+//
+// Every frame gets the recorded input, time included, so double clicks, drag delays, the autosave
+// timer and playtest seeds see the times they saw while recording; the recorded menu buttons and
+// playtest answers stand in for raygui. The replay runs deterministic (Context.deterministic):
+// scene loading and autosave copying are budgeted per frame by count instead of by the clock, and
+// the autosave is written inline, so every replay of a session does the same work on the same
+// frames. The session itself ran on wall-clock budgets, so that work may fall on other frames
+// than it did while recording. Without a window there is nothing to draw with: the draw phase is the
+// CPU side only, collecting the visible nodes and curves. Scene name bars are sized without the
+// editor font in both (GetSceneLabelBounds), so recorded scene drags hit the same boxes.
+// The profiler runs during the replay (as with the overlay on, F3), its phases are summed per frame
+// and reported as means after the percentiles.
+#include "raylib.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "autosave.h"
+#include "story.h"
+#include "inputlog.h"
+#include "profiler.h"
+
+typedef struct {
+    double *items;
+    int count;
+    int capacity;
+} Samples;
+
+static bool Samples_Add(Samples *samples, double value) {
+    if (samples->count == samples->capacity) {
+        int capacity = samples->capacity ? samples->capacity * 2 : 4096;
+        double *items = realloc(samples->items, capacity * sizeof(double));
+        if (!items) return false;
+        samples->items = items;
+        samples->capacity = capacity;
+    }
+    samples->items[samples->count++] = value;
+    return true;
+}
+
+static int CompareDouble(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+// Sorts the samples in place and prints the percentiles in microseconds
+static void Samples_Report(const char *name, Samples *samples) {
+    if (samples->count == 0) {
+        printf("%-8s no frames\n", name);
+        return;
+    }
+    qsort(samples->items, samples->count, sizeof(double), CompareDouble);
+    double total = 0;
+    for (int i = 0; i < samples->count; i++) total += samples->items[i];
+
+    const double *s = samples->items;
+    int n = samples->count;
+    printf("%-8s %7d frames  mean %9.1f  p50 %9.1f  p90 %9.1f  p99 %9.1f  max %9.1f us\n", name, n,
+           total / n * 1e6, s[n / 2] * 1e6, s[(int)(n * 0.90)] * 1e6, s[(int)(n * 0.99)] * 1e6, s[n - 1] * 1e6);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: replay session.ninput [csv] [trace.json]\n");
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    InputLog log;
+    if (!InputLog_Open(&log, argv[1])) {
+        printf("could not open %s\n", argv[1]);
+        return 1;
+    }
+    FILE *csv = argc >= 3 && argv[2][0] ? fopen(argv[2], "w") : NULL;
+    if (csv) fprintf(csv, "frame,time,update_us,draw_us\n");
+
+    NodePool pool;
+    Context context;
+    if (!Editor_Init(&context, &pool)) {
+        printf("could not allocate the node pool\n");
+        return 1;
+    }
+    context.deterministic = true;
+    Autosave_Start(&context, AUTOSAVE_FILE_PATH);
+    if (argc >= 4 && !Trace_Start()) printf("could not allocate the trace ring\n");
+
+    ScreenSettings screen = {.width = 1280, .height = 720, .currentSize = SCREEN_SMALL, .currentView = VIEW_MODE_NODE};
+    Samples update = {0}, draw = {0};
+    InputFrame frame;
+    double zoneTotal[PROFILE_ZONE_COUNT] = {0};
+    double hitTests = 0;
+    Profiler_Toggle();
+    double start = Clock_Seconds();
+
+    while (InputLog_Read(&log, &frame)) {
+        Profiler_BeginFrame();
+        context.input = frame.input;
+        screen.width = frame.screenWidth;
+        screen.height = frame.screenHeight;
+
+        double t0 = Clock_Seconds();
+        Editor_Update(&context, &screen);
+        bool redraw = UpdateRedrawMode(&context);
+        double t1 = Clock_Seconds();
+
+        double drawTime = -1;
+        if (redraw) {
+            PROFILE_BEGIN(PROFILE_ZONE_CULLING);
+            CollectVisibleNodes(&context);
+            PROFILE_END(PROFILE_ZONE_CULLING);
+            drawTime = Clock_Seconds() - t1;
+        }
+
+        // the answers come after the draw pass in the editor as well
+        double t2 = Clock_Seconds();
+        PROFILE_BEGIN(PROFILE_ZONE_PLAYTEST);
+        Playtest_Answer(&context, frame.playtestInput);
+        PROFILE_END(PROFILE_ZONE_PLAYTEST);
+        PROFILE_BEGIN(PROFILE_ZONE_MENU);
+        HandleMenuAction(frame.menuAction, &context);
+        PROFILE_END(PROFILE_ZONE_MENU);
+        context.warpMouse = false;
+        double updateTime = (t1 - t0) + (Clock_Seconds() - t2);
+
+        for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) zoneTotal[zone] += profiler.zoneTime[zone];
+        hitTests += profiler.counters[PROFILE_COUNTER_HIT_TESTS];
+        Profiler_EndFrame();
+
+        Samples_Add(&update, updateTime);
+        if (redraw) Samples_Add(&draw, drawTime);
+        if (csv) {
+            fprintf(csv, "%u,%.6f,%.1f,%.1f\n", log.frames - 1, frame.input.time,
+                    updateTime * 1e6, redraw ? drawTime * 1e6 : -1.0);
+        }
+    }
+    double elapsed = Clock_Seconds() - start;
+
+    printf("replayed %u frames of %s in %.2f s, %d nodes, %d edges, %d scenes at the end\n",
+           log.frames, argv[1], elapsed, pool.liveCount, context.edges.count, context.sceneList.count);
+    Samples_Report("update", &update);
+    Samples_Report("draw", &draw);
+    if (log.frames > 0) {
+        printf("phases, mean us per frame:\n");
+        for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+            if (zoneTotal[zone] > 0) printf("  %-16s %9.2f\n", Profiler_ZoneName(zone), zoneTotal[zone] / log.frames * 1e6);
+        }
+        printf("  %-16s %9.1f\n", "hit tests", hitTests / log.frames);
+    }
+
+    if (csv) fclose(csv);
+    InputLog_Close(&log);
+    Editor_Shutdown(&context);
+    if (Trace_Recording()) {
+        if (Trace_Dump(argv[3])) printf("trace written to %s\n", argv[3]);
+        else printf("could not write %s\n", argv[3]);
+    }
+    Trace_Shutdown();
+    free(update.items);
+    free(draw.items);
+    return 0;
+}
@@ -0,0 +1,441 @@
+// Monte Carlo playthrough simulator: plays the compiled story millions of times on every core and
+// reports how often each node is reached, where playthroughs end and how long they run.
+//
+// Build from the repository root against the core library npp_script builds (libnodeprose.a):
+//   gcc -O2 -std=c99 -I. -o story_sim tools/story_sim.c -L. -lnodeprose -lraylib -lopengl32 -lgdi32 -lwinmm -lpthread
+// Run:
+//   story_sim [project] [playthroughs] [threads] [seed] [passPercent] [csv]
+//   defaults: project.nprose (or the scene store next to it), 1000000 playthroughs, every core,
+//   seed 1, checks pass 50% of the time, no CSV. A CSV gets one row per node.
+// The story starts where Run starts it. Choices are picked uniformly. Playthrough i plays with seed
+// Mix(seed ^ Mix(i)), which the runtime combines with the PCG stream RandomNode.seed /
+// RandomBagNode.seed selects for every random node. The simulated player answers from one PCG
+// stream jumped ahead by i * 2^32 numbers, so no two playthroughs share answers. Results depend on
+// the seed only, not on the thread count or on who stole which work.
+//
+// Work stealing: every thread owns a range of playthrough numbers and takes chunks off its front.
+// A thread that runs dry takes half of what is left at the back of another thread's range. The
+// counters are thread-local and summed once everyone finished.
+#define _POSIX_C_SOURCE 199309L
+#include "raylib.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "core.h"
+#include "project.h"
+#include "journal.h"
+#include "scenestore.h"
+#include "story.h"
+
+#define SIM_CHUNK 256               // playthroughs taken at a time
+#define SIM_MAX_LINES 1000          // longer playthroughs count as unfinished (a loop nobody leaves)
+#define SIM_MAX_STEPS 1000000       // instructions per playthrough, for loops without a line
+#define SIM_MAX_THREADS 256
+#define SIM_TOP 10                  // rows per table in the report
+#define SIM_PLAYER_STRIDE (1ull << 32)  // player numbers reserved per playthrough
+
+typedef struct {
+    uint64_t *visits;               // per block
+    uint64_t *endings;              // per block, playthroughs that ended there
+    uint64_t lengths[SIM_MAX_LINES + 1];    // playthroughs per number of lines
+    uint64_t playthroughs;
+    uint64_t lines;
+    uint64_t steps;
+    uint64_t errors;
+    uint64_t unfinished;
+    uint64_t chunks;
+    uint64_t steals;
+} SimCounters;
+
+struct Sim;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;           // guards next and end, the owner takes from next, thieves from end
+    uint64_t next;
+    uint64_t end;
+    struct Sim *sim;
+    int index;
+    uint32_t *memory;               // Narrative_MemorySize, reused by every playthrough
+    NarrativeState state;           // restarted per playthrough, O(1)
+    SimCounters counters;
+} SimWorker;
+
+typedef struct Sim {
+    const StoryProgram *program;
+    uint32_t *blockAt;              // per code word, 1 + the block starting there, 0 inside a block
+    NarrativeRandom player;         // stream of playthrough 0
+    uint64_t strideMultiplier;      // one SIM_PLAYER_STRIDE jump as state * multiplier + increment
+    uint64_t strideIncrement;
+    SimWorker *workers;
+    int workerCount;
+    uint32_t seed;
+    uint32_t passPercent;
+} Sim;
+
+static double Sim_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int Sim_CoreCount(void) {
+#ifdef _WIN32
+    const char *cores = getenv("NUMBER_OF_PROCESSORS");
+    int count = cores ? atoi(cores) : 1;
+#else
+    int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count < 1 ? 1 : count;
+}
+
+static uint32_t Sim_Mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// === Work stealing ===
+
+// Next chunk of playthroughs for worker, false once no thread has any left
+static bool Sim_Take(SimWorker *worker, uint64_t *first, uint64_t *count) {
+    pthread_mutex_lock(&worker->lock);
+    *count = worker->end - worker->next < SIM_CHUNK ? worker->end - worker->next : SIM_CHUNK;
+    *first = worker->next;
+    worker->next += *count;
+    pthread_mutex_unlock(&worker->lock);
+    if (*count) return true;
+
+    Sim *sim = worker->sim;
+    for (int i = 1; i < sim->workerCount; i++) {
+        SimWorker *victim = &sim->workers[(worker->index + i) % sim->workerCount];
+        pthread_mutex_lock(&victim->lock);
+        uint64_t left = victim->end - victim->next;
+        uint64_t half = left > SIM_CHUNK ? left / 2 : 0;    // a last chunk stays with its owner
+        victim->end -= half;
+        uint64_t stolen = victim->end;      // another thief may shrink it again once unlocked
+        pthread_mutex_unlock(&victim->lock);
+        if (!half) continue;
+
+        worker->counters.steals++;
+        pthread_mutex_lock(&worker->lock);
+        worker->next = stolen;
+        worker->end = stolen + half;
+        pthread_mutex_unlock(&worker->lock);
+        return Sim_Take(worker, first, count);
+    }
+    return false;
+}
+
+// === Playthroughs ===
+
+static void Sim_Play(SimWorker *worker, uint64_t playthrough, NarrativeRandom player) {
+    Sim *sim = worker->sim;
+    const Narrative *story = &sim->program->story;
+    SimCounters *counters = &worker->counters;
+    NarrativeState *state = &worker->state;
+    Narrative_Restart(state, Sim_Mix(sim->seed ^ Sim_Mix((uint32_t)playthrough ^ (uint32_t)(playthrough >> 32) * 0x9E3779B9u)));
+
+    uint32_t last = 0, lines = 0;
+    for (;;) {
+        // one instruction at a time, so every node the playthrough passes is seen
+        if (state->status == NARRATIVE_RUNNING) {
+            if (state->pc < story->codeWords && sim->blockAt[state->pc]) {
+                last = sim->blockAt[state->pc];
+                counters->visits[last - 1]++;
+            }
+            if (state->steps >= SIM_MAX_STEPS) {
+                counters->unfinished++;
+                break;
+            }
+            Narrative_Run(state, 1);
+            continue;
+        }
+        if (state->status == NARRATIVE_LINE) {
+            if (++lines > SIM_MAX_LINES) {
+                counters->unfinished++;
+                lines = SIM_MAX_LINES;
+                break;
+            }
+            Narrative_Continue(state);
+        } else if (state->status == NARRATIVE_CHOICE) {
+            Narrative_Choose(state, (int)NarrativeRandom_Below(&player, (uint32_t)Narrative_OptionCount(state)));
+        } else if (state->status == NARRATIVE_CHECK) {
+            Narrative_Choose(state, NarrativeRandom_Below(&player, 100) < sim->passPercent ? 0 : 1);
+        } else {
+            if (state->status == NARRATIVE_DONE && last) counters->endings[last - 1]++;
+            if (state->status == NARRATIVE_DONE) counters->lengths[lines]++;
+            else counters->errors++;
+            break;
+        }
+    }
+    counters->playthroughs++;
+    counters->lines += lines;
+    counters->steps += state->steps;
+}
+
+static void* Sim_Worker(void *arg) {
+    SimWorker *worker = arg;
+    Sim *sim = worker->sim;
+    uint64_t first, count;
+    while (Sim_Take(worker, &first, &count)) {
+        worker->counters.chunks++;
+        NarrativeRandom player = sim->player;
+        NarrativeRandom_Advance(&player, first * SIM_PLAYER_STRIDE);
+        for (uint64_t i = 0; i < count; i++) {
+            Sim_Play(worker, first + i, player);
+            player.state = player.state * sim->strideMultiplier + sim->strideIncrement;
+        }
+    }
+    return NULL;
+}
+
+// Plays playthroughs on threads workers and sums their counters into total
+static bool Sim_Run(Sim *sim, int threads, uint64_t playthroughs, SimCounters *total) {
+    uint32_t blocks = sim->program->blockCount;
+    size_t memorySize = Narrative_MemorySize(&sim->program->story);
+    sim->workerCount = threads;
+    sim->workers = calloc(threads, sizeof(SimWorker));
+    if (!sim->workers) return false;
+
+    bool ok = true;
+    int started = 0;
+    for (int t = 0; t < threads && ok; t++) {
+        SimWorker *worker = &sim->workers[t];
+        worker->sim = sim;
+        worker->index = t;
+        worker->next = playthroughs * t / threads;
+        worker->end = playthroughs * (t + 1) / threads;
+        worker->memory = malloc(memorySize + sizeof(uint32_t));
+        worker->counters.visits = calloc(blocks + 1, sizeof(uint64_t));
+        worker->counters.endings = calloc(blocks + 1, sizeof(uint64_t));
+        pthread_mutex_init(&worker->lock, NULL);
+        ok = worker->memory && worker->counters.visits && worker->counters.endings &&
+             Narrative_Start(&worker->state, &sim->program->story, worker->memory, memorySize, 0);
+    }
+    for (; ok && started < threads; started++) {
+        if (pthread_create(&sim->workers[started].thread, NULL, Sim_Worker, &sim->workers[started]) != 0) ok = false;
+    }
+    for (int t = 0; t < started; t++) pthread_join(sim->workers[t].thread, NULL);
+
+    // merge once at the end, nothing is shared while playing
+    for (int t = 0; t < threads; t++) {
+        SimCounters *counters = &sim->workers[t].counters;
+        if (ok) {
+            for (uint32_t b = 0; b < blocks; b++) {
+                total->visits[b] += counters->visits[b];
+                total->endings[b] += counters->endings[b];
+            }
+            for (int l = 0; l <= SIM_MAX_LINES; l++) total->lengths[l] += counters->lengths[l];
+            total->playthroughs += counters->playthroughs;
+            total->lines += counters->lines;
+            total->steps += counters->steps;
+            total->errors += counters->errors;
+            total->unfinished += counters->unfinished;
+            total->chunks += counters->chunks;
+            total->steals += counters->steals;
+        }
+        free(counters->visits);
+        free(counters->endings);
+        free(sim->workers[t].memory);
+        pthread_mutex_destroy(&sim->workers[t].lock);
+    }
+    free(sim->workers);
+    sim->workers = NULL;
+    return ok;
+}
+
+// === Report ===
+
+static const uint64_t *sortCounts;
+
+static int CompareCountsDescending(const void *a, const void *b) {
+    uint64_t ca = sortCounts[*(const uint32_t *)a], cb = sortCounts[*(const uint32_t *)b];
+    if (ca != cb) return ca < cb ? 1 : -1;
+    return (*(const uint32_t *)a > *(const uint32_t *)b) - (*(const uint32_t *)a < *(const uint32_t *)b);
+}
+
+static uint32_t Sim_LengthPercentile(const SimCounters *total, uint64_t finished, double fraction) {
+    uint64_t rank = fraction >= 1.0 ? finished - 1 : (uint64_t)(finished * fraction), seen = 0;
+    for (uint32_t l = 0; l <= SIM_MAX_LINES; l++) {
+        seen += total->lengths[l];
+        if (seen > rank) return l;
+    }
+    return SIM_MAX_LINES;
+}
+
+static void Sim_Report(const Context *context, const StoryProgram *program, const SimCounters *total, const char *csvPath) {
+    uint32_t blocks = program->blockCount;
+    const Node **nodes = malloc((blocks + 1) * sizeof(Node *));
+    uint32_t *order = malloc((blocks + 1) * sizeof(uint32_t));
+    if (!nodes || !order) return;
+    for (uint32_t b = 0; b < blocks; b++) nodes[b] = NodePool_Resolve(context->pool, program->blocks[b].node);
+    double runs = total->playthroughs ? (double)total->playthroughs : 1.0;
+
+    // path lengths, in lines shown
+    uint64_t finished = 0;
+    for (int l = 0; l <= SIM_MAX_LINES; l++) finished += total->lengths[l];
+    printf("\nfinished %llu, unfinished after %d lines %llu, errors %llu\n", (unsigned long long)finished,
+           SIM_MAX_LINES, (unsigned long long)total->unfinished, (unsigned long long)total->errors);
+    if (finished) {
+        printf("lines per finished playthrough: p50 %u  p90 %u  p99 %u  max %u\n",
+               Sim_LengthPercentile(total, finished, 0.5), Sim_LengthPercentile(total, finished, 0.9),
+               Sim_LengthPercentile(total, finished, 0.99), Sim_LengthPercentile(total, finished, 1.0));
+        for (uint32_t low = 0, high = 0; low <= SIM_MAX_LINES; low = high + 1, high = high ? high * 2 + 1 : 1) {
+            uint64_t count = 0;
+            for (uint32_t l = low; l <= high && l <= SIM_MAX_LINES; l++) count += total->lengths[l];
+            if (!count) continue;
+            char bar[41];
+            int width = (int)(40.0 * count / finished + 0.5);
+            memset(bar, '#', width);
+            bar[width] = '\0';
+            printf("  %4u-%-4u %10llu %6.2f%% %s\n", low, high, (unsigned long long)count, 100.0 * count / finished, bar);
+        }
+    }
+
+    // where playthroughs end; an ending on anything but dialogue is a branch that leads nowhere
+    for (uint32_t b = 0; b < blocks; b++) order[b] = b;
+    sortCounts = total->endings;
+    qsort(order, blocks, sizeof(uint32_t), CompareCountsDescending);
+    printf("\nendings:\n");
+    for (uint32_t i = 0; i < blocks && i < SIM_TOP && total->endings[order[i]]; i++) {
+        const Node *node = nodes[order[i]];
+        printf("  %-24s %-14s %6.2f%%\n", node ? node->id : "?", node ? GetNodeTypeName(node->type) : "?",
+               100.0 * total->endings[order[i]] / runs);
+    }
+    int deadEnds = 0;
+    for (uint32_t i = 0; i < blocks && total->endings[order[i]]; i++) {
+        const Node *node = nodes[order[i]];
+        if (!node || node->type == NODE_DEFAULT) continue;
+        if (deadEnds++ == 0) printf("dead ends (branching nodes with nothing to branch to):\n");
+        printf("  %-24s %-14s %6.2f%%\n", node->id, GetNodeTypeName(node->type), 100.0 * total->endings[order[i]] / runs);
+    }
+    if (!deadEnds) printf("no dead ends\n");
+
+    // visit frequency, visits per playthrough
+    sortCounts = total->visits;
+    qsort(order, blocks, sizeof(uint32_t), CompareCountsDescending);
+    printf("\nmost visited (per playthrough):\n");
+    for (uint32_t i = 0; i < blocks && i < SIM_TOP; i++) {
+        const Node *node = nodes[order[i]];
+        printf("  %-24s %-14s %8.3f\n", node ? node->id : "?", node ? GetNodeTypeName(node->type) : "?",
+               total->visits[order[i]] / runs);
+    }
+    uint32_t never = 0;
+    for (uint32_t b = 0; b < blocks; b++) never += total->visits[b] == 0;
+    printf("never visited: %u of %u nodes", never, blocks);
+    for (uint32_t i = blocks - never, shown = 0; i < blocks && shown < SIM_TOP; i++, shown++) {
+        const Node *node = nodes[order[i]];
+        printf("%s%s", shown ? ", " : ": ", node ? node->id : "?");
+    }
+    printf("%s\n", never > SIM_TOP ? ", ..." : "");
+
+    if (csvPath) {
+        FILE *file = fopen(csvPath, "w");
+        if (file) {
+            fprintf(file, "id,type,visits,visits_per_playthrough,endings,ending_share\n");
+            for (uint32_t b = 0; b < blocks; b++) {
+                const Node *node = nodes[b];
+                fprintf(file, "%s,%s,%llu,%.6f,%llu,%.6f\n", node ? node->id : "", node ? GetNodeTypeName(node->type) : "",
+                        (unsigned long long)total->visits[b], total->visits[b] / runs,
+                        (unsigned long long)total->endings[b], total->endings[b] / runs);
+            }
+            fclose(file);
+            printf("wrote %s\n", csvPath);
+        } else {
+            printf("could not write %s\n", csvPath);
+        }
+    }
+    free(nodes);
+    free(order);
+}
+
+int main(int argc, char **argv) {
+    const char *path = argc > 1 ? argv[1] : PROJECT_FILE_PATH;
+    long long playthroughs = argc > 2 ? atoll(argv[2]) : 1000000;
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    uint32_t seed = argc > 4 ? (uint32_t)strtoul(argv[4], NULL, 10) : 1;
+    int passPercent = argc > 5 ? atoi(argv[5]) : 50;
+    const char *csvPath = argc > 6 ? argv[6] : NULL;
+    if (playthroughs < 1) playthroughs = 1;
+    if (threads < 1) threads = Sim_CoreCount();
+    if (threads > SIM_MAX_THREADS) threads = SIM_MAX_THREADS;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    NodePool pool;
+    NodePool_Init(&pool);
+    Context context = { .pool = &pool, .camera = { .zoom = 1.0f } };
+    EdgeStore_Init(&context.edges);
+    SpatialGrid_Init(&context.grid);
+
+    // a scene store is opened whole, anything else goes through the journal
+    bool loaded;
+    if (SceneStore_Exists(path)) loaded = SceneStore_Open(&context, path, NULL) && SceneStore_LoadAll(&context);
+    else loaded = Journal_Load(&context, path, NULL);
+    if (!loaded) {
+        fprintf(stderr, "could not load %s\n", path);
+        return 1;
+    }
+
+    StoryProgram program;
+    if (!Story_Compile(&context, context.zTail, &program)) {
+        fprintf(stderr, "could not compile %s\n", path);
+        return 1;
+    }
+
+    Sim sim = {
+        .program = &program,
+        .blockAt = calloc(program.story.codeWords, sizeof(uint32_t)),
+        .seed = seed,
+        .passPercent = (uint32_t)CLAMP(passPercent, 0, 100)
+    };
+    SimCounters total = {
+        .visits = calloc(program.blockCount + 1, sizeof(uint64_t)),
+        .endings = calloc(program.blockCount + 1, sizeof(uint64_t))
+    };
+    if (!sim.blockAt || !total.visits || !total.endings) return 1;
+    NarrativeRandom_Seed(&sim.player, seed, 0x5EED);
+    NarrativeRandom stride = { 0, sim.player.increment };   // a jump is affine in the state
+    NarrativeRandom_Advance(&stride, SIM_PLAYER_STRIDE);
+    sim.strideIncrement = stride.state;
+    stride.state = 1;
+    NarrativeRandom_Advance(&stride, SIM_PLAYER_STRIDE);
+    sim.strideMultiplier = stride.state - sim.strideIncrement;
+    for (uint32_t b = 0; b < program.blockCount; b++) sim.blockAt[program.blocks[b].address] = b + 1;
+
+    double begin = Sim_Now();
+    if (!Sim_Run(&sim, threads, (uint64_t)playthroughs, &total)) {
+        fprintf(stderr, "could not start %d threads\n", threads);
+        return 1;
+    }
+    double seconds = Sim_Now() - begin;
+
+    printf("%s: %d nodes, %u compiled, %lld playthroughs on %d threads in %.3f s\n", path, pool.liveCount,
+           program.blockCount, playthroughs, threads, seconds);
+    printf("%.0f playthroughs/s, %.1f M lines/s, %.1f M steps/s, %llu chunks, %llu stolen\n",
+           total.playthroughs / seconds, total.lines / seconds / 1e6, total.steps / seconds / 1e6,
+           (unsigned long long)total.chunks, (unsigned long long)total.steals);
+    Sim_Report(&context, &program, &total, csvPath);
+
+    free(sim.blockAt);
+    free(total.visits);
+    free(total.endings);
+    Story_Free(&program);
+    Project_Clear(&context);
+    Journal_Close(&context);
+    SceneStore_Close(&context);
+    SpatialGrid_Destroy(&context.grid);
+    EdgeStore_Destroy(&context.edges);
+    NodePool_Destroy(&pool);
+    free(context.visibleNodes);
+    free(context.membershipQueue);
+    return 0;
+}
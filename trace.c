@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trace.h"
+#include "filemap.h"
+
+#define TRACE_MASK (TRACE_CAPACITY - 1)
+
+Trace trace;
+
+static const char *trackNames[TRACE_TRACK_COUNT] = { "main", "autosave worker" };
+
+// Starts a fresh recording. The ring is allocated on the first start and kept until Trace_Shutdown.
+bool Trace_Start(void) {
+    if (Trace_Recording()) return true;
+    if (!trace.events) {
+        trace.events = calloc(TRACE_CAPACITY, sizeof(TraceEvent));
+        if (!trace.events) return false;
+    }
+    __atomic_store_n(&trace.head, 0, __ATOMIC_RELAXED);
+    trace.start = Clock_Seconds();
+    __atomic_store_n(&trace.recording, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Stops recording, the events stay for Trace_Dump
+void Trace_Stop(void) {
+    __atomic_store_n(&trace.recording, false, __ATOMIC_RELAXED);
+}
+
+// Once no thread traces any more: after Editor_Shutdown stopped the workers
+void Trace_Shutdown(void) {
+    Trace_Stop();
+    free(trace.events);
+    trace.events = NULL;
+}
+
+void Trace_EventAt(TraceTrack track, char phase, const char *name, double time) {
+    uint32_t slot = __atomic_fetch_add(&trace.head, 1, __ATOMIC_RELAXED);
+    TraceEvent *event = &trace.events[slot & TRACE_MASK];
+
+    // readers skip the slot until the sequence is back; the fields are atomic too, a reader may
+    // copy them while they are overwritten and only then finds the sequence changed
+    __atomic_store_n(&event->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&event->name, name, __ATOMIC_RELAXED);
+    __atomic_store(&event->time, &time, __ATOMIC_RELAXED);
+    __atomic_store_n(&event->track, (uint8_t)track, __ATOMIC_RELAXED);
+    __atomic_store_n(&event->phase, phase, __ATOMIC_RELAXED);
+    __atomic_store_n(&event->sequence, slot + 1, __ATOMIC_RELEASE);
+}
+
+void Trace_Event(TraceTrack track, char phase, const char *name) {
+    Trace_EventAt(track, phase, name, Clock_Seconds());
+}
+
+// Writes the events in the ring as Chrome trace JSON. Recording goes on meanwhile; events being
+// overwritten while they are copied are left out, and so are ends whose begin the ring already lost.
+bool Trace_Dump(const char *path) {
+    if (!trace.events) return false;
+    FILE *file = fopen(path, "w");
+    if (!file) return false;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (int track = 0; track < TRACE_TRACK_COUNT; track++) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                track ? ",\n" : "", track, trackNames[track]);
+    }
+
+    uint32_t head = __atomic_load_n(&trace.head, __ATOMIC_ACQUIRE);
+    uint32_t first = head > TRACE_CAPACITY ? head - TRACE_CAPACITY : 0;
+    int depth[TRACE_TRACK_COUNT] = {0};
+    for (uint32_t slot = first; slot != head; slot++) {
+        TraceEvent *event = &trace.events[slot & TRACE_MASK];
+        uint32_t sequence = __atomic_load_n(&event->sequence, __ATOMIC_ACQUIRE);
+        if (sequence != slot + 1) continue;
+        TraceEvent copy;
+        copy.name = __atomic_load_n(&event->name, __ATOMIC_RELAXED);
+        __atomic_load(&event->time, &copy.time, __ATOMIC_RELAXED);
+        copy.track = __atomic_load_n(&event->track, __ATOMIC_RELAXED);
+        copy.phase = __atomic_load_n(&event->phase, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&event->sequence, __ATOMIC_RELAXED) != sequence) continue;
+
+        if (copy.track >= TRACE_TRACK_COUNT) continue;
+        if (copy.phase == 'E') {
+            if (depth[copy.track] == 0) continue;
+            depth[copy.track]--;
+        } else {
+            depth[copy.track]++;
+        }
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                copy.name, copy.phase, (copy.time - trace.start) * 1e6, copy.track);
+    }
+    fprintf(file, "\n]}\n");
+
+    bool ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
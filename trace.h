@@ -0,0 +1,54 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Event trace for offline analysis, written as Chrome trace event JSON (chrome://tracing, Perfetto)
+// TRACE_BEGIN / TRACE_END bracket a scope on one thread's track; they nest like the code does.
+// The profiler zones (profiler.h) are traced as well. Events go into a ring that keeps the last
+// TRACE_CAPACITY of them: writers claim a slot with one atomic add and publish it with a sequence
+// number, no locks, so a worker thread never waits on the main thread. Trace_Dump copies out what
+// is published and skips slots that are being overwritten.
+// Names are stored as pointers: string literals only.
+#define TRACE_CAPACITY (1 << 18)    // events, a power of two; 8 MB, allocated by Trace_Start
+#define TRACE_FILE_PATH "nodeprose_trace.json"
+
+typedef enum {
+    TRACE_TRACK_MAIN,               // the editor loop
+    TRACE_TRACK_AUTOSAVE,           // the autosave worker
+    TRACE_TRACK_COUNT
+} TraceTrack;
+
+typedef struct {
+    const char *name;
+    double time;                    // Clock_Seconds
+    uint32_t sequence;              // slot + 1 once the event is complete, 0 while it is written
+    uint8_t track;
+    char phase;                     // 'B' begin or 'E' end
+} TraceEvent;
+
+typedef struct {
+    bool recording;                 // atomic, read by every thread
+    TraceEvent *events;
+    uint32_t head;                  // atomic, slots claimed so far
+    double start;
+} Trace;
+
+extern Trace trace;
+
+static inline bool Trace_Recording(void) {
+    return __atomic_load_n(&trace.recording, __ATOMIC_RELAXED);
+}
+
+#define TRACE_BEGIN(track, name) do { if (Trace_Recording()) Trace_Event(track, 'B', name); } while (0)
+#define TRACE_END(track, name) do { if (Trace_Recording()) Trace_Event(track, 'E', name); } while (0)
+
+bool Trace_Start(void);
+void Trace_Stop(void);
+void Trace_Shutdown(void);
+void Trace_Event(TraceTrack track, char phase, const char *name);
+void Trace_EventAt(TraceTrack track, char phase, const char *name, double time);
+bool Trace_Dump(const char *path);
+
+#endif
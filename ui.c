@@ -1,7 +1,6 @@
 #include <stddef.h> // for NULL
 #include <stdio.h>  // for snprintf
 #include <string.h>
-#include <float.h>
 
 #include "raylib.h"
 #include "raymath.h"
@@ -10,12 +9,17 @@
 #include "core.h"        // contains types and extern globalFont
 #include "nodetypes.h"
 #include "ui.h"          // contains prototypes for this file
+#include "autosave.h"
+#include "scenestore.h"
+#include "story.h"
+#include "profiler.h"
 
 
 // CORE FUNCTIONS
 // Draw simple menu bar with Save, Load, Run
-void DrawMenuBar(ScreenSettings *screen){
+MenuAction DrawMenuBar(ScreenSettings *screen, const FrameInput *input){
     static bool viewModeModalOpen = false;
+    MenuAction action = MENU_ACTION_NONE;
     // Draw responsive menubar in lightpeach 
     Color LIGHTPEACH = { 255, 241, 232, 255 };
     int menuBarHeight = CLAMP(screen->height / 18, 40, 70);
@@ -40,9 +44,13 @@ void DrawMenuBar(ScreenSettings *screen){
     }
 
     // Draw GUI Buttons
-    GuiButton((Rectangle){ padding, buttonY, buttonWidth, buttonHeight }, "#4# Save");
-    GuiButton((Rectangle){ padding + buttonWidth + padding, buttonY, buttonWidth, buttonHeight }, "#3# Load");
-    GuiButton((Rectangle){ padding + 2 * (buttonWidth + padding), buttonY, buttonWidth, buttonHeight }, "#131# Run");
+    if (GuiButton((Rectangle){ padding, buttonY, buttonWidth, buttonHeight }, "#4# Save")) action = MENU_ACTION_SAVE;
+    if (GuiButton((Rectangle){ padding + buttonWidth + padding, buttonY, buttonWidth, buttonHeight }, "#3# Load")) action = MENU_ACTION_LOAD;
+    if (GuiButton((Rectangle){ padding + 2 * (buttonWidth + padding), buttonY, buttonWidth, buttonHeight }, "#131# Run")) action = MENU_ACTION_RUN;
+    if (GuiButton((Rectangle){ padding + 4 * (buttonWidth + padding), buttonY, buttonWidth, buttonHeight }, "#7# Export")) action = MENU_ACTION_EXPORT_TEXT;
+    if (GuiButton((Rectangle){ padding + 5 * (buttonWidth + padding), buttonY, buttonWidth, buttonHeight }, "#5# Import")) action = MENU_ACTION_IMPORT_TEXT;
+    if (GuiButton((Rectangle){ padding + 6 * (buttonWidth + padding), buttonY, buttonWidth, buttonHeight }, "#197# Split")) action = MENU_ACTION_SPLIT;
+    if (GuiButton((Rectangle){ padding + 7 * (buttonWidth + padding), buttonY, buttonWidth, buttonHeight }, "#142# Build")) action = MENU_ACTION_BUILD_STORY;
     
     if (viewModeModalOpen) {
         Rectangle modalBounds = {
@@ -67,8 +75,8 @@ void DrawMenuBar(ScreenSettings *screen){
             viewModeModalOpen = false;
         }
         
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            Vector2 mouse = GetMousePosition();
+        if (input->buttonsPressed & INPUT_BUTTON(MOUSE_LEFT_BUTTON)) {
+            Vector2 mouse = input->mouse;
             Rectangle closeBtn = {
                 modalBounds.x + modalBounds.width - 20,
                 modalBounds.y,
@@ -81,45 +89,70 @@ void DrawMenuBar(ScreenSettings *screen){
             }
         }  
     }
+    return action;
 }
 
-// Draw dotted background
-void DrawBackground(const ScreenSettings *screen){
+// Dotted background: one dot is baked into a small tile once, the tile is repeated by the GPU
+static RenderTexture2D backgroundTile = {0};
+
+static void BakeBackgroundTile(int spacing, int dotRadius, Color dotColor) {
+    backgroundTile = LoadRenderTexture(spacing, spacing);
+    BeginTextureMode(backgroundTile);
+        ClearBackground(BLANK);
+        DrawCircle(spacing / 2, spacing / 2, dotRadius, dotColor);
+    EndTextureMode();
+    SetTextureWrap(backgroundTile.texture, TEXTURE_WRAP_REPEAT);
+}
+
+// Draw dotted background as a single textured quad that scrolls and scales with the camera
+void DrawBackground(const ScreenSettings *screen, Camera2D camera){
     Color dotColor = DARKGRAY;
     int spacing = 20;
     int dotRadius = 2;
 
-    for (int y = spacing; y < screen->height; y += spacing)
-    {
-        for (int x = spacing; x < screen->width; x += spacing)
-        {
-            DrawCircle(x, y, dotRadius, dotColor);
-        }
-    }
+    // The tile does not depend on the window size, so a resize needs no re-bake
+    if (backgroundTile.id == 0) BakeBackgroundTile(spacing, dotRadius, dotColor);
+
+    // Dots sit on world multiples of spacing, the tile has its dot in the middle
+    Vector2 worldTopLeft = GetScreenToWorld2D((Vector2){0, 0}, camera);
+    Rectangle source = {
+        worldTopLeft.x + spacing / 2.0f,
+        worldTopLeft.y + spacing / 2.0f,
+        screen->width / camera.zoom,
+        -screen->height / camera.zoom    // render textures are stored upside down
+    };
+    Rectangle dest = { 0, 0, (float)screen->width, (float)screen->height };
+
+    DrawTexturePro(backgroundTile.texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+}
+
+void UnloadBackground(void){
+    if (backgroundTile.id != 0) UnloadRenderTexture(backgroundTile);
+    backgroundTile = (RenderTexture2D){0};
 }
 
-// Function that draws all the nodes in the linked-list
-void DrawAllNodes(Node *head, Context *context) {
-    if (!head) return;
+// Function that draws the on-screen nodes, CollectVisibleNodes already culled and z-sorted them
+void DrawAllNodes(Context *context) {
+    TRACE_BEGIN(TRACE_TRACK_MAIN, "DrawAllNodes");
 
-    Node *current = head;
+    int drawn = 0;
+    for (int i = 0; i < context->visibleCount; i++) {
+        Node *current = context->visibleNodes[i];
 
-    while (current != NULL) {
         //ok so it doesn't draw the last node...
-        if (context && current == context->draggedNode) {
-            current = current->nextZ;
-            continue;
-        }
-        
-        DrawSingleNode(current);
+        if (current == context->draggedNode) continue;
         
-
-        current = current->nextZ;
+        DrawSingleNode(current, context);
+        drawn++;
     }
+
+    context->renderStats.nodesDrawn = drawn;
+    context->renderStats.nodesCulled = context->pool->liveCount - context->visibleCount;
+    TRACE_END(TRACE_TRACK_MAIN, "DrawAllNodes");
 }
 
 // draw single node
-void DrawSingleNode(Node *node){
+void DrawSingleNode(Node *node, Context *context){
     if (!node || node->type == NODE_COUNT) return;
     
     
@@ -137,6 +170,7 @@ void DrawSingleNode(Node *node){
     // Draw background and border
     DrawRectangleRec(nodeRect, WHITE);
     DrawRectangleLinesEx(nodeRect, 2, borderColor);
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 2);
 
     // Draw connectors
     for (int c = 0; c < MAX_CONNECTORS; c++) {
@@ -145,20 +179,22 @@ void DrawSingleNode(Node *node){
 
         bool isConnected = false;
 
-        if (conn.type == CONNECTOR_INPUT && conn.with.from != NULL && conn.with.from->type != NODE_COUNT) {
+        if (conn.type == CONNECTOR_INPUT && NodePool_Resolve(context->pool, conn.with.from) != NULL) {
             isConnected = true;
         }
-        if (conn.type == CONNECTOR_OUTPUT && conn.with.to != NULL && conn.with.to->type != NODE_COUNT) {
+        if (conn.type == CONNECTOR_OUTPUT && NodePool_Resolve(context->pool, conn.with.to) != NULL) {
             isConnected = true;
         }
 
         if (isConnected) {
             // Solid blue if connected
             DrawCircleV(conn.center, conn.radius + 2, BLUE);
+            PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
         } else {
             // White fill if not connected
             DrawCircleV(conn.center, conn.radius, WHITE);
             DrawCircleLines((int)conn.center.x, (int)conn.center.y, conn.radius, DARKGRAY);
+            PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 2);
         }
     }
 
@@ -175,6 +211,7 @@ void DrawSingleNode(Node *node){
 
     GuiSetStyle(LABEL, TEXT_ALIGNMENT, TEXT_ALIGN_LEFT);
     GuiLabel((Rectangle){titlePos.x, titlePos.y, node->width, fontSize + 4}, title);
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
 
     // Icons
     DrawNodeDeleteIcon(node, 16.0f);
@@ -206,23 +243,17 @@ void DrawSingleNode(Node *node){
             };
 
             DrawTextEx(globalFont, labelBuffer, drawPos, (float)fontSize, 1, GRAY);
+            PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 2);
         }
     } 
 }
 
-// Draw Live Bezier
-void DrawLiveBezier(Context *context) {
+// Draw Live Bezier, Behavior_LiveConnection keeps its points on the cursor
+void DrawLiveBezier(const Context *context) {
     if (!context->connecting) return;
 
-    Vector2 start = context->connectionStart;
-    Vector2 end = GetMousePosition();
-
-    context->bezier[0] = start;
-    context->bezier[1] = (Vector2){start.x + 50, start.y};
-    context->bezier[2] = (Vector2){end.x - 50, end.y};
-    context->bezier[3] = end;
-
-    DrawSplineBezierCubic(context->bezier, 4, 3.0f, RED);
+    DrawSplineBezierCubic((Vector2 *)context->bezier, 4, 3.0f, RED);
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
     
     // 🔴 Draw red highlight dot on origin connector
     if (context->connectingFromNode && context->connectingFromConnectorIndex >= 0) {
@@ -230,6 +261,7 @@ void DrawLiveBezier(Context *context) {
         float outerRadius = conn.radius + 2.5f;
 
         DrawCircleV(conn.center, outerRadius, RED);  // solid red dot
+        PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
     }
     
     // 🔴 Draw red dot on hovered input connector during live connect
@@ -238,264 +270,89 @@ void DrawLiveBezier(Context *context) {
         float outerRadius = conn.radius + 2.5f;
 
         DrawCircleV(conn.center, outerRadius, RED); // solid red dot
-    }
-    
-    // Folded-in cancellation logic (end of frame)
-        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        bool overInput = (context->hoveredInputNode && context->hoveredInputConnectorIndex >= 0);
-        bool overOrigin = false;
-
-        if (context->connectingFromNode) {
-            Rectangle originBounds = {
-                context->connectingFromNode->position.x,
-                context->connectingFromNode->position.y,
-                (float)context->connectingFromNode->width,
-                (float)(context->connectingFromNode->isExpanded
-                        ? context->connectingFromNode->height * 5
-                        : context->connectingFromNode->height)
-            };
-            overOrigin = CheckCollisionPointRec(GetMousePosition(), originBounds);
-        }
-
-        if (!overInput && !overOrigin) {
-            TraceLog(LOG_INFO, "Live connection cancelled: clicked outside input and origin node.");
-            context->connecting = false;
-            context->connectingFromNode = NULL;
-            context->connectingFromConnectorIndex = -1;
-            context->hoveredInputNode = NULL;
-            context->hoveredInputConnectorIndex = -1;
-        }
+        PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
     }
 }
 
-// draws permanent bezier connections
+// draws permanent bezier connections, CollectVisibleNodes already culled them by their bounds
 void DrawPermanentConnections(Context *context) {
-    for (int i = 0; i < context->bezierCount; i++) {
-        BezierCurve *curve = &context->permanentBeziers[i];
+    TRACE_BEGIN(TRACE_TRACK_MAIN, "DrawPermanentConnections");
+    context->renderStats.curvesDrawn = 0;
 
-        if (curve->fromNode == context->draggedNode || curve->toNode == context->draggedNode) {
-            continue;  // skip if connected to dragged node
-        }
+    for (int i = 0; i < context->visibleCurveCount; i++) {
+        BezierCurve *curve = EdgeStore_At(&context->edges, context->visibleCurves[i]);
 
-        Vector2 *points = curve->points;
+        if (NodeHandle_Is(curve->fromNode, context->draggedNode) || NodeHandle_Is(curve->toNode, context->draggedNode)) {
+            continue;  // DrawTopNodeAndConnections draws it
+        }
 
-        DrawSplineBezierCubic(points, 4, 3.0f, BLUE);
+        DrawSplineBezierCubic(curve->points, 4, 3.0f, BLUE);
+        context->renderStats.curvesDrawn++;
     }
+    context->renderStats.curvesCulled = context->edges.count - context->renderStats.curvesDrawn;
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, context->renderStats.curvesDrawn);
+    TRACE_END(TRACE_TRACK_MAIN, "DrawPermanentConnections");
 }
 
 // draw permanent connections
 void DrawPermanentConnectionsForNode(Node *node, Context *context) {
-    for (int i = 0; i < context->bezierCount; i++) {
-        BezierCurve *curve = &context->permanentBeziers[i];
-
-        if (curve->fromNode == node || curve->toNode == node) {
-            Vector2 *points = curve->points;
+    for (int ref = node->firstEdge; ref != -1; ) {
+        BezierCurve *curve = EdgeStore_At(&context->edges, EDGE_REF_INDEX(ref));
+        Vector2 *points = curve->points;
 
-            DrawSplineBezierCubic(points, 4, 3.0f, BLUE);
-        }
+        DrawSplineBezierCubic(points, 4, 3.0f, BLUE);
+        PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
+        ref = curve->nextEdge[EDGE_REF_SIDE(ref)];
     }
 }
 
 // function that draws the topnode and the permanent beziers connected to it
-void DrawTopNodeAndConnections(Node *head, Context *context) {
+void DrawTopNodeAndConnections(Context *context) {
     if (context->draggedNode) {
-        DrawSingleNode(context->draggedNode);
+        TRACE_BEGIN(TRACE_TRACK_MAIN, "DrawTopNodeAndConnections");
+        DrawSingleNode(context->draggedNode, context);
         DrawPermanentConnectionsForNode(context->draggedNode, context);
+        TRACE_END(TRACE_TRACK_MAIN, "DrawTopNodeAndConnections");
     }
 }
 
+// Shrink and delete icons, with hover feedback while nothing is being dragged
+void DrawSceneIcons(const SceneOutline *scene, const Context *context) {
+    bool busy = context->draggedNode || context->draggedScene != NULL;
+
+    Rectangle wandBounds = GetSceneIconBounds(scene, SCENE_ICON_SHRINK);
+    bool wandHovered = !busy && CheckCollisionPointRec(context->mouseWorld, wandBounds);
+    DrawRectangleRec(wandBounds, wandHovered ? LIME : DARKGREEN);
+    GuiDrawIcon(ICON_LASER, (int)wandBounds.x, (int)wandBounds.y, 1, WHITE);
+
+    Rectangle xBounds = GetSceneIconBounds(scene, SCENE_ICON_DELETE);
+    bool xHovered = !busy && CheckCollisionPointRec(context->mouseWorld, xBounds);
+    DrawRectangleRec(xBounds, xHovered ? LIME : DARKGREEN);
+    GuiDrawIcon(ICON_CROSS_SMALL, (int)xBounds.x, (int)xBounds.y, 1, WHITE);
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 4);
+}
+
 // function that draws scene outline
 void DrawSceneOutlines(Context *context) {
-    Vector2 mouse = GetMousePosition();
-    bool cursorOverridden = false;
+    TRACE_BEGIN(TRACE_TRACK_MAIN, "DrawSceneOutlines");
+    context->renderStats.scenesDrawn = 0;
+    context->renderStats.scenesCulled = 0;
 
     for (int i = 0; i < context->sceneList.count; i++) {
         SceneOutline *scene = &context->sceneList.scenes[i];
 
-        // === Label Setup ===
+        // Off-screen scenes are not drawn unless they are being dragged or resized
+        if (!CheckCollisionRecs(GetSceneCullBounds(scene), context->viewWorld) &&
+            context->draggedScene != scene && context->resizingScene != scene) {
+            context->renderStats.scenesCulled++;
+            continue;
+        }
+        context->renderStats.scenesDrawn++;
+
         int fontSize = 12;
-        float iconSize = 16.0f;
-        float iconPadding = 4.0f; 
-        float labelHeight = 20.0f;
         char labelBuffer[64];
-        snprintf(labelBuffer, sizeof(labelBuffer), "Scene: %s",
-                 scene->name[0] != '\0' ? scene->name : "Unnamed");
-
+        Rectangle labelBar = GetSceneLabelBounds(scene, labelBuffer, sizeof(labelBuffer));
         Vector2 textSize = MeasureTextEx(globalFont, labelBuffer, fontSize, 1);
-        float labelPadding = 12.0f;
-        float labelWidth = textSize.x + labelPadding;
-        float minSceneWidth = labelWidth + iconSize + 2 * iconPadding;
-
-        Rectangle labelBar = {
-            scene->bounds.x,
-            scene->bounds.y,
-            labelWidth,
-            labelHeight
-        };
-
-        // === Dragging via label ===
-        if (!context->isResizingScene && !context->isResizingSceneVertically &&
-            !context->draggedScene && CheckCollisionPointRec(mouse, labelBar) && (!context->draggedNode)) {
-            SetMouseCursor(MOUSE_CURSOR_RESIZE_ALL);
-            cursorOverridden = true;
-        }
-
-        if (!context->draggedScene && CheckCollisionPointRec(mouse, labelBar) &&
-            IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            context->draggedScene = scene;
-            context->sceneDragOffset = Vector2Subtract(mouse, (Vector2){scene->bounds.x, scene->bounds.y});
-        }
-
-        if (context->draggedScene == scene && IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-            Vector2 newPos = Vector2Subtract(mouse, context->sceneDragOffset);
-            Rectangle newBounds = {
-                newPos.x,
-                newPos.y,
-                scene->bounds.width,
-                scene->bounds.height
-            };
-
-            // Prevent overlap with other scenes
-            bool overlaps = false;
-            for (int i = 0; i < context->sceneList.count; i++) {
-                SceneOutline *other = &context->sceneList.scenes[i];
-                
-                if (other == scene) continue;
-
-                if (CheckCollisionRecs(newBounds, other->bounds)) {
-                    overlaps = true;
-                    break;
-                }
-            }
-
-            if (!overlaps) {
-                Vector2 oldPos = { scene->bounds.x, scene->bounds.y };
-                Vector2 delta = Vector2Subtract(newPos, oldPos);
-
-                // Move the scene
-                scene->bounds.x = newPos.x;
-                scene->bounds.y = newPos.y;
-
-                // Move all contained nodes
-                for (int n = 0; n < scene->nodeCount; n++) {
-                    Node *node = scene->containedNodes[n];
-                    node->position = Vector2Add(node->position, delta);
-                    UpdateConnectorPositions(node);
-                }
-
-                // Move all connected bezier curves of scene nodes
-                for (int b = 0; b < context->bezierCount; b++) {
-                    BezierCurve *curve = &context->permanentBeziers[b];
-
-                    for (int n = 0; n < scene->nodeCount; n++) {
-                        Node *node = scene->containedNodes[n];
-
-                        if (curve->fromNode == node || curve->toNode == node) {
-                            for (int j = 0; j < 4; j++) {
-                                curve->points[j] = Vector2Add(curve->points[j], delta);
-                            }
-                            break; // Only process once per curve
-                        }
-                    }
-                }
-            }
-        }
-
-        if (context->draggedScene == scene && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-            context->draggedScene = NULL;
-        }
-
-        // === Resize logic (unchanged) ===
-        float resizeMargin = 12.0f;
-        float resizeVerticalPadding = 32.0f;
-        float bottomResizeMargin = 12.0f;
-        float bottomHorizontalPadding = 32.0f;
-
-        Rectangle rightEdge = {
-            scene->bounds.x + scene->bounds.width - resizeMargin / 2,
-            scene->bounds.y + resizeVerticalPadding,
-            resizeMargin,
-            scene->bounds.height - 2 * resizeVerticalPadding
-        };
-        bool hoveringRight = CheckCollisionPointRec(mouse, rightEdge);
-
-        if (!context->isDragging && !context->isDrawingScene && !context->draggedNode 
-            && !context->draggedScene && hoveringRight){
-            SetMouseCursor(MOUSE_CURSOR_RESIZE_EW);
-            cursorOverridden = true;
-        }
-
-        if (!context->isResizingScene && hoveringRight && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            context->isResizingScene = true;
-            context->resizingScene = scene;
-            context->resizeStartX = mouse.x;
-            context->initialSceneWidth = scene->bounds.width;
-        }
-
-        Rectangle bottomEdge = {
-            scene->bounds.x + bottomHorizontalPadding,
-            scene->bounds.y + scene->bounds.height - bottomResizeMargin / 2,
-            scene->bounds.width - 2 * bottomHorizontalPadding,
-            bottomResizeMargin
-        };
-        bool hoveringBottom = CheckCollisionPointRec(mouse, bottomEdge);
-
-        if (!context->isDragging && !context->isDrawingScene &&
-            !context->draggedNode && !context->draggedScene && hoveringBottom) {
-            SetMouseCursor(MOUSE_CURSOR_RESIZE_NS);
-            cursorOverridden = true;
-        }
-
-        if (!context->isResizingSceneVertically && hoveringBottom && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-            context->isResizingSceneVertically = true;
-            context->resizingScene = scene;
-            context->resizeStartY = mouse.y;
-            context->initialSceneHeight = scene->bounds.height;
-        }
-
-        Rectangle cornerEdge = {
-            scene->bounds.x + scene->bounds.width - bottomHorizontalPadding / 2,
-            scene->bounds.y + scene->bounds.height - resizeVerticalPadding / 2,
-            bottomHorizontalPadding,
-            resizeVerticalPadding
-        };
-        bool hoveringCorner = CheckCollisionPointRec(mouse, cornerEdge);
-
-        if (!context->isDragging && !context->isDrawingScene &&
-            !context->draggedNode && !context->draggedScene && hoveringCorner) {
-            SetMouseCursor(MOUSE_CURSOR_RESIZE_NWSE);
-            cursorOverridden = true;
-        }
-
-        if (!context->isResizingScene && !context->isResizingSceneVertically &&
-            hoveringCorner && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && (!context->draggedNode)) {
-            context->isResizingScene = true;
-            context->isResizingSceneVertically = true;
-            context->resizingScene = scene;
-            context->resizeStartX = mouse.x;
-            context->resizeStartY = mouse.y;
-            context->initialSceneWidth = scene->bounds.width;
-            context->initialSceneHeight = scene->bounds.height;
-        }
-
-        if (context->resizingScene == scene && IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
-            if (context->isResizingScene) {
-                float deltaX = mouse.x - context->resizeStartX;
-                scene->bounds.width = fmaxf(context->initialSceneWidth + deltaX, minSceneWidth);
-            }
-            if (context->isResizingSceneVertically) {
-                float deltaY = mouse.y - context->resizeStartY;
-                scene->bounds.height = fmaxf(context->initialSceneHeight + deltaY, 40);
-            }
-        }
-
-        if ((context->isResizingScene || context->isResizingSceneVertically) &&
-            context->resizingScene == scene && IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) {
-            context->isResizingScene = false;
-            context->isResizingSceneVertically = false;
-            context->resizingScene = NULL;
-            SetMouseCursor(MOUSE_CURSOR_DEFAULT);
-        }
 
         // === Draw Scene Border and Label ===
         DrawRectangleLinesEx(scene->bounds, 2, DARKGREEN);
@@ -506,15 +363,15 @@ void DrawSceneOutlines(Context *context) {
             labelBar.y + (labelBar.height - textSize.y) / 2
         };
         DrawTextEx(globalFont, labelBuffer, textPos, fontSize, 1, WHITE);
+        PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 3);
 
-        // === Icons and behaviors ===
-        Scene_ShrinkClick(scene, context);
-        Scene_DeleteClick(scene, context);
+        // === Icons ===
+        DrawSceneIcons(scene, context);
     }
 
     // === Live Drawing Preview ===
     if (context->isDrawingScene) {
-        Vector2 mouse = GetMousePosition();
+        Vector2 mouse = context->mouseWorld;
         Vector2 start = context->sceneStartPos;
 
         Vector2 topLeft = {
@@ -539,53 +396,188 @@ void DrawSceneOutlines(Context *context) {
         // Blink red border if invalid placement
         Color previewColor;
         if (overlaps) {
-            int blink = (int)(GetTime() * 4) % 2; // Fast blink
+            int blink = (int)(context->input.time * 4) % 2; // Fast blink
             previewColor = blink ? RED : BLANK;
         } else {
             previewColor = Fade(DARKGREEN, 0.5f);
         }
 
         DrawRectangleLinesEx(previewBounds, 2, previewColor);
+        PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 1);
     }
-
-    // === Cursor Reset ===
-    if (!cursorOverridden && !context->isResizingScene &&
-        !context->isResizingSceneVertically && !context->draggedScene) {
-        SetMouseCursor(MOUSE_CURSOR_DEFAULT);
-    }
+    TRACE_END(TRACE_TRACK_MAIN, "DrawSceneOutlines");
 }
 
-// DRAW helper functions
-void ShrinkSceneToFitContent(SceneOutline *scene){
-    if (!scene || scene->nodeCount == 0) return;
+// culled vs drawn counters in the bottom-left corner
+void DrawRenderStats(const Context *context, const ScreenSettings *screen) {
+    const RenderStats *stats = &context->renderStats;
+    char statsBuffer[128];
+    snprintf(statsBuffer, sizeof(statsBuffer), "drawn/culled  nodes %d/%d  curves %d/%d  scenes %d/%d",
+             stats->nodesDrawn, stats->nodesCulled, stats->curvesDrawn, stats->curvesCulled,
+             stats->scenesDrawn, stats->scenesCulled);
+
+    int fontSize = 12;
+    Vector2 textPos = { 8, (float)(screen->height - fontSize - 6) };
+    DrawTextEx(globalFont, statsBuffer, textPos, fontSize, 1, DARKGRAY);
+
+    AutosaveStats autosave;
+    if (Autosave_GetStats(context, &autosave) && autosave.saves > 0) {
+        snprintf(statsBuffer, sizeof(statsBuffer), "autosave  snapshot %.0f us  copy %.0f us  write %.1f ms%s",
+                 autosave.snapshotMicros, autosave.copyMicros, autosave.writeMillis, autosave.lastOk ? "" : "  FAILED");
+        textPos.y -= fontSize + 4;
+        DrawTextEx(globalFont, statsBuffer, textPos, fontSize, 1, autosave.lastOk ? DARKGRAY : MAROON);
+    }
 
-    const float paddingX = 20.0f;
-    const float paddingY = 20.0f;
+    SceneStoreStats scenes;
+    if (SceneStore_GetStats(context, &scenes)) {
+        snprintf(statsBuffer, sizeof(statsBuffer), "scenes loaded %u/%u  %.1f MB  cross links %u",
+                 scenes.loadedScenes, scenes.scenes, scenes.residentBytes / (1024.0 * 1024.0), scenes.crossLinks);
+        textPos.y -= fontSize + 4;
+        DrawTextEx(globalFont, statsBuffer, textPos, fontSize, 1, DARKGRAY);
+    }
+}
 
-    float minX = FLT_MAX, minY = FLT_MAX;
-    float maxX = -FLT_MAX, maxY = -FLT_MAX;
+// Outline around the node the playtest is at, drawn in world space
+void DrawPlaytestHighlight(const Context *context) {
+    const Playtest *playtest = context->playtest;
+    if (!playtest) return;
+    const Node *node = Story_NodeAt(context, &playtest->program, playtest->state.pc);
+    if (node) DrawRectangleLinesEx(GetNodeBounds(node), 3.0f / context->camera.zoom, GOLD);
+}
 
-    for (int i = 0; i < scene->nodeCount; i++) {
-        Node *node = scene->containedNodes[i];
-        if (!node || node->type == NODE_COUNT) continue;
+// First line of text, cut with "..." where it stops fitting
+static void FitText(const char *text, char *out, int outSize, float maxWidth, float fontSize) {
+    int length = 0;
+    while (text[length] && text[length] != '\n' && length < outSize - 4) length++;
+    memcpy(out, text, length);
+    out[length] = '\0';
+    if (MeasureTextEx(globalFont, out, fontSize, 1).x <= maxWidth && !text[length]) return;
+
+    while (length > 0) {
+        memcpy(out + length, "...", 4);
+        if (MeasureTextEx(globalFont, out, fontSize, 1).x <= maxWidth) return;
+        length--;
+    }
+}
 
-        float nodeHeight = node->isExpanded ? node->height * 5 : node->height;
+// Playtest panel on the right: the transcript, with the answers the story waits for below it.
+// Returns the answer clicked this frame (an option index or PLAYTEST_INPUT_*).
+int DrawPlaytestPanel(const Context *context, const ScreenSettings *screen) {
+    const Playtest *playtest = context->playtest;
+    if (!playtest) return PLAYTEST_INPUT_NONE;
+    const NarrativeState *state = &playtest->state;
+    int input = PLAYTEST_INPUT_NONE;
 
-        float left = node->position.x;
-        float top = node->position.y;
-        float right = left + node->width;
-        float bottom = top + nodeHeight;
+    int menuBarHeight = CLAMP(screen->height / 18, 40, 70);
+    float width = 420.0f, padding = 10.0f, buttonHeight = 30.0f;
+    float fontSize = 16.0f, lineHeight = fontSize + 6.0f;
+    Rectangle panel = { screen->width - width - padding, menuBarHeight + padding, width,
+                        screen->height - menuBarHeight - 4 * padding - 24 };
+    if (GuiWindowBox(panel, "#131# Playtest")) input = PLAYTEST_INPUT_CLOSE;
+
+    // answers, bottom up
+    char label[128];
+    int buttons = state->status == NARRATIVE_RUNNING ? 0 : state->status == NARRATIVE_CHOICE || state->status == NARRATIVE_CHECK ? Narrative_OptionCount(state) : 1;
+    float buttonsTop = panel.y + panel.height - padding - buttons * (buttonHeight + 4);
+    GuiSetStyle(BUTTON, TEXT_ALIGNMENT, TEXT_ALIGN_LEFT);
+    for (int i = 0; i < buttons; i++) {
+        Rectangle bounds = { panel.x + padding, buttonsTop + i * (buttonHeight + 4), width - 2 * padding, buttonHeight };
+        if (state->status == NARRATIVE_LINE) {
+            snprintf(label, sizeof(label), "Continue");
+        } else if (state->status == NARRATIVE_CHOICE) {
+            FitText(Narrative_Option(state, i), label, sizeof(label), bounds.width - 2 * fontSize, fontSize);
+        } else if (state->status == NARRATIVE_CHECK) {
+            int32_t id;
+            bool skill = Narrative_Check(state, &id) == NARRATIVE_CHECK_SKILL;
+            snprintf(label, sizeof(label), "%s %s %d", Narrative_Option(state, i), skill ? "skill check" : "condition", id);
+        } else {
+            snprintf(label, sizeof(label), state->status == NARRATIVE_DONE ? "The End - Restart" : "Story error - Restart");
+        }
+        if (GuiButton(bounds, label)) {
+            input = state->status == NARRATIVE_DONE || state->status == NARRATIVE_ERROR ? PLAYTEST_INPUT_RESTART : i;
+        }
+    }
 
-        if (left < minX) minX = left;
-        if (top < minY) minY = top;
-        if (right > maxX) maxX = right;
-        if (bottom > maxY) maxY = bottom;
+    // transcript, newest line right above the answers
+    float y = buttonsTop - padding - lineHeight;
+    if (state->status == NARRATIVE_RUNNING) {
+        snprintf(label, sizeof(label), "running... %llu steps", (unsigned long long)state->steps);
+        DrawTextEx(globalFont, label, (Vector2){ panel.x + padding, y }, fontSize, 1, GRAY);
+        y -= lineHeight;
     }
+    for (int i = playtest->historyCount - 1; i >= 0 && y > panel.y + 24 + padding; i--, y -= lineHeight) {
+        bool choice = playtest->historyIsChoice[i];
+        FitText(playtest->program.story.strings + playtest->history[i], label + 2, sizeof(label) - 2,
+                width - 2 * padding - fontSize, fontSize);
+        if (choice) memcpy(label, "> ", 2);
+        DrawTextEx(globalFont, choice ? label : label + 2, (Vector2){ panel.x + padding, y }, fontSize, 1,
+                   choice ? DARKBLUE : DARKGRAY);
+    }
+    return input;
+}
 
-    scene->bounds.x = minX - paddingX;
-    scene->bounds.y = minY - (2*paddingY);
-    scene->bounds.width = (maxX - minX) + 2 * paddingX;
-    scene->bounds.height = (maxY - minY) + 2 * paddingY;
+// Profiler overlay (F3) on the left: phase averages, a histogram of the recent frame times and
+// the counts of the last frame
+void DrawProfilerOverlay(const Context *context, const ScreenSettings *screen) {
+    int menuBarHeight = CLAMP(screen->height / 18, 40, 70);
+    float width = 300.0f, padding = 10.0f, fontSize = 12.0f, lineHeight = fontSize + 4.0f;
+    float histogramHeight = 60.0f;
+    int counts[16] = {0}, buckets = 16;
+    float bucketMillis = 2.0f;      // the last bucket takes everything slower
+
+    Rectangle panel = { padding, menuBarHeight + padding, width,
+                        2 * padding + (PROFILE_ZONE_COUNT + 4) * lineHeight + histogramHeight + padding };
+    DrawRectangleRec(panel, Fade(RAYWHITE, 0.92f));
+    DrawRectangleLinesEx(panel, 1, DARKGRAY);
+
+    char label[96];
+    float x = panel.x + padding, y = panel.y + padding;
+    float barLeft = x + 150, barWidth = width - 150 - 2 * padding;
+
+    // phases, the bar spans one 60 fps frame
+    double total = 0;
+    for (int zone = 0; zone < PROFILE_ZONE_COUNT; zone++) {
+        double millis = profiler.zoneAverage[zone] * 1000.0;
+        total += millis;
+        snprintf(label, sizeof(label), "%-16s %6.3f", Profiler_ZoneName(zone), millis);
+        DrawTextEx(globalFont, label, (Vector2){ x, y }, fontSize, 1, DARKGRAY);
+        float bar = fminf(1.0f, (float)(millis / 16.667)) * barWidth;
+        DrawRectangleRec((Rectangle){ barLeft, y + 3, bar, fontSize - 4 }, millis > 4.0 ? MAROON : DARKGREEN);
+        y += lineHeight;
+    }
+    snprintf(label, sizeof(label), "phases %.3f ms", total);
+    DrawTextEx(globalFont, label, (Vector2){ x, y }, fontSize, 1, BLACK);
+    y += lineHeight;
+
+    // frame times, 2 ms a bucket
+    int tallest = 1;
+    float worst = 0;
+    for (int i = 0; i < profiler.frameCount; i++) {
+        float millis = profiler.frameMillis[i];
+        int bucket = (int)(millis / bucketMillis);
+        if (bucket >= buckets) bucket = buckets - 1;
+        if (++counts[bucket] > tallest) tallest = counts[bucket];
+        if (millis > worst) worst = millis;
+    }
+    float bucketWidth = (width - 2 * padding) / buckets;
+    for (int b = 0; b < buckets; b++) {
+        float height = histogramHeight * counts[b] / tallest;
+        Color color = b * bucketMillis >= 16.0f ? MAROON : b * bucketMillis >= 8.0f ? ORANGE : DARKGREEN;
+        DrawRectangleRec((Rectangle){ x + b * bucketWidth, y + histogramHeight - height, bucketWidth - 1, height }, color);
+    }
+    DrawLine((int)x, (int)(y + histogramHeight), (int)(x + width - 2 * padding), (int)(y + histogramHeight), DARKGRAY);
+    y += histogramHeight + 2;
+    snprintf(label, sizeof(label), "last %d frames, 0-%.0f ms, worst %.2f ms", profiler.frameCount, buckets * bucketMillis, worst);
+    DrawTextEx(globalFont, label, (Vector2){ x, y }, fontSize, 1, DARKGRAY);
+    y += lineHeight;
+
+    snprintf(label, sizeof(label), "nodes %d  edges %d  scenes %d", context->pool->liveCount,
+             context->edges.count, context->sceneList.count);
+    DrawTextEx(globalFont, label, (Vector2){ x, y }, fontSize, 1, DARKGRAY);
+    y += lineHeight;
+    snprintf(label, sizeof(label), "hit tests %u  draw calls %u", profiler.lastCounters[PROFILE_COUNTER_HIT_TESTS],
+             profiler.lastCounters[PROFILE_COUNTER_DRAW_CALLS]);
+    DrawTextEx(globalFont, label, (Vector2){ x, y }, fontSize, 1, DARKGRAY);
 }
 
 // DECORATORS
@@ -607,6 +599,7 @@ void DrawNodeExpandIcon(Node *node, float size) {
     int icon = node->isExpanded ? ICON_ARROW_UP_FILL : ICON_ARROW_DOWN_FILL;
     
     GuiDrawIcon(icon, (int)iconBounds.x, (int)iconBounds.y, 1, WHITE);
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 2);
 }
 
 // Draw cog Icon
@@ -622,6 +615,7 @@ void DrawNodeCogIcon(Node *node, float size) {
 
     DrawRectangleRec(iconBounds, ORANGE);
     GuiDrawIcon(ICON_GEAR, (int)iconBounds.x, (int)iconBounds.y, 1, WHITE);
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 2);
 }
 
 // Draw X icon
@@ -639,34 +633,5 @@ void DrawNodeDeleteIcon(Node *node, float size) {
 
     // Draw the raygui icon centered
     GuiDrawIcon(ICON_CROSS_SMALL, (int)iconBounds.x, (int)iconBounds.y, 1, WHITE);
-}
-
-//INIT FUNCTIONS
-void CreateInitialScene(Context *context) {
-    if (context->sceneList.count < MAX_SCENES) {
-        SceneOutline scene = {
-            .bounds = (Rectangle){ 150, 150, 300, 200 }
-        };
-        strncpy(scene.name, "Intro", sizeof(scene.name));
-        context->sceneList.scenes[context->sceneList.count++] = scene;
-    }
-}
-
-//HELPER FUNCTIONS
-// Helper function, give it the enum type (which defaults to an int) and get the string
-const char* GetNodeTypeName(int type) {
-    static const char* names[] = {
-        "Dialogue Node", "Stack Node", "Random Node", "Random Bag",
-        "User Choice", "Skill Gate", "Go To", "If/Else"
-    };
-    return (type >= 0 && type < NODE_COUNT) ? names[type] : "Unknown";
-}
-
-// RandomID
-void GenerateRandomID(char *buffer, int length) {
-    const char charset[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
-    for (int i = 0; i < length; i++) {
-        buffer[i] = charset[GetRandomValue(0, (int)(sizeof(charset) - 2))];
-    }
-    buffer[length] = '\0';
+    PROFILE_COUNT(PROFILE_COUNTER_DRAW_CALLS, 2);
 }
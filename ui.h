@@ -5,29 +5,25 @@
 #include <stdbool.h>
 
 //CORE DRAW FUNCTIONS
-void DrawMenuBar(ScreenSettings *screen);
-void DrawBackground(const ScreenSettings *screen);
-void DrawAllNodes(Node *head, Context *context);
-void DrawSingleNode(Node *node);
-void DrawLiveBezier(Context *context);
+MenuAction DrawMenuBar(ScreenSettings *screen, const FrameInput *input);
+void DrawBackground(const ScreenSettings *screen, Camera2D camera);
+void UnloadBackground(void);
+void DrawAllNodes(Context *context);
+void DrawSingleNode(Node *node, Context *context);
+void DrawLiveBezier(const Context *context);
 void DrawPermanentConnections(Context *context);
 void DrawPermanentConnectionsForNode(Node *node, Context *context);
-void DrawTopNodeAndConnections(Node *head, Context *context);
+void DrawTopNodeAndConnections(Context *context);
 void DrawSceneOutlines(Context *context);
-
-// DRAW HELPER FUNCTIONS
-void ShrinkSceneToFitContent(SceneOutline *scene);
+void DrawSceneIcons(const SceneOutline *scene, const Context *context);
+void DrawRenderStats(const Context *context, const ScreenSettings *screen);
+void DrawPlaytestHighlight(const Context *context);
+int DrawPlaytestPanel(const Context *context, const ScreenSettings *screen);
+void DrawProfilerOverlay(const Context *context, const ScreenSettings *screen);
 
 // NODE DRAW DECORATORS
 void DrawNodeExpandIcon(Node *node, float size);
 void DrawNodeCogIcon(Node *node, float size);
 void DrawNodeDeleteIcon(Node *node, float size);
 
-// INIT FUNCTIONS
-void CreateInitialScene(Context *context);
-
-// HELPER FUNCTIONS
-const char* GetNodeTypeName(int type); //feed it an enum and get the string 
-void GenerateRandomID(char *buffer, int length);
-
 #endif 
\ No newline at end of file